@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <sys/resource.h>
+#include "nvilidar_process.h"
+
+using namespace std;
+using namespace nvilidar;
+
+//latency from the zero angle package sent(nvilidar_sim.py --log0c) to the circle ready(LidarScan::latency.decode_us),
+//both are CLOCK_MONOTONIC us,the simulator runs on the same host.
+//nvilidar_latency_bench serial|udp block|busy|epoll|uring seconds zero_log [-p port|ip] [-b backoff_us] [-t vmin/vtime]
+
+//user+system cpu time of this process
+static uint64_t cpuUS()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (uint64_t)usage.ru_utime.tv_sec * 1000000ULL + usage.ru_utime.tv_usec +
+		(uint64_t)usage.ru_stime.tv_sec * 1000000ULL + usage.ru_stime.tv_usec;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+	{
+		printf("usage: %s serial|udp block|busy|epoll|uring seconds zero_log [-p port|ip] [-b backoff_us] [-t vmin/vtime]\n", argv[0]);
+		return 1;
+	}
+	bool udp = (0 == strcmp(argv[1], "udp"));
+	std::string mode = argv[2];
+	int secs = atoi(argv[3]);
+	const char *zero_log = argv[4];
+	std::string port = udp ? "10.9.0.2" : "/tmp/ttyLidar";
+	int backoff_us = 0;
+	const char *tune = NULL;			//serial vmin/vtime,low latency flag on 
+	for (int i = 5; i + 1 < argc; i += 2)
+	{
+		if (0 == strcmp(argv[i], "-p"))
+		{
+			port = argv[i + 1];
+		}
+		else if (0 == strcmp(argv[i], "-b"))
+		{
+			backoff_us = atoi(argv[i + 1]);
+		}
+		else if (0 == strcmp(argv[i], "-t"))
+		{
+			tune = argv[i + 1];
+		}
+	}
+	bool use_hub = ((mode == "epoll") || (mode == "uring"));
+
+	LidarHub hub;
+	if (use_hub)
+	{
+		hub.Start(NVILIDAR_HUB_TICK_MS, (mode == "uring") ? NVILIDAR_HUB_URING : NVILIDAR_HUB_EPOLL);
+	}
+
+	LidarProcess lidar(udp ? USE_SOCKET : USE_SERIALPORT, port, udp ? 8100 : 921600);
+	LidarThreadPara para = {};
+	if (mode == "busy")
+	{
+		para.read_mode = NVILIDAR_READ_BUSY_POLL;
+		para.backoff_us = backoff_us;
+	}
+	lidar.LidarSetThreadPara(para);
+	if ((!udp) && (tune != NULL))
+	{
+		nvilidar_serial::SerialTuning tuning = {true, 0, 0, 0, -1};
+		unsigned int vmin = 0;
+		unsigned int vtime = 0;
+		sscanf(tune, "%u/%u", &vmin, &vtime);
+		tuning.vmin = (uint8_t)vmin;
+		tuning.vtime = (uint8_t)vtime;
+		lidar.LidarSetSerialTuning(tuning);
+	}
+	if (use_hub)
+	{
+		lidar.LidarSetHub(&hub);
+	}
+	if ((!lidar.LidarInitialialize()) || (!lidar.LidarTurnOn()))
+	{
+		printf("lidar init fail\n");
+		return 1;
+	}
+
+	//skip the first second,speed up of the simulator
+	std::vector<uint64_t> ready_us;
+	std::vector<int> ready_ids;
+	delayMS(1000);
+	uint64_t start_ms = getMS();
+	uint64_t cpu_start = cpuUS();
+	uint64_t wall_start = getUS();
+	while (getMS() - start_ms < (uint64_t)secs * 1000)
+	{
+		LidarScan scan;
+		if (use_hub)
+		{
+			if ((!hub.Wait(ready_ids, 200)) || (!lidar.LidarSamplingProcess(scan, NVILIDAR_POINT_TIMEOUT_NONE)))
+			{
+				continue;
+			}
+		}
+		else if (!lidar.LidarSamplingProcess(scan))
+		{
+			continue;
+		}
+		ready_us.push_back(scan.latency.decode_us);
+	}
+	double cpu = 100.0 * (cpuUS() - cpu_start) / (getUS() - wall_start);
+	lidar.LidarTurnOff();
+	lidar.LidarCloseHandle();
+
+	//the zero angle package before every circle
+	std::vector<uint64_t> sent_us;
+	FILE *fp = fopen(zero_log, "r");
+	if (NULL == fp)
+	{
+		printf("no %s\n", zero_log);
+		return 1;
+	}
+	unsigned long long stamp = 0;
+	while (fscanf(fp, "%llu", &stamp) == 1)
+	{
+		sent_us.push_back(stamp);
+	}
+	fclose(fp);
+
+	std::vector<double> latency;
+	for (size_t i = 0; i < ready_us.size(); i++)
+	{
+		std::vector<uint64_t>::iterator it = std::upper_bound(sent_us.begin(), sent_us.end(), ready_us[i]);
+		if (it != sent_us.begin())
+		{
+			latency.push_back((double)(ready_us[i] - *(it - 1)));
+		}
+	}
+	if (latency.empty())
+	{
+		printf("no circle\n");
+		return 1;
+	}
+	std::sort(latency.begin(), latency.end());
+	size_t n = latency.size();
+
+	printf("%-6s %-6s circles=%zu p50=%.0fus p99=%.0fus max=%.0fus cpu=%.1f%%\n", argv[1], mode.c_str(), n,
+		latency[n / 2], latency[std::min(n - 1, n * 99 / 100)], latency[n - 1], cpu);
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+# nvilidar simulator for the benchmarks,answers the config commands and streams the point packages
+# serial: a pty linked to --link,udp: datagrams to --udp host:port(run it in a network namespace)
+import os, pty, sys, time, struct, select, tty, argparse, random, socket
+
+ap = argparse.ArgumentParser(description='nvilidar simulator on a pty or udp')
+ap.add_argument('--link', default='/tmp/ttyLidar', help='symlink to the pty')
+ap.add_argument('--hz', type=float, default=10.0, help='circles per second')
+ap.add_argument('--rate', type=int, default=10000, help='points per second')
+ap.add_argument('--pts', type=int, default=32, help='points per package')
+ap.add_argument('--sens', type=int, default=0, help='1:intensity in the packages')
+ap.add_argument('--corrupt', type=float, default=0.0, help='chance of a bad checksum')
+ap.add_argument('--trunc', type=float, default=0.0, help='chance of a package with lost bytes')
+ap.add_argument('--drop0c', type=float, default=0.0, help='chance of losing the zero angle package')
+ap.add_argument('--stall-after', type=float, default=0, help='stop streaming after N s')
+ap.add_argument('--stall-for', type=float, default=0, help='for N s')
+ap.add_argument('--udp', default='', help='host:port to stream to instead of the pty')
+ap.add_argument('--udp-bind', type=int, default=0, help='local udp port(the lidar port)')
+ap.add_argument('--model', default='R300 ', help='product name of the device info')
+ap.add_argument('--log0c', default='', help='file,CLOCK_MONOTONIC us of every zero angle package sent')
+args = ap.parse_args()
+
+cfg = dict(apd=500, rate=args.rate, aim=int(args.hz * 100), tail=20, sens=args.sens, off=0, qual=800)
+
+def resp(cmd, data):
+    crc = 0
+    for b in data:
+        crc ^= b
+    return bytes([0x40, cmd, len(data) & 0xff, len(data) >> 8]) + data + bytes([crc, 0xff])
+
+# config commands,the set commands are kept and read back
+def handle(cmd, payload):
+    print('cmd %02X' % cmd, flush=True)
+    if cmd == 0xB2:
+        d = bytes([1, 13, 2, 0]) + args.model.encode()[:5].ljust(5) + bytes(range(16))
+        return resp(cmd, d)
+    if cmd == 0xDA:
+        return resp(cmd, struct.pack('<HIHBB', cfg['apd'], cfg['rate'], cfg['aim'], cfg['tail'], cfg['sens']))
+    if cmd == 0xC5: return resp(cmd, struct.pack('<h', cfg['off']))
+    if cmd == 0x19: return resp(cmd, struct.pack('<H', cfg['qual']))
+    if cmd == 0x27: cfg['aim'] = struct.unpack('<H', payload)[0]; return resp(cmd, payload)
+    if cmd == 0xCA: cfg['rate'] = struct.unpack('<I', payload)[0]; return resp(cmd, payload)
+    if cmd == 0xCB: cfg['tail'] = payload[0]; return resp(cmd, payload)
+    if cmd == 0x29: cfg['apd'] = struct.unpack('<H', payload)[0]; return resp(cmd, payload)
+    if cmd == 0xC4: cfg['off'] = struct.unpack('<h', payload)[0]; return resp(cmd, payload)
+    if cmd == 0x15: cfg['qual'] = struct.unpack('<H', payload)[0]; return resp(cmd, payload)
+    if cmd == 0x50: cfg['sens'] = 1; return resp(cmd, b'\x01')
+    if cmd == 0x51: cfg['sens'] = 0; return resp(cmd, b'\x00')
+    if cmd == 0xD6: return resp(cmd, b'\x01')
+    return b''
+
+# point package:head,speed/temperature,count/zero index,first angle,last angle,checksum,samples
+def package(first, last, n, zero_idx, temp_pkt, dists):
+    if zero_idx is not None:
+        w1 = ((cfg['aim'] << 1) | 1 | 0x8000) & 0xffff
+        w2 = n | ((zero_idx + 1) << 8)
+    elif temp_pkt:
+        w1 = 345 & 0xffff
+        w2 = n
+    else:
+        w1 = 0
+        w2 = n
+    fa = ((first << 1) | 1) & 0xffff
+    la = ((last << 1) | 1) & 0xffff
+    cs = 0x55AA ^ w1 ^ w2 ^ fa ^ la
+    body = b''
+    for i, d in enumerate(dists):
+        if cfg['sens']:
+            q = 100 + i
+            cs ^= q
+            cs ^= d
+            body += struct.pack('<HH', q, d)
+        else:
+            cs ^= d
+            body += struct.pack('<H', d)
+    return struct.pack('<HHHHHH', 0x55AA, w1, w2, fa, la, cs) + body
+
+def main(log0c):
+    if args.udp:
+        host, port = args.udp.split(':')
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        if args.udp_bind:
+            sock.bind(('', args.udp_bind))
+        dest = (host, int(port))
+        out = lambda b: sock.sendto(b, dest)
+        rfd = sock.fileno()
+        readin = lambda: sock.recv(4096)
+    else:
+        m, s = pty.openpty()
+        tty.setraw(s)
+        name = os.ttyname(s)
+        try:
+            os.unlink(args.link)
+        except FileNotFoundError:
+            pass
+        os.symlink(name, args.link)
+        print('pty', name, '->', args.link, flush=True)
+        out = lambda b: os.write(m, b)
+        rfd = m
+        readin = lambda: os.read(m, 4096)
+
+    scanning = args.udp != ''            # the network lidar streams from the power on
+    buf = b''
+    pts_per_rev = int(cfg['rate'] / args.hz)
+    pkt_period = args.pts / cfg['rate']
+    nxt = time.time()
+    start = time.time()
+    after0 = 0
+    idx_in_rev = 0
+    while True:
+        r, _, _ = select.select([rfd], [], [], max(0, nxt - time.time()))
+        if r:
+            try:
+                buf += readin()
+            except OSError:
+                time.sleep(0.01)
+                continue
+            while buf:
+                if buf[0] == 0xFE and len(buf) >= 2:
+                    c = buf[1]
+                    buf = buf[2:]
+                    if c == 0x60:
+                        scanning = True
+                        after0 = 0
+                        print('start', flush=True)
+                    elif c == 0x65:
+                        scanning = False
+                        print('stop', flush=True)
+                    else:
+                        out(handle(c, b''))
+                elif buf[0] == 0x40 and len(buf) >= 4:
+                    ln = buf[2] | (buf[3] << 8)
+                    if len(buf) < 6 + ln:
+                        break
+                    c = buf[1]
+                    p = buf[4:4 + ln]
+                    buf = buf[6 + ln:]
+                    out(handle(c, p))
+                elif buf[0] in (0xFE, 0x40):
+                    break
+                else:
+                    buf = buf[1:]
+
+        now = time.time()
+        if now < nxt:
+            continue
+        nxt += pkt_period
+        if nxt < now - 1:
+            nxt = now
+        if not scanning:
+            continue
+        el = now - start
+        if args.stall_after and args.stall_after < el < args.stall_after + args.stall_for:
+            continue
+
+        n = args.pts
+        step = 360 * 64 / pts_per_rev
+        first_i = idx_in_rev
+        zero_idx = None
+        angles = []
+        for k in range(n):
+            i = (first_i + k) % pts_per_rev
+            if i == 0:
+                zero_idx = k
+            angles.append(int(i * step) % (360 * 64))
+        idx_in_rev = (first_i + n) % pts_per_rev
+        temp_pkt = (after0 == 1)
+        if zero_idx is not None:
+            after0 = 0
+        after0 += 1
+        dists = [1000 + ((first_i + k) % pts_per_rev) for k in range(n)]
+        p = package(angles[0], angles[-1], n, zero_idx, temp_pkt, dists)
+        if zero_idx is not None and random.random() < args.drop0c:
+            continue
+        if random.random() < args.corrupt:
+            p = bytearray(p)
+            p[random.randrange(12, len(p))] ^= 0x5A
+            p = bytes(p)
+        if random.random() < args.trunc:
+            p = p[:random.randrange(2, len(p))]
+        t_send = time.monotonic_ns() // 1000
+        out(p)
+        if zero_idx is not None and log0c:
+            log0c.write('%d\n' % t_send)
+            log0c.flush()
+
+main(open(args.log0c, 'w') if args.log0c else None)
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <sys/resource.h>
+#include "serial/nvilidar_serial.h"
+#include "mytimer.h"
+
+using namespace std;
+using namespace nvilidar_serial;
+
+//raw reads of the serialport with a SerialTuning,bytes per read and the gap between the reads(jitter),
+//no unpack.the lidar(or nvilidar_sim.py) is started by the scan command and stopped at the end.
+//nvilidar_serial_chunk port low_latency vmin vtime seconds
+
+//user+system cpu time of this process
+static uint64_t cpuUS()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (uint64_t)usage.ru_utime.tv_sec * 1000000ULL + usage.ru_utime.tv_usec +
+		(uint64_t)usage.ru_stime.tv_sec * 1000000ULL + usage.ru_stime.tv_usec;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 6)
+	{
+		printf("usage: %s port low_latency(0/1) vmin vtime seconds\n", argv[0]);
+		return 1;
+	}
+	SerialTuning tuning = {atoi(argv[2]) != 0, (uint8_t)atoi(argv[3]), (uint8_t)atoi(argv[4]), 0, -1};
+	int secs = atoi(argv[5]);
+
+	Nvilidar_Serial serial;
+	serial.serialInit(argv[1], 921600);
+	serial.serialSetTuning(tuning);
+	if (!serial.serialOpen())
+	{
+		printf("open %s fail\n", argv[1]);
+		return 1;
+	}
+	SerialTuning real = serial.serialGetTuning();
+	bool read_waits = (real.vmin > 0) || (real.vtime > 0);		//the driver does not sleep after a read then
+
+	uint8_t scan_cmd[2] = {0xFE, 0x60};
+	serial.serialWriteData(scan_cmd, 2);
+
+	std::vector<int> chunk;
+	std::vector<double> gap;
+	uint8_t buf[8192];
+	uint64_t start_us = getUS();
+	uint64_t last_us = 0;
+	uint64_t cpu_start = cpuUS();
+	size_t reads = 0;
+	while (getUS() - start_us < (uint64_t)secs * 1000000)
+	{
+		int len = serial.serialReadData(buf, sizeof(buf));
+		reads++;
+		if (len > 0)
+		{
+			uint64_t now_us = getUS();
+			if (last_us != 0)
+			{
+				gap.push_back((double)(now_us - last_us));
+			}
+			last_us = now_us;
+			chunk.push_back(len);
+		}
+		if ((!read_waits) || (len <= 0))
+		{
+			delayMS(1);
+		}
+	}
+	double cpu = 100.0 * (cpuUS() - cpu_start) / (getUS() - start_us);
+
+	uint8_t stop_cmd[2] = {0xFE, 0x65};
+	serial.serialWriteData(stop_cmd, 2);
+	serial.serialClose();
+	if (gap.empty())
+	{
+		printf("no data\n");
+		return 1;
+	}
+
+	double mean = 0;
+	double sd = 0;
+	for (size_t i = 0; i < gap.size(); i++)
+	{
+		mean += gap[i];
+	}
+	mean /= gap.size();
+	for (size_t i = 0; i < gap.size(); i++)
+	{
+		sd += (gap[i] - mean) * (gap[i] - mean);
+	}
+	sd = sqrt(sd / gap.size());
+	std::sort(chunk.begin(), chunk.end());
+	std::sort(gap.begin(), gap.end());
+	size_t n = gap.size();
+
+	printf("low_latency=%d vmin=%d vtime=%d timer=%dms reads/s=%.0f bytes/read p50=%d max=%d "
+		"gap mean=%.0fus sd=%.0fus p99=%.0fus cpu=%.1f%%\n",
+		real.low_latency, real.vmin, real.vtime, real.latency_timer_ms, (double)reads / secs,
+		chunk[chunk.size() / 2], chunk.back(), mean, sd, gap[std::min(n - 1, n * 99 / 100)], cpu);
+
+	return 0;
+}
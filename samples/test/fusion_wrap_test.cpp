@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "nvilidar_process.h"
+#include "nvilidar_fusion.h"
+
+using namespace nvilidar;
+
+//fused stamp of scans closed at angle wrap(zero angle package lost),a lidar on a pty(linux).
+//the lidar sends the zero angle package for the first second only,then every circle is closed at angle wrap.
+//nvilidar_fusion_wrap_test,exit 0:pass
+
+#define TEST_RATE			10000		//points per second
+#define TEST_HZ				10			//circles per second
+#define TEST_PACK_POINTS	32			//points per package
+#define TEST_ZERO_MS		1000		//zero angle package sent before this
+#define TEST_RUN_MS			3000		//fused scans checked after the zero angle packages are gone
+
+static std::atomic<bool> lidar_running(true);
+static std::atomic<bool> lidar_scanning(false);
+
+//answer of a config command:0x40,cmd,length,data,xor,0xff
+static void LidarAnswer(int fd, uint8_t cmd, const uint8_t *data, uint16_t len)
+{
+	std::vector<uint8_t> out;
+	uint8_t crc = 0;
+
+	out.push_back(0x40);
+	out.push_back(cmd);
+	out.push_back(len & 0xFF);
+	out.push_back(len >> 8);
+	for (uint16_t i = 0; i < len; i++)
+	{
+		out.push_back(data[i]);
+		crc ^= data[i];
+	}
+	out.push_back(crc);
+	out.push_back(0xFF);
+	if (write(fd, out.data(), out.size()) < 0)
+	{
+		return;
+	}
+}
+
+//config commands,the set commands are answered with the payload
+static void LidarCommand(int fd, uint8_t cmd, const uint8_t *payload, uint16_t len)
+{
+	uint8_t data[32];
+
+	memset(data, 0, sizeof(data));
+	switch (cmd)
+	{
+		case 0xB2:			//device info
+		{
+			uint8_t info[25] = {1, 13, 2, 0, 'R', '3', '0', '0', ' '};
+			for (int i = 0; i < 16; i++)
+			{
+				info[9 + i] = (uint8_t)i;
+			}
+			LidarAnswer(fd, cmd, info, sizeof(info));
+			break;
+		}
+		case 0xDA:			//apd,sampling rate,aim speed,tail filter,no intensity
+		{
+			uint16_t apd = 500;
+			uint32_t rate = TEST_RATE;
+			uint16_t aim = TEST_HZ * 100;
+			memcpy(data, &apd, 2);
+			memcpy(data + 2, &rate, 4);
+			memcpy(data + 6, &aim, 2);
+			data[8] = 20;
+			data[9] = 0;
+			LidarAnswer(fd, cmd, data, 10);
+			break;
+		}
+		case 0xC5:			//angle offset
+		{
+			LidarAnswer(fd, cmd, data, 2);
+			break;
+		}
+		case 0x19:			//quality filter
+		{
+			uint16_t quality = 800;
+			memcpy(data, &quality, 2);
+			LidarAnswer(fd, cmd, data, 2);
+			break;
+		}
+		case 0x27:
+		case 0xCA:
+		case 0xCB:
+		case 0x29:
+		case 0xC4:
+		case 0x15:
+		{
+			LidarAnswer(fd, cmd, payload, len);
+			break;
+		}
+		case 0x50:
+		case 0xD6:
+		{
+			data[0] = 1;
+			LidarAnswer(fd, cmd, data, 1);
+			break;
+		}
+		case 0x51:
+		{
+			LidarAnswer(fd, cmd, data, 1);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+//point package:head,speed,count/zero index,first angle,last angle,checksum,distances
+static void LidarPackage(int fd, uint32_t first_index, uint32_t points_per_circle, bool send_zero)
+{
+	uint16_t words[6 + TEST_PACK_POINTS];
+	int zero_index = -1;
+	uint16_t angle[TEST_PACK_POINTS];
+
+	for (int k = 0; k < TEST_PACK_POINTS; k++)
+	{
+		uint32_t i = (first_index + k) % points_per_circle;
+		if (0 == i)
+		{
+			zero_index = k;
+		}
+		angle[k] = (uint16_t)((i * 360 * 64 / points_per_circle) % (360 * 64));
+		words[6 + k] = (uint16_t)(1000 + i);
+	}
+	if ((zero_index >= 0) && (!send_zero))
+	{
+		return;
+	}
+
+	words[0] = 0x55AA;
+	words[1] = (zero_index >= 0) ? (uint16_t)(((TEST_HZ * 100) << 1) | 1 | 0x8000) : 0;
+	words[2] = (uint16_t)(TEST_PACK_POINTS | ((zero_index >= 0) ? ((zero_index + 1) << 8) : 0));
+	words[3] = (uint16_t)((angle[0] << 1) | 1);
+	words[4] = (uint16_t)((angle[TEST_PACK_POINTS - 1] << 1) | 1);
+	words[5] = 0x55AA ^ words[1] ^ words[2] ^ words[3] ^ words[4];
+	for (int k = 0; k < TEST_PACK_POINTS; k++)
+	{
+		words[5] ^= words[6 + k];
+	}
+	if (write(fd, words, sizeof(words)) < 0)
+	{
+		return;
+	}
+}
+
+//lidar on the master side of the pty
+static void LidarThread(int fd)
+{
+	std::vector<uint8_t> buf;
+	uint32_t points_per_circle = TEST_RATE / TEST_HZ;
+	uint64_t period_us = 1000000ULL * TEST_PACK_POINTS / TEST_RATE;
+	uint64_t next_us = getUS();
+	uint64_t scan_start_ms = 0;
+	uint32_t index = 0;
+
+	while (lidar_running)
+	{
+		uint64_t now_us = getUS();
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, (next_us > now_us) ? (int)((next_us - now_us) / 1000) : 0) > 0)
+		{
+			uint8_t data[256];
+			ssize_t len = read(fd, data, sizeof(data));
+			if (len > 0)
+			{
+				buf.insert(buf.end(), data, data + len);
+			}
+		}
+		//0xFE cmd,or 0x40 cmd length payload crc 0xFF
+		while (!buf.empty())
+		{
+			if ((0xFE == buf[0]) && (buf.size() >= 2))
+			{
+				uint8_t cmd = buf[1];
+				buf.erase(buf.begin(), buf.begin() + 2);
+				if (0x60 == cmd)
+				{
+					lidar_scanning = true;
+					scan_start_ms = getMS();
+				}
+				else if (0x65 == cmd)
+				{
+					lidar_scanning = false;
+				}
+				else
+				{
+					LidarCommand(fd, cmd, NULL, 0);
+				}
+			}
+			else if ((0x40 == buf[0]) && (buf.size() >= 4))
+			{
+				uint16_t len = buf[2] | (buf[3] << 8);
+				if (buf.size() < (size_t)(6 + len))
+				{
+					break;
+				}
+				std::vector<uint8_t> payload(buf.begin() + 4, buf.begin() + 4 + len);
+				LidarCommand(fd, buf[1], payload.data(), len);
+				buf.erase(buf.begin(), buf.begin() + 6 + len);
+			}
+			else if ((0xFE == buf[0]) || (0x40 == buf[0]))
+			{
+				break;
+			}
+			else
+			{
+				buf.erase(buf.begin());
+			}
+		}
+
+		if (getUS() < next_us)
+		{
+			continue;
+		}
+		next_us += period_us;
+		if (lidar_scanning)
+		{
+			LidarPackage(fd, index, points_per_circle, (getMS() - scan_start_ms) < TEST_ZERO_MS);
+			index = (index + TEST_PACK_POINTS) % points_per_circle;
+		}
+	}
+}
+
+int main(void)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0))
+	{
+		printf("no pty\n");
+		return 1;
+	}
+	std::string port = ptsname(master);
+	struct termios tio;
+	tcgetattr(master, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(master, TCSANOW, &tio);
+	std::thread lidar_thread(LidarThread, master);
+
+	int ret = 1;
+	LidarProcess lidar(USE_SERIALPORT, port, 921600);
+	LidarFusion fusion;
+	LidarExtrinsic extrinsic = {0.0f, 0.0f, 0.0f};
+	if (lidar.LidarInitialialize() && lidar.LidarTurnOn() && fusion.Init() && (fusion.AddSource(&lidar, extrinsic) >= 0))
+	{
+		//wait for the zero angle packages to stop
+		delayMS(TEST_ZERO_MS + 500);
+		uint64_t wrap_start = lidar.LidarGetStats().counters[NVILIDAR_METRIC_ZERO_LOST];
+		uint64_t start_ms = getMS();
+		uint64_t last_stamp = 0;
+		int scans = 0;
+		int bad = 0;
+		while (getMS() - start_ms < TEST_RUN_MS)
+		{
+			LidarScan scan;
+			if ((!fusion.Merge(scan)) || (scan.stamp == last_stamp))
+			{
+				delayMS(5);
+				continue;
+			}
+			//close to the host clock,a circle after the last one
+			uint64_t now = getStamp();
+			bool stamp_ok = (scan.stamp + 1000000000ULL > now) && (scan.stamp < now + 100000000ULL);
+			bool step_ok = (last_stamp == 0) || ((scan.stamp > last_stamp) && (scan.stamp - last_stamp < 500000000ULL));
+			if ((!stamp_ok) || (!step_ok) || (fusion.GetStats().points_old > 0))
+			{
+				printf("bad fused scan:stamp %llu last %llu now %llu old points %u\n", (unsigned long long)scan.stamp,
+					(unsigned long long)last_stamp, (unsigned long long)now, fusion.GetStats().points_old);
+				bad++;
+			}
+			last_stamp = scan.stamp;
+			scans++;
+		}
+		uint64_t wraps = lidar.LidarGetStats().counters[NVILIDAR_METRIC_ZERO_LOST] - wrap_start;
+
+		printf("fused scans %d,closed at angle wrap %llu,bad %d\n", scans, (unsigned long long)wraps, bad);
+		ret = ((bad == 0) && (scans >= TEST_RUN_MS / 1000 * TEST_HZ / 2) && (wraps + 1 >= (uint64_t)scans)) ? 0 : 1;		//the first one may be taken before
+	}
+	else
+	{
+		printf("lidar init fail\n");
+	}
+	lidar.LidarTurnOff();
+	lidar.LidarCloseHandle();
+
+	lidar_running = false;
+	lidar_thread.join();
+	close(master);
+
+	return ret;
+}
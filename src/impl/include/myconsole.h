@@ -1,138 +1,154 @@
-
-#ifndef _MYCONSOLE_H_
-#define _MYCONSOLE_H_
-
-#include <iostream>
-#include <stdarg.h>
-#include <stdio.h>
-#include <string>
-#include <fstream>
-#include <string.h>
-#include <stdlib.h>
-
-#if defined(_WIN32)
-	#include <WinSock2.h>
-    #include <windows.h>
-    #include <iostream>
-    #if defined(_MSC_VER)
-        #include <corecrt_io.h>
-    #else
-        #include <unistd.h>
-    #endif
-#else 
-    #include <unistd.h>
-#endif
-
-
-using namespace std;
-
-namespace nvilidar
-{
-
-#define COLOR_NONE "\033[m"
-#define COLOR_RED "\033[1;31m"
-#define COLOR_GREEN "\033[1;32m"
-#define COLOR_YELLOW "\033[1;33m"
-#define COLOR_CYAN "\033[1;36m"
-
-#define DEBUG_FLAG_FILE "/tmp/nvilidar-debug-flag"
-
-class Console
-{
-public:
-    Console ()
-    {
-    }
-    ~Console (void) {}
-public:
-    void
-    show(const char* message_, ...)
-    {
-        char out[1024] = { 0 };
-        va_list args;
-        va_start(args, message_);
-        vsnprintf (out, sizeof(out), message_, args);
-        va_end(args);
-#if defined (_WIN32)
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x02);
-       printf ("%s\r\n", out);
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x07);
-#else
-        printf (COLOR_GREEN);
-        printf ("%s\n", out);
-        printf (COLOR_NONE);
-#endif
-    }
-    void
-    message (const char* message_, ...)
-    {
-        char out[1024] = { 0 };
-        va_list args;
-        va_start(args, message_);
-        vsnprintf (out, sizeof(out), message_, args);
-        va_end(args);
-#if defined (_WIN32)
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x02);
-       printf ("[NVILidar]: ");
-       printf ("%s\r\n", out);
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x07);
-#else
-        printf (COLOR_GREEN);
-        printf ("[NVILidar]: ");
-        printf ("%s\n", out);
-        printf (COLOR_NONE);
-#endif
-    }
-    ;
-
-    void
-    warning (const char* warning_, ...)
-    {
-        char out[1024] = { 0 };
-        va_list args;
-        va_start(args, warning_);
-        vsnprintf (out, sizeof(out), warning_, args);
-        va_end(args);
-#if defined (_WIN32)
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x06);
-       printf ("Warning: ");;
-       printf ("%s\r\n", out);
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x07);
-#else
-        printf (COLOR_YELLOW);
-        printf ("Warning: ");
-        printf ("%s\n", out);
-        printf (COLOR_NONE);
-#endif
-    }
-    ;
-
-    void
-    error (const char* error_, ...)
-    {
-        char out[1024] = { 0 };
-        va_list args;
-        va_start(args, error_);
-        vsnprintf (out, sizeof(out), error_, args);
-        va_end(args);
-#if defined (_WIN32)
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x04);
-       printf ("Error: ");
-       printf ("%s", out);
-       printf ("\r\n");
-       SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x07);
-#else
-        printf (COLOR_RED);
-        printf ("Error: ");
-        printf ("%s\n", out);
-        printf (COLOR_NONE);
-#endif
-    }
-    ;
-};
-
-static Console console;
-
-};
-
-#endif /* _CONSOLE_H_ */
+
+#ifndef _MYCONSOLE_H_
+#define _MYCONSOLE_H_
+
+#include <iostream>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string>
+#include <fstream>
+#include <string.h>
+#include <stdlib.h>
+#include "nvilidar_log.h"
+
+#if defined(_WIN32)
+	#include <WinSock2.h>
+    #include <windows.h>
+    #include <iostream>
+    #if defined(_MSC_VER)
+        #include <corecrt_io.h>
+    #else
+        #include <unistd.h>
+    #endif
+#else 
+    #include <unistd.h>
+#endif
+
+
+using namespace std;
+
+namespace nvilidar
+{
+
+#define COLOR_NONE "\033[m"
+#define COLOR_RED "\033[1;31m"
+#define COLOR_GREEN "\033[1;32m"
+#define COLOR_YELLOW "\033[1;33m"
+#define COLOR_CYAN "\033[1;36m"
+
+#define DEBUG_FLAG_FILE "/tmp/nvilidar-debug-flag"
+
+//console wrapper,the message is formatted here and written by the logger thread(never block the caller).
+//it has no data,every file may have a copy,the logger is one instance in the library.
+//a level under NVILIDAR_LOG_MIN_LEVEL has an empty body,NVILIDAR_LOG_xxx below removes the call and its arguments.
+class Console
+{
+public:
+    Console ()
+    {
+    }
+    ~Console (void) {}
+public:
+    void
+    show(const char* message_, ...)
+    {
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_INFO
+        va_list args;
+        va_start(args, message_);
+        LidarLogger::instance().LogV(NVILIDAR_LOG_LEVEL_INFO, NULL, message_, args);
+        va_end(args);
+#else
+        (void)message_;
+#endif
+    }
+    void
+    message (const char* message_, ...)
+    {
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_INFO
+        va_list args;
+        va_start(args, message_);
+        LidarLogger::instance().LogV(NVILIDAR_LOG_LEVEL_INFO, "[NVILidar]: ", message_, args);
+        va_end(args);
+#else
+        (void)message_;
+#endif
+    }
+    ;
+
+    void
+    debug (const char* debug_, ...)
+    {
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_DEBUG
+        va_list args;
+        va_start(args, debug_);
+        LidarLogger::instance().LogV(NVILIDAR_LOG_LEVEL_DEBUG, NULL, debug_, args);
+        va_end(args);
+#else
+        (void)debug_;
+#endif
+    }
+    ;
+
+    void
+    warning (const char* warning_, ...)
+    {
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_WARNING
+        va_list args;
+        va_start(args, warning_);
+        LidarLogger::instance().LogV(NVILIDAR_LOG_LEVEL_WARNING, NULL, warning_, args);
+        va_end(args);
+#else
+        (void)warning_;
+#endif
+    }
+    ;
+
+    void
+    error (const char* error_, ...)
+    {
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_ERROR
+        va_list args;
+        va_start(args, error_);
+        LidarLogger::instance().LogV(NVILIDAR_LOG_LEVEL_ERROR, NULL, error_, args);
+        va_end(args);
+#else
+        (void)error_;
+#endif
+    }
+    ;
+
+    void
+    flush (void)
+    {
+        LidarLogger::instance().Flush();
+    }
+    ;
+};
+
+static Console console;
+
+};
+
+//level gated calls,the arguments are not evaluated under NVILIDAR_LOG_MIN_LEVEL
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_DEBUG
+    #define NVILIDAR_LOG_DEBUG(...)     nvilidar::console.debug(__VA_ARGS__)
+#else
+    #define NVILIDAR_LOG_DEBUG(...)     do {} while (0)
+#endif
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_INFO
+    #define NVILIDAR_LOG_INFO(...)      nvilidar::console.message(__VA_ARGS__)
+#else
+    #define NVILIDAR_LOG_INFO(...)      do {} while (0)
+#endif
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_WARNING
+    #define NVILIDAR_LOG_WARNING(...)   nvilidar::console.warning(__VA_ARGS__)
+#else
+    #define NVILIDAR_LOG_WARNING(...)   do {} while (0)
+#endif
+#if NVILIDAR_LOG_MIN_LEVEL <= NVILIDAR_LOG_LEVEL_ERROR
+    #define NVILIDAR_LOG_ERROR(...)     nvilidar::console.error(__VA_ARGS__)
+#else
+    #define NVILIDAR_LOG_ERROR(...)     do {} while (0)
+#endif
+
+#endif /* _CONSOLE_H_ */
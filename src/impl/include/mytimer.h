@@ -1,58 +1,99 @@
-#pragma once 
-
-#include <stdio.h>
-#include <stdint.h>
-#include <time.h>
-#include <inttypes.h>
-#if defined(_WIN32)
-#include <mmsystem.h>
-#include <sysinfoapi.h>
-#include <WinSock2.h>
-#include <windows.h>
-#endif 
-
-#if defined(_WIN32)
-	//get corrent ns
-	inline uint64_t getStamp(void)
-	{
-		FILETIME		t;
-		GetSystemTimeAsFileTime(&t);		//get 100ns time (for 100ns min)
-		return ((((uint64_t)t.dwHighDateTime) << 32) | ((uint64_t)t.dwLowDateTime)) *
-			100;
-	}
-
-	//get current ms 
-	inline uint64_t getMS(void)
-	{
-		return GetTickCount64();
-	}
-
-	//dalay for some time 
-	inline void delayMS(uint32_t ms)
-	{
-		Sleep(ms);
-	}
-
-#else 
-	//get current ns 
-	inline uint64_t getStamp(void)
-	{
-		#if 1
-			struct timespec	tim;
-			clock_gettime(CLOCK_REALTIME, &tim);
-			return static_cast<uint64_t>(tim.tv_sec) * 1000000000LL + tim.tv_nsec;
-		#else
-			struct timeval timeofday;
-			gettimeofday(&timeofday, NULL);
-			return static_cast<uint64_t>(timeofday.tv_sec) * 1000000000LL +
-			static_cast<uint64_t>(timeofday.tv_usec) * 1000LL;
-		#endif
-	}
-
-	//sleep for some ms 
-	inline void delayMS(uint32_t ms)
-	{
-		usleep(ms*1000);
-	}
-
+#pragma once 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <inttypes.h>
+#if defined(_WIN32)
+#include <mmsystem.h>
+#include <sysinfoapi.h>
+#include <WinSock2.h>
+#include <windows.h>
+#else 
+#include <unistd.h>
+#endif 
+
+#if defined(_WIN32)
+	//get corrent ns
+	inline uint64_t getStamp(void)
+	{
+		FILETIME		t;
+		GetSystemTimeAsFileTime(&t);		//get 100ns time (for 100ns min)
+		return ((((uint64_t)t.dwHighDateTime) << 32) | ((uint64_t)t.dwLowDateTime)) *
+			100;
+	}
+
+	//get current ms 
+	inline uint64_t getMS(void)
+	{
+		return GetTickCount64();
+	}
+
+	//get current us (monotonic,for time measure)
+	inline uint64_t getUS(void)
+	{
+		LARGE_INTEGER	freq;
+		LARGE_INTEGER	count;
+		QueryPerformanceFrequency(&freq);
+		QueryPerformanceCounter(&count);
+		return (uint64_t)(count.QuadPart / freq.QuadPart * 1000000LL +
+			(count.QuadPart % freq.QuadPart) * 1000000LL / freq.QuadPart);
+	}
+
+	//dalay for some time 
+	inline void delayMS(uint32_t ms)
+	{
+		Sleep(ms);
+	}
+
+	//sleep for some us,less than 1ms gives up the time slice only 
+	inline void delayUS(uint32_t us)
+	{
+		Sleep(us / 1000);
+	}
+
+#else 
+	//get current ns 
+	inline uint64_t getStamp(void)
+	{
+		#if 1
+			struct timespec	tim;
+			clock_gettime(CLOCK_REALTIME, &tim);
+			return static_cast<uint64_t>(tim.tv_sec) * 1000000000LL + tim.tv_nsec;
+		#else
+			struct timeval timeofday;
+			gettimeofday(&timeofday, NULL);
+			return static_cast<uint64_t>(timeofday.tv_sec) * 1000000000LL +
+			static_cast<uint64_t>(timeofday.tv_usec) * 1000LL;
+		#endif
+	}
+
+	//get current ms (monotonic,not change with the system time)
+	inline uint64_t getMS(void)
+	{
+		struct timespec	tim;
+		clock_gettime(CLOCK_MONOTONIC, &tim);
+		return static_cast<uint64_t>(tim.tv_sec) * 1000LL + tim.tv_nsec / 1000000LL;
+	}
+
+	//get current us (monotonic,for time measure)
+	inline uint64_t getUS(void)
+	{
+		struct timespec	tim;
+		clock_gettime(CLOCK_MONOTONIC, &tim);
+		return static_cast<uint64_t>(tim.tv_sec) * 1000000LL + tim.tv_nsec / 1000LL;
+	}
+
+	//sleep for some ms 
+	inline void delayMS(uint32_t ms)
+	{
+		usleep(ms*1000);
+	}
+
+	//sleep for some us 
+	inline void delayUS(uint32_t us)
+	{
+		usleep(us);
+	}
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "nvilidar_circle.h"
+
+namespace nvilidar
+{
+	LidarCircleBuffer::LidarCircleBuffer()
+	{
+	}
+
+	void LidarCircleBuffer::clear()
+	{
+		angle.clear();
+		distance.clear();
+		quality.clear();
+		packages.clear();
+	}
+
+	void LidarCircleBuffer::reserve(size_t points)
+	{
+		angle.reserve(points);
+		distance.reserve(points);
+		quality.reserve(points);
+	}
+
+	//angle of every point,the float step is rounded to the raw resolution(1/64°)
+	void LidarCircleBuffer::AppendAngle(const Nvilidar_Package_Meta &meta)
+	{
+		for (uint16_t i = 0; i < meta.point_num; i++)
+		{
+			uint32_t value = (uint32_t)((float)(meta.first_angle) + i * meta.angle_differ + 0.5f);
+			while (value >= NVILIDAR_CIRCLE_ANGLE_MAX)
+			{
+				value -= NVILIDAR_CIRCLE_ANGLE_MAX;
+			}
+			angle.push_back((uint16_t)value);
+		}
+	}
+
+	//package with sensitive
+	void LidarCircleBuffer::AppendPackage(Nvilidar_Package_Meta meta, const Nvilidar_Protocol_PackageNode_Quality *samples)
+	{
+		if (distance.capacity() == 0)
+		{
+			reserve(NVILIDAR_CIRCLE_RESERVE);
+		}
+		meta.first_point = (uint32_t)size();
+		packages.push_back(meta);
+
+		AppendAngle(meta);
+		for (uint16_t i = 0; i < meta.point_num; i++)
+		{
+			distance.push_back(samples[i].PakageSampleDistance);
+			quality.push_back(samples[i].PakageSampleQuality);
+		}
+	}
+
+	//package without sensitive
+	void LidarCircleBuffer::AppendPackage(Nvilidar_Package_Meta meta, const Nvilidar_Protocol_PackageNode_NoQualiry *samples)
+	{
+		if (distance.capacity() == 0)
+		{
+			reserve(NVILIDAR_CIRCLE_RESERVE);
+		}
+		meta.first_point = (uint32_t)size();
+		packages.push_back(meta);
+
+		AppendAngle(meta);
+		for (uint16_t i = 0; i < meta.point_num; i++)
+		{
+			distance.push_back(samples[i].PakageSampleDistance);
+		}
+		quality.resize(distance.size(), 0);
+	}
+
+	//split at the zero angle point,a package in both parts is split too
+	void LidarCircleBuffer::MoveFront(size_t count, LidarCircleBuffer &out)
+	{
+		if (count > size())
+		{
+			count = size();
+		}
+
+		out.angle.assign(angle.begin(), angle.begin() + count);
+		out.distance.assign(distance.begin(), distance.begin() + count);
+		out.quality.assign(quality.begin(), quality.begin() + count);
+		out.packages.clear();
+
+		size_t keep = 0;
+		for (size_t i = 0; i < packages.size(); i++)
+		{
+			Nvilidar_Package_Meta meta = packages[i];
+			uint32_t stop = meta.first_point + meta.point_num;
+
+			if (meta.first_point < count)
+			{
+				Nvilidar_Package_Meta front = meta;
+				front.point_num = (uint16_t)(((stop < count) ? stop : count) - meta.first_point);
+				out.packages.push_back(front);
+			}
+			if (stop > count)
+			{
+				if (meta.first_point < count)
+				{
+					meta.first_angle = angle[count];
+					meta.point_num = (uint16_t)(stop - count);
+					meta.first_point = (uint32_t)count;
+				}
+				meta.first_point -= (uint32_t)count;
+				packages[keep++] = meta;
+			}
+		}
+		packages.resize(keep);
+
+		angle.erase(angle.begin(), angle.begin() + count);
+		distance.erase(distance.begin(), distance.begin() + count);
+		quality.erase(quality.begin(), quality.begin() + count);
+	}
+
+	Nvilidar_Node_Info LidarCircleBuffer::Node(size_t index) const
+	{
+		Nvilidar_Node_Info node;
+
+		node.lidar_angle = angle[index];
+		node.lidar_distance = distance[index];
+		node.lidar_quality = quality[index];
+
+		return node;
+	}
+}
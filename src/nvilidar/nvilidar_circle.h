@@ -0,0 +1,117 @@
+#pragma once
+
+#include "nvilidar_protocol.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+#include <new>
+#if defined(_WIN32)
+	#include <malloc.h>
+#endif
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_CIRCLE_API __declspec(dllexport)
+#else
+	#define NVILIDAR_CIRCLE_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_CIRCLE_ALIGN			64			//column start address(cache line)
+#define NVILIDAR_CIRCLE_RESERVE			4096		//points reserved at first,grow when more
+#define NVILIDAR_CIRCLE_ANGLE_MAX		(360 * NVILIDAR_ANGULDAR_RESOLUTION)	//raw angle of 360°
+
+namespace nvilidar
+{
+	//allocator of the column arrays,every column starts at a cache line
+	template <typename T>
+	class LidarAlignedAllocator
+	{
+		public:
+			typedef T value_type;
+
+			LidarAlignedAllocator() {}
+			template <typename U>
+			LidarAlignedAllocator(const LidarAlignedAllocator<U> &) {}
+
+			T *allocate(size_t n)
+			{
+				void *ptr = NULL;
+				size_t size = (n * sizeof(T) + NVILIDAR_CIRCLE_ALIGN - 1) / NVILIDAR_CIRCLE_ALIGN * NVILIDAR_CIRCLE_ALIGN;
+
+			#if defined(_WIN32)
+				ptr = _aligned_malloc(size, NVILIDAR_CIRCLE_ALIGN);
+			#else
+				if (0 != posix_memalign(&ptr, NVILIDAR_CIRCLE_ALIGN, size))
+				{
+					ptr = NULL;
+				}
+			#endif
+				if (ptr == NULL)
+				{
+					throw std::bad_alloc();
+				}
+				return static_cast<T *>(ptr);
+			}
+			void deallocate(T *ptr, size_t)
+			{
+			#if defined(_WIN32)
+				_aligned_free(ptr);
+			#else
+				free(ptr);
+			#endif
+			}
+	};
+
+	template <typename T, typename U>
+	bool operator==(const LidarAlignedAllocator<T> &, const LidarAlignedAllocator<U> &) { return true; }
+	template <typename T, typename U>
+	bool operator!=(const LidarAlignedAllocator<T> &, const LidarAlignedAllocator<U> &) { return false; }
+
+	typedef std::vector<uint16_t, LidarAlignedAllocator<uint16_t> > LidarCircleColumn;
+
+	//package info,one for every package of the circle
+	struct Nvilidar_Package_Meta
+	{
+		uint64_t	stamp;				//received the data stamp info(ns)
+		uint32_t	point_time;			//2 point time
+		uint32_t	first_point;		//index of the first point in the circle
+		uint16_t	point_num;			//points of this package in the circle
+		uint16_t	first_angle;		//x64
+		float		angle_differ;		//x64
+	};
+
+	//points of one circle,saved by column(structure of arrays)
+	//6 bytes every point,the time info is saved once for every package
+	class NVILIDAR_CIRCLE_API LidarCircleBuffer
+	{
+		public:
+			LidarCircleBuffer();
+
+			size_t size() const
+			{
+				return distance.size();
+			}
+			void clear();
+			void reserve(size_t points);
+
+			//append the points of a package,meta.first_point is set here
+			void AppendPackage(Nvilidar_Package_Meta meta, const Nvilidar_Protocol_PackageNode_Quality *samples);
+			void AppendPackage(Nvilidar_Package_Meta meta, const Nvilidar_Protocol_PackageNode_NoQualiry *samples);
+			//move the first count points to out,keep the rest
+			void MoveFront(size_t count, LidarCircleBuffer &out);
+
+			float Angle(size_t index) const		//degree
+			{
+				return (float)(angle[index]) / (float)(NVILIDAR_ANGULDAR_RESOLUTION);
+			}
+			Nvilidar_Node_Info Node(size_t index) const;
+
+			LidarCircleColumn	angle;			//x64 degree,0 ~ 23039
+			LidarCircleColumn	distance;		//mm
+			LidarCircleColumn	quality;		//0 if the lidar has no sensitive
+			std::vector<Nvilidar_Package_Meta>	packages;
+
+		private:
+			void AppendAngle(const Nvilidar_Package_Meta &meta);
+	};
+}
@@ -0,0 +1,332 @@
+#include "nvilidar_command.h"
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "mytimer.h"
+
+namespace nvilidar
+{
+	LidarCommandEngine::LidarCommandEngine()
+	{
+		memset(cmd_table, 0x00, sizeof(cmd_table));
+		memset(cmd_stale_until, 0x00, sizeof(cmd_stale_until));
+
+		//lidar response list (command byte,data length)
+		RegisterResponse(NVILIDAR_CMD_GET_DEVICE_INFO, sizeof(Nvilidar_Protocol_DeviceInfo));
+		RegisterResponse(NVILIDAR_CMD_GET_LIDAR_CFG, sizeof(Nvilidar_Protocol_GetPara));
+		RegisterResponse(NVILIDAR_CMD_SET_HAVE_INTENSITIES, sizeof(uint8_t));
+		RegisterResponse(NVILIDAR_CMD_SET_NO_INTENSITIES, sizeof(uint8_t));
+		RegisterResponse(NVILIDAR_CMD_SET_AIMSPEED, sizeof(uint16_t));
+		RegisterResponse(NVILIDAR_CMD_SET_SAMPLING_RATE, sizeof(uint32_t));
+		RegisterResponse(NVILIDAR_CMD_SET_TAILING_LEVEL, sizeof(uint8_t));
+		RegisterResponse(NVILIDAR_CMD_SET_APD_VALUE, sizeof(uint16_t));
+		RegisterResponse(NVILIDAR_CMD_SAVE_LIDAR_PARA, sizeof(uint8_t));
+		RegisterResponse(NVILIDAR_CMD_GET_ANGLE_OFFSET, sizeof(int16_t));
+		RegisterResponse(NVILIDAR_CMD_SET_ANGLE_OFFSET, sizeof(int16_t));
+		RegisterResponse(NVILIDAR_CMD_GET_QUALITY_THRESHOLD, sizeof(uint16_t));
+		RegisterResponse(NVILIDAR_CMD_SET_QUALITY_THRESHOLD, sizeof(uint16_t));
+	}
+
+	LidarCommandEngine::~LidarCommandEngine()
+	{
+		CancelAll();
+	}
+
+	//send interface
+	void LidarCommandEngine::SetSender(LidarCommandSender sender)
+	{
+		std::lock_guard<std::mutex> lock(cmd_mutex);
+		cmd_sender = sender;
+	}
+
+	//dispatch table
+	void LidarCommandEngine::RegisterResponse(uint8_t cmd, uint16_t length)
+	{
+		cmd_table[cmd].valid = true;
+		cmd_table[cmd].length = length;
+	}
+
+	//is the byte a response command
+	bool LidarCommandEngine::IsResponseCmd(uint8_t cmd)
+	{
+		return cmd_table[cmd].valid;
+	}
+
+	//async command
+	std::shared_future<LidarCommandResult> LidarCommandEngine::CommandAsync(uint8_t cmd, const uint8_t *payload, uint16_t size,
+												LidarCommandCallback callback, uint32_t timeout, uint8_t retries)
+	{
+		PendingPtr pending = std::make_shared<PendingCommand>();
+		std::shared_future<LidarCommandResult> result = pending->promise.get_future().share();
+		LidarCommandStateEnum fail_state = NVILIDAR_CMD_STATE_OK;
+
+		pending->cmd = cmd;
+		pending->size = 0;
+		pending->timeout = timeout;
+		pending->retries = retries;
+		pending->retries_used = 0;
+		pending->sent = false;
+		pending->first_send_ms = 0;
+		pending->deadline_ms = 0;
+		pending->not_before_ms = 0;
+		pending->callback = callback;
+
+		//payload too long
+		if (size > sizeof(pending->payload) - 6)
+		{
+			Finish(pending, NVILIDAR_CMD_STATE_SEND_FAIL, NULL);
+			return result;
+		}
+		if ((payload != NULL) && (size > 0))
+		{
+			memcpy(pending->payload, payload, size);
+			pending->size = size;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(cmd_mutex);
+			uint64_t now = getMS();
+
+			pending->not_before_ms = cmd_stale_until[cmd];
+			cmd_pending[cmd].push_back(pending);
+
+			//no other command with the same byte,send now
+			if ((cmd_pending[cmd].size() == 1) && (now >= pending->not_before_ms))
+			{
+				if (!SendPending(pending, now))
+				{
+					cmd_pending[cmd].pop_front();
+					fail_state = NVILIDAR_CMD_STATE_SEND_FAIL;
+				}
+			}
+		}
+
+		if (fail_state != NVILIDAR_CMD_STATE_OK)
+		{
+			Finish(pending, fail_state, NULL);
+		}
+
+		return result;
+	}
+
+	//sync command
+	bool LidarCommandEngine::Command(uint8_t cmd, const uint8_t *payload, uint16_t size,
+									Nvilidar_Protocol_NormalResponseData &response,
+									uint32_t timeout, uint8_t retries)
+	{
+		std::shared_future<LidarCommandResult> result = CommandAsync(cmd, payload, size, nullptr, timeout, retries);
+
+		//the caller poll too,the reader thread may be blocked in read
+		while (result.wait_for(std::chrono::milliseconds(5)) != std::future_status::ready)
+		{
+			Poll();
+		}
+
+		const LidarCommandResult &ret = result.get();
+		if (ret.state != NVILIDAR_CMD_STATE_OK)
+		{
+			return false;
+		}
+		response = ret.response;
+
+		return true;
+	}
+
+	//response from lidar
+	void LidarCommandEngine::Dispatch(const Nvilidar_Protocol_NormalResponseData &data)
+	{
+		PendingPtr done;
+		std::vector<PendingPtr> fail_list;
+
+		{
+			std::lock_guard<std::mutex> lock(cmd_mutex);
+			uint64_t now = getMS();
+
+			//not in dispatch table or length error
+			if (!cmd_table[data.cmd].valid)
+			{
+				return;
+			}
+			if ((cmd_table[data.cmd].length != NVILIDAR_CMD_LENGTH_ANY) &&
+				(cmd_table[data.cmd].length != data.length))
+			{
+				return;
+			}
+
+			//nobody wait for it,or it is a late response of a timeout command
+			std::deque<PendingPtr> &queue = cmd_pending[data.cmd];
+			if (queue.empty() || (!queue.front()->sent))
+			{
+				return;
+			}
+
+			done = queue.front();
+			queue.pop_front();
+
+			//send next command with the same byte
+			while (!queue.empty())
+			{
+				if (SendPending(queue.front(), now))
+				{
+					break;
+				}
+				fail_list.push_back(queue.front());
+				queue.pop_front();
+			}
+		}
+
+		Finish(done, NVILIDAR_CMD_STATE_OK, &data);
+		for (size_t i = 0; i < fail_list.size(); i++)
+		{
+			Finish(fail_list[i], NVILIDAR_CMD_STATE_SEND_FAIL, NULL);
+		}
+	}
+
+	//check timeout
+	void LidarCommandEngine::Poll()
+	{
+		std::vector<PendingPtr> timeout_list;
+		std::vector<PendingPtr> fail_list;
+
+		{
+			std::lock_guard<std::mutex> lock(cmd_mutex);
+			uint64_t now = getMS();
+
+			for (int i = 0; i < NVILIDAR_CMD_TABLE_SIZE; i++)
+			{
+				std::deque<PendingPtr> &queue = cmd_pending[i];
+
+				while (!queue.empty())
+				{
+					PendingPtr &head = queue.front();
+
+					//wait to send
+					if (!head->sent)
+					{
+						if (now < head->not_before_ms)
+						{
+							break;
+						}
+						if (SendPending(head, now))
+						{
+							break;
+						}
+						fail_list.push_back(head);
+						queue.pop_front();
+						continue;
+					}
+
+					//in flight
+					if (now < head->deadline_ms)
+					{
+						break;
+					}
+
+					//timeout,resend
+					if (head->retries > 0)
+					{
+						head->retries--;
+						head->retries_used++;
+						head->sent = false;
+						if (SendPending(head, now))
+						{
+							break;
+						}
+						fail_list.push_back(head);
+						queue.pop_front();
+						continue;
+					}
+
+					//timeout,no retries left.drop late response for a while
+					cmd_stale_until[i] = now + NVILIDAR_CMD_STALE_GUARD_MS;
+					timeout_list.push_back(head);
+					queue.pop_front();
+					for (size_t j = 0; j < queue.size(); j++)
+					{
+						queue[j]->not_before_ms = cmd_stale_until[i];
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < timeout_list.size(); i++)
+		{
+			Finish(timeout_list[i], NVILIDAR_CMD_STATE_TIMEOUT, NULL);
+		}
+		for (size_t i = 0; i < fail_list.size(); i++)
+		{
+			Finish(fail_list[i], NVILIDAR_CMD_STATE_SEND_FAIL, NULL);
+		}
+	}
+
+	//cancel all
+	void LidarCommandEngine::CancelAll()
+	{
+		std::vector<PendingPtr> cancel_list;
+
+		{
+			std::lock_guard<std::mutex> lock(cmd_mutex);
+			for (int i = 0; i < NVILIDAR_CMD_TABLE_SIZE; i++)
+			{
+				while (!cmd_pending[i].empty())
+				{
+					cancel_list.push_back(cmd_pending[i].front());
+					cmd_pending[i].pop_front();
+				}
+			}
+		}
+
+		for (size_t i = 0; i < cancel_list.size(); i++)
+		{
+			Finish(cancel_list[i], NVILIDAR_CMD_STATE_CANCEL, NULL);
+		}
+	}
+
+	//send command,lock must be held
+	bool LidarCommandEngine::SendPending(PendingPtr &pending, uint64_t now)
+	{
+		if (!cmd_sender)
+		{
+			return false;
+		}
+		if (!cmd_sender(pending->cmd, (pending->size > 0) ? pending->payload : NULL, pending->size))
+		{
+			return false;
+		}
+
+		if (pending->first_send_ms == 0)
+		{
+			pending->first_send_ms = now;
+		}
+		pending->sent = true;
+		pending->deadline_ms = now + pending->timeout;
+
+		return true;
+	}
+
+	//set result and call back
+	void LidarCommandEngine::Finish(PendingPtr pending, LidarCommandStateEnum state,
+									const Nvilidar_Protocol_NormalResponseData *data)
+	{
+		LidarCommandResult result;
+
+		memset(&result, 0x00, sizeof(result));
+		result.state = state;
+		result.cmd = pending->cmd;
+		result.retries = pending->retries_used;
+		if (pending->first_send_ms != 0)
+		{
+			result.elapsed_ms = getMS() - pending->first_send_ms;
+		}
+		if (data != NULL)
+		{
+			result.response = *data;
+		}
+
+		pending->promise.set_value(result);
+		if (pending->callback)
+		{
+			pending->callback(result);
+		}
+	}
+}
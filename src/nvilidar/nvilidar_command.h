@@ -0,0 +1,109 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include "nvilidar_protocol.h"
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <functional>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_COMMAND_API __declspec(dllexport)
+#else
+	#define NVILIDAR_COMMAND_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_CMD_TABLE_SIZE			256			//one entry for every command byte
+#define NVILIDAR_CMD_LENGTH_ANY			0xFFFF		//response length is not checked
+#define NVILIDAR_CMD_STALE_GUARD_MS		20			//after a timeout,wait before reuse the same command byte
+
+//command finish state
+typedef enum
+{
+	NVILIDAR_CMD_STATE_OK = 0,			//response received
+	NVILIDAR_CMD_STATE_TIMEOUT,			//no response after all retries
+	NVILIDAR_CMD_STATE_SEND_FAIL,		//write to serialport/socket fail
+	NVILIDAR_CMD_STATE_CANCEL,			//cancel by close handle
+}LidarCommandStateEnum;
+
+//command result
+typedef struct
+{
+	LidarCommandStateEnum	state;		//finish state
+	uint8_t		cmd;					//command byte
+	uint8_t		retries;				//retry times used
+	uint64_t	elapsed_ms;				//time from first send to finish
+	Nvilidar_Protocol_NormalResponseData response;	//response data(valid when state is ok)
+}LidarCommandResult;
+
+typedef std::function<void(const LidarCommandResult &result)> LidarCommandCallback;			//command finish callback
+typedef std::function<bool(uint8_t cmd, uint8_t *payload, uint16_t size)> LidarCommandSender;	//send bytes to lidar
+
+namespace nvilidar
+{
+	//command/response engine,response is matched with the request by command byte
+	class NVILIDAR_COMMAND_API LidarCommandEngine
+	{
+		public:
+			LidarCommandEngine();
+			~LidarCommandEngine();
+
+			void SetSender(LidarCommandSender sender);						//send interface(serialport or udp)
+			void RegisterResponse(uint8_t cmd, uint16_t length);			//add a response to the dispatch table
+			bool IsResponseCmd(uint8_t cmd);								//is the command byte a valid response
+
+			//async command,the future is ready when the response arrive or timeout
+			std::shared_future<LidarCommandResult> CommandAsync(uint8_t cmd, const uint8_t *payload = NULL, uint16_t size = 0,
+												LidarCommandCallback callback = nullptr,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT,
+												uint8_t retries = NVILIDAR_DEFAULT_RETRY);
+			//sync command,block until response or timeout
+			bool Command(uint8_t cmd, const uint8_t *payload, uint16_t size,
+												Nvilidar_Protocol_NormalResponseData &response,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT,
+												uint8_t retries = NVILIDAR_DEFAULT_RETRY);
+
+			void Dispatch(const Nvilidar_Protocol_NormalResponseData &data);	//response from lidar(reader thread)
+			void Poll();													//check timeout and resend
+			void CancelAll();												//finish all pending command with cancel
+
+		private:
+			//one pending command
+			struct PendingCommand
+			{
+				uint8_t		cmd;
+				uint8_t		payload[1024];
+				uint16_t	size;
+				uint32_t	timeout;
+				uint8_t		retries;			//retries left
+				uint8_t		retries_used;
+				bool		sent;
+				uint64_t	first_send_ms;
+				uint64_t	deadline_ms;
+				uint64_t	not_before_ms;		//stale guard
+				LidarCommandCallback	callback;
+				std::promise<LidarCommandResult>	promise;
+			};
+			typedef std::shared_ptr<PendingCommand> PendingPtr;
+
+			//dispatch table entry
+			struct ResponseEntry
+			{
+				bool		valid;
+				uint16_t	length;
+			};
+
+			bool SendPending(PendingPtr &pending, uint64_t now);		//send (lock must be held)
+			void Finish(PendingPtr pending, LidarCommandStateEnum state,
+								const Nvilidar_Protocol_NormalResponseData *data);	//set result (no lock)
+
+			std::mutex					cmd_mutex;
+			LidarCommandSender			cmd_sender;
+			ResponseEntry				cmd_table[NVILIDAR_CMD_TABLE_SIZE];
+			std::deque<PendingPtr>		cmd_pending[NVILIDAR_CMD_TABLE_SIZE];	//FIFO for every command byte
+			uint64_t					cmd_stale_until[NVILIDAR_CMD_TABLE_SIZE];	//drop late response until
+	};
+}
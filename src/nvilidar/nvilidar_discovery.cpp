@@ -0,0 +1,442 @@
+#include "nvilidar_discovery.h"
+#include "myconsole.h"
+#include "mytimer.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <algorithm>
+#if defined(__linux__)
+	#include <unistd.h>
+	#include <poll.h>
+	#include <sys/socket.h>
+	#include <linux/netlink.h>
+#endif
+
+namespace nvilidar
+{
+	static std::string LidarLowerCase(std::string str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)tolower(c); });
+		return str;
+	}
+
+	//real device of a port name(udev link),empty if it is not there
+	static std::string LidarRealDevice(const std::string &port)
+	{
+	#if defined(__linux__)
+		char *real_name = realpath(port.c_str(), NULL);
+		if (NULL == real_name)
+		{
+			return "";
+		}
+		std::string device = real_name;
+		free(real_name);
+
+		return device;
+	#else
+		return port;
+	#endif
+	}
+
+	LidarPortDiscovery::LidarPortDiscovery()
+	{
+		discovery_running = false;
+		discovery_socket = -1;
+		lidar_next_id = 0;
+		lidar_calling = 0;
+	}
+
+	LidarPortDiscovery::~LidarPortDiscovery()
+	{
+		Stop();
+	}
+
+	//list the ports once and follow the hotplug
+	bool LidarPortDiscovery::Start(std::string match, LidarPortCallback callback)
+	{
+		if (discovery_running)
+		{
+			return false;
+		}
+		discovery_match = LidarLowerCase(match);
+		discovery_callback = callback;
+
+		//subscribe before the list,no event is lost between them
+		if (!OpenNetlink())
+		{
+			nvilidar::console.warning("no uevent socket,list the serialports every %dms", NVILIDAR_DISCOVERY_SCAN_MS);
+		}
+		{
+			std::lock_guard<std::mutex> lock(ports_mutex);
+			ports_known.clear();
+		}
+		ScanPorts();
+		RefreshDevices();
+
+		discovery_running = true;
+		discovery_thread = std::thread(&LidarPortDiscovery::DiscoveryThread, this);
+
+		return true;
+	}
+
+	void LidarPortDiscovery::Stop()
+	{
+		if (!discovery_running)
+		{
+			return;
+		}
+		discovery_running = false;
+		if (discovery_thread.joinable())
+		{
+			discovery_thread.join();
+		}
+
+	#if defined(__linux__)
+		if (discovery_socket >= 0)
+		{
+			close(discovery_socket);
+			discovery_socket = -1;
+		}
+	#endif
+	}
+
+	bool LidarPortDiscovery::IsRunning()
+	{
+		return discovery_running;
+	}
+
+	bool LidarPortDiscovery::IsNetlink()
+	{
+		return (discovery_socket >= 0);
+	}
+
+	std::vector<NvilidarSerialPortInfo> LidarPortDiscovery::GetPorts()
+	{
+		std::vector<NvilidarSerialPortInfo> ports;
+
+		std::lock_guard<std::mutex> lock(ports_mutex);
+		for (std::map<std::string, NvilidarSerialPortInfo>::iterator it = ports_known.begin(); it != ports_known.end(); it++)
+		{
+			if (Match(it->second))
+			{
+				ports.push_back(it->second);
+			}
+		}
+
+		return ports;
+	}
+
+	//lidar on the port,told when the device of the port is removed or a port is added
+	int LidarPortDiscovery::Add(std::string port, std::function<void(bool present)> event)
+	{
+		if (port.empty() || !event)
+		{
+			return -1;
+		}
+
+		LidarPortEntry entry;
+		entry.port = port;
+		entry.device = LidarRealDevice(port);
+		entry.event = event;
+
+		std::lock_guard<std::mutex> lock(lidar_mutex);
+		int id = lidar_next_id++;
+		lidar_entries[id] = entry;
+
+		return id;
+	}
+
+	//wait for the events being called,not in the event itself(the thread of the events) 
+	void LidarPortDiscovery::Remove(int id)
+	{
+		std::unique_lock<std::mutex> lock(lidar_mutex);
+		lidar_entries.erase(id);
+		if (std::this_thread::get_id() != lidar_calling_thread)
+		{
+			lidar_idle.wait(lock, [this]() { return (0 == lidar_calling); });
+		}
+	}
+
+	//---------------------------------------private---------------------------------
+
+	void LidarPortDiscovery::DiscoveryThread()
+	{
+		uint64_t scan_ms = getMS();
+
+		while (discovery_running)
+		{
+		#if defined(__linux__)
+			if (discovery_socket >= 0)
+			{
+				struct pollfd pfd;
+				pfd.fd = discovery_socket;
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				if (poll(&pfd, 1, NVILIDAR_DISCOVERY_WAIT_MS) > 0)
+				{
+					ReadNetlink();
+				}
+				RefreshDevices();		//the udev link comes after the kernel event
+				continue;
+			}
+		#endif
+
+			delayMS(NVILIDAR_DISCOVERY_WAIT_MS);
+			if (getMS() - scan_ms >= NVILIDAR_DISCOVERY_SCAN_MS)
+			{
+				scan_ms = getMS();
+				ScanPorts();
+			}
+			RefreshDevices();
+		}
+	}
+
+	//kernel uevents,no udev needed(container)
+	bool LidarPortDiscovery::OpenNetlink()
+	{
+	#if defined(__linux__)
+		int sock = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+		if (sock < 0)
+		{
+			return false;
+		}
+
+		struct sockaddr_nl addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.nl_family = AF_NETLINK;
+		addr.nl_groups = 1;				//kernel events,2 is the udev daemon
+		if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		{
+			close(sock);
+			return false;
+		}
+		discovery_socket = sock;
+
+		return true;
+	#else
+		return false;
+	#endif
+	}
+
+	//"add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0DEVNAME=ttyUSB0\0..."
+	void LidarPortDiscovery::ReadNetlink()
+	{
+	#if defined(__linux__)
+		char buf[NVILIDAR_DISCOVERY_UEVENT_SIZE];
+
+		while (true)
+		{
+			struct sockaddr_nl from;
+			struct iovec iov;
+			struct msghdr msg;
+			memset(&from, 0, sizeof(from));
+			memset(&msg, 0, sizeof(msg));
+			iov.iov_base = buf;
+			iov.iov_len = sizeof(buf) - 1;
+			msg.msg_name = &from;
+			msg.msg_namelen = sizeof(from);
+			msg.msg_iov = &iov;
+			msg.msg_iovlen = 1;
+
+			ssize_t len = recvmsg(discovery_socket, &msg, 0);
+			if (len <= 0)
+			{
+				return;
+			}
+			//from the kernel only
+			if ((from.nl_pid != 0) || (msg.msg_flags & MSG_TRUNC))
+			{
+				continue;
+			}
+			buf[len] = '\0';
+
+			std::string action;
+			std::string subsystem;
+			std::string devname;
+			for (ssize_t pos = strlen(buf) + 1; pos < len; pos += strlen(buf + pos) + 1)
+			{
+				const char *line = buf + pos;
+				if (0 == strncmp(line, "ACTION=", 7))
+				{
+					action = line + 7;
+				}
+				else if (0 == strncmp(line, "SUBSYSTEM=", 10))
+				{
+					subsystem = line + 10;
+				}
+				else if (0 == strncmp(line, "DEVNAME=", 8))
+				{
+					devname = line + 8;
+				}
+			}
+			if ((subsystem != "tty") || devname.empty())
+			{
+				continue;
+			}
+
+			std::string port = (devname[0] == '/') ? devname : ("/dev/" + devname);
+			if (action == "add")
+			{
+				//usb parent is in sysfs already,the same as the list
+				if ((devname.find("ttyACM") == std::string::npos) && (devname.find("ttyUSB") == std::string::npos))
+				{
+					continue;
+				}
+				std::vector<std::string> sysfs_info = get_sysfs_info(port);
+
+				NvilidarSerialPortInfo info;
+				info.portName = port;
+				info.description = sysfs_info[0];
+				info.hardware_id = sysfs_info[1];
+				PortAdded(info);
+			}
+			else if (action == "remove")
+			{
+				PortRemoved(port);
+			}
+		}
+	#endif
+	}
+
+	//no uevent,compare the list with the last one
+	void LidarPortDiscovery::ScanPorts()
+	{
+		std::vector<NvilidarSerialPortInfo> ports = LidarDriverSerialport::getPortList();
+		std::vector<std::string> removed;
+
+		{
+			std::lock_guard<std::mutex> lock(ports_mutex);
+			for (std::map<std::string, NvilidarSerialPortInfo>::iterator it = ports_known.begin(); it != ports_known.end(); it++)
+			{
+				bool found = false;
+				for (size_t i = 0; i < ports.size(); i++)
+				{
+					found = found || (ports[i].portName == it->first);
+				}
+				if (!found)
+				{
+					removed.push_back(it->first);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < removed.size(); i++)
+		{
+			PortRemoved(removed[i]);
+		}
+		for (size_t i = 0; i < ports.size(); i++)
+		{
+			PortAdded(ports[i]);
+		}
+	}
+
+	void LidarPortDiscovery::PortAdded(const NvilidarSerialPortInfo &port)
+	{
+		{
+			std::lock_guard<std::mutex> lock(ports_mutex);
+			if (ports_known.count(port.portName) > 0)
+			{
+				return;
+			}
+			ports_known[port.portName] = port;
+		}
+
+		//the lidar on this device,or on a link not made yet,retries at once
+		std::vector<std::function<void(bool present)> > events;
+		{
+			std::lock_guard<std::mutex> lock(lidar_mutex);
+			for (std::map<int, LidarPortEntry>::iterator it = lidar_entries.begin(); it != lidar_entries.end(); it++)
+			{
+				std::string device = LidarRealDevice(it->second.port);
+				if (!device.empty())
+				{
+					it->second.device = device;
+				}
+				if (device.empty() || (device == port.portName))
+				{
+					events.push_back(it->second.event);
+				}
+			}
+			lidar_calling++;
+			lidar_calling_thread = std::this_thread::get_id();
+		}
+		CallEvents(events, true);
+
+		if (discovery_callback && Match(port))
+		{
+			discovery_callback(NVILIDAR_PORT_ADD, port);
+		}
+	}
+
+	void LidarPortDiscovery::PortRemoved(const std::string &port)
+	{
+		NvilidarSerialPortInfo info;
+
+		{
+			std::lock_guard<std::mutex> lock(ports_mutex);
+			std::map<std::string, NvilidarSerialPortInfo>::iterator it = ports_known.find(port);
+			if (it == ports_known.end())
+			{
+				return;
+			}
+			info = it->second;
+			ports_known.erase(it);
+		}
+
+		//the link to the device is gone too,use the last device
+		std::vector<std::function<void(bool present)> > events;
+		{
+			std::lock_guard<std::mutex> lock(lidar_mutex);
+			for (std::map<int, LidarPortEntry>::iterator it = lidar_entries.begin(); it != lidar_entries.end(); it++)
+			{
+				if ((it->second.device == port) || (it->second.port == port))
+				{
+					events.push_back(it->second.event);
+				}
+			}
+			lidar_calling++;
+			lidar_calling_thread = std::this_thread::get_id();
+		}
+		CallEvents(events, false);
+
+		if (discovery_callback && Match(info))
+		{
+			discovery_callback(NVILIDAR_PORT_REMOVE, info);
+		}
+	}
+
+	//no lock in the events,a stall callback may close the lidar(Remove) 
+	void LidarPortDiscovery::CallEvents(const std::vector<std::function<void(bool present)> > &events, bool present)
+	{
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			events[i](present);
+		}
+
+		std::lock_guard<std::mutex> lock(lidar_mutex);
+		lidar_calling--;
+		if (0 == lidar_calling)
+		{
+			lidar_calling_thread = std::thread::id();
+		}
+		lidar_idle.notify_all();
+	}
+
+	void LidarPortDiscovery::RefreshDevices()
+	{
+		std::lock_guard<std::mutex> lock(lidar_mutex);
+		for (std::map<int, LidarPortEntry>::iterator it = lidar_entries.begin(); it != lidar_entries.end(); it++)
+		{
+			std::string device = LidarRealDevice(it->second.port);
+			if (!device.empty())
+			{
+				it->second.device = device;
+			}
+		}
+	}
+
+	bool LidarPortDiscovery::Match(const NvilidarSerialPortInfo &port)
+	{
+		return discovery_match.empty() || (LidarLowerCase(port.hardware_id).find(discovery_match) != std::string::npos);
+	}
+}
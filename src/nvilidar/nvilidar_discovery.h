@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "nvilidar_driver_serialport.h"
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_DISCOVERY_API __declspec(dllexport)
+#else
+	#define NVILIDAR_DISCOVERY_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_DISCOVERY_WAIT_MS		100			//wait of one loop,stop and link refresh
+#define NVILIDAR_DISCOVERY_SCAN_MS		500			//list the ports again,no netlink(windows,no permission)
+#define NVILIDAR_DISCOVERY_UEVENT_SIZE	8192		//max bytes of one uevent
+
+namespace nvilidar
+{
+	//port hotplug event
+	typedef enum
+	{
+		NVILIDAR_PORT_ADD = 0,		//plugged in(or found by the first list)
+		NVILIDAR_PORT_REMOVE,		//unplugged
+	}LidarPortEventEnum;
+
+	//called in the discovery thread,return quickly
+	typedef std::function<void(LidarPortEventEnum event, const NvilidarSerialPortInfo &port)> LidarPortCallback;
+
+	//usb serialport discovery,list once and follow the kernel uevents(netlink) on linux,list again and again on the others
+	//the lidars on the ports are told at once,the link does not wait for the stall timeout and the backoff
+	class NVILIDAR_DISCOVERY_API LidarPortDiscovery
+	{
+		public:
+			LidarPortDiscovery();
+			~LidarPortDiscovery();
+
+			//match:part of the hardware id,"VID:PID=10c4:ea60","SNR=0001",""(any usb serialport),not case sensitive
+			bool Start(std::string match = "", LidarPortCallback callback = nullptr);
+			void Stop();
+			bool IsRunning();
+			bool IsNetlink();						//uevent in use,false:list again and again
+			std::vector<NvilidarSerialPortInfo> GetPorts();		//matched ports now,no blocking
+
+			int Add(std::string port, std::function<void(bool present)> event);	//lidar on the port(or a udev link),id,-1:fail
+			void Remove(int id);					//no event of the lidar after return(called in the event:no wait)
+
+		private:
+			typedef struct
+			{
+				std::string		port;			//name given by the user
+				std::string		device;			//last real device of the port,the link is gone with the device
+				std::function<void(bool present)>	event;
+			}LidarPortEntry;
+
+			void DiscoveryThread();
+			bool OpenNetlink();
+			void ReadNetlink();						//all the uevents in the socket
+			void ScanPorts();						//list and compare with the known ports
+			void PortAdded(const NvilidarSerialPortInfo &port);
+			void PortRemoved(const std::string &port);
+			void CallEvents(const std::vector<std::function<void(bool present)> > &events, bool present);
+			void RefreshDevices();					//real device of the lidar ports
+			bool Match(const NvilidarSerialPortInfo &port);
+
+			std::thread					discovery_thread;
+			std::atomic<bool>			discovery_running;
+			int							discovery_socket;		//netlink,-1:not used
+			std::string					discovery_match;		//lower case
+			LidarPortCallback			discovery_callback;
+
+			std::mutex					ports_mutex;
+			std::map<std::string, NvilidarSerialPortInfo>	ports_known;	//all usb ports,matched or not
+
+			std::mutex					lidar_mutex;			//lidars,not held in the events
+			std::condition_variable		lidar_idle;				//no event is being called
+			std::map<int, LidarPortEntry>	lidar_entries;
+			int							lidar_next_id;
+			int							lidar_calling;			//events being called
+			std::thread::id				lidar_calling_thread;	//Remove in the event does not wait
+	};
+}
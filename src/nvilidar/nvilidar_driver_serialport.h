@@ -1,151 +1,242 @@
-#pragma once
-
-#include "nvilidar_def.h"
-#include "nvilidar_protocol.h"
-#include "serial/nvilidar_serial.h"
-#include "nvilidar_filter.h"
-#include <string>
-#include <vector>
-#include <stdint.h>
-#include <math.h>
-
-#if defined(_WIN32)
-#include <conio.h>
-#include <WinSock2.h>
-#include <windows.h>
-#include <process.h>
-#include <tlhelp32.h>
-#include <sys/utime.h>
-#include <io.h>
-#include <direct.h>
-#else
-#include <assert.h>
-#include <pthread.h>
-#include <sys/time.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <errno.h>
-#include <stdio.h>
-#include <stdlib.h>
-#endif
-
-//serialport info 
-typedef struct 
-{
-	std::string portName;
-	std::string description;
-}NvilidarSerialPortInfo;
-
-//---vs lib 
-#ifdef WIN32
-	#define NVILIDAR_DRIVER_SERIAL_API __declspec(dllexport)
-#else
-	#define NVILIDAR_DRIVER_SERIAL_API
-#endif // ifdef WIN32
-
-namespace nvilidar
-{
-    //lidar driver 
-	class  NVILIDAR_DRIVER_SERIAL_API LidarDriverSerialport
-    {
-		public:
-			LidarDriverSerialport();                
-			~LidarDriverSerialport();          
-
-			void LidarLoadConfig(Nvilidar_UserConfigTypeDef cfg);
-			bool LidarIsConnected();			//is lidar connected 
-			bool LidarGetScanState();			//is lidar transing data 
-			bool LidarInitialialize();			//lidar init 
-			bool LidarCloseHandle();			//lidar quit and disconnect 
-			bool LidarTurnOn();					//start scan    
-			bool LidarTurnOff();				//stop scan 
-
-
-			std::string getSDKVersion();										//get current sdk version 
-			static std::vector<NvilidarSerialPortInfo> getPortList();			//get serialport list 
-			bool StartScan(void);                           //start scan 
-			bool StopScan(void);                            //stop scan 
-			bool Reset(void);								//lidar reset 
-
-			bool SetIntensities(const uint8_t has_intensity, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);     //set lidar has/has not sensitive 
-			bool GetDeviceInfo(Nvilidar_DeviceInfo & info, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
-			bool SetScanMotorSpeed(uint16_t frequency_add, uint16_t &ret_frequency,    						//set lidar aim speed 
-													uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
-			bool SetSamplingRate(uint32_t rate_add, uint32_t &rate,
-											uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);   	//set lidar sampling 
-			bool SetTrailingLevel(uint8_t tral_set, uint8_t &tral,
-												uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);
-			bool SetApdValue(uint16_t apd_set, uint16_t &apd,
-											uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);		//set lidar apd value 
-
-			bool GetLidarCfg(Nvilidar_StoreConfigTypeDef &info,									//get config para 
-												uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);
-
-			bool GetZeroOffsetAngle(int16_t &angle,												//lidar lidar 0 offset 
-												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
-			bool SetZeroOffsetAngle(int16_t angle_set, int16_t &angle,
-												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT); 	//get lidar 0 offset 
-
-			bool GetFilterQualityThreshold(uint16_t &ret_filter_quality,uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);	 //get lidar filter quality 
-
-			bool SetFilterQualityThreshold(uint16_t filter_quality_set, uint16_t &ret_filter_quality,
-												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);	//set lidar filter quality value 
-
-			bool SaveCfg(bool &flag,uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);				//save para
-
-			bool LidarSamplingProcess(LidarScan &scan, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);  //lidar data output 
-
-			Nvilidar_PackageStateTypeDef   lidar_state;											//lidar state 
-
-		private:
-			bool LidarConnect(std::string portname, uint32_t baud = 921600);  //serialport init 
-			void LidarDisconnect();      //close serialport 
-			bool SendSerial(const uint8_t *data, size_t size);      //send data to serail 
-			void FlushSerial();		//flush serialport data 
-			bool SendCommand(uint8_t cmd, uint8_t *payload = NULL,uint16_t payloadsize = 0);
-			void NormalDataUnpack(uint8_t *buf, uint16_t len);		//unpack（normal data）
-			void NormalDataAnalysis(Nvilidar_Protocol_NormalResponseData data);	
-			bool PointDataUnpack(uint8_t *byte, uint16_t len);		//unpack（point cloud）
-			void PointDataAnalysis(Nvilidar_PointViewerPackageInfoTypeDef data);	
-			LidarModelListEnumTypeDef GetLidarModelName(Nvilidar_DeviceInfo info);			//get lidar model name  
-			
-			//thread  
-			bool createThread();		//create thread 
-			void closeThread();			//close thread 
-			bool waitNormalResponse(uint32_t timeout = NVILIDAR_POINT_TIMEOUT);	//wait for lidar response nomal data 
-			void setNormalResponseUnlock();	//unlock nomal data  
-			void setCircleResponseUnlock();	//unlock point data 
-			void LidarSamplingData(CircleDataInfoTypeDef info, LidarScan &outscan);		//interface for lidar point data 
-
-			//----------------------serialport---------------------------
-
-			nvilidar_serial::Nvilidar_Serial serialport;
-
-			//----------------------value ----------------------------
-			Nvilidar_UserConfigTypeDef     lidar_cfg;				//lidar config data 
-			CircleDataInfoTypeDef		   circleDataInfo;			//lida circle data  
-			NvilidarRecvInfoTypeDef		   recv_info;				//lidar receive data 
-
-			uint32_t    m_0cIndex = 0;                  //0 index
-			int32_t     m_last0cIndex = 0;              //0 index
-			uint32_t    m_differ0cIndex = 0;            //0 index
-			bool        m_first_circle_finish = false;  //first circle finish,case calc fault
-			uint64_t	m_run_circles = 0;				//has send data   
-
-			//---------------------thread---------------------------
-			#if defined(_WIN32)
-				HANDLE  _thread = NULL;
-				HANDLE  _event_analysis = NULL;		
-				HANDLE  _event_circle = NULL;			
-
-				DWORD static WINAPI periodThread(LPVOID lpParameter);		//thread  
-			#else 
-				pthread_t _thread = -1;
-				pthread_cond_t _cond_analysis;
-				pthread_mutex_t _mutex_analysis;
-				pthread_cond_t _cond_point;
-				pthread_mutex_t _mutex_point;
-				static void *periodThread(void *lpParameter) ;
-			#endif
-    };
-}
+#pragma once
+
+#include "nvilidar_def.h"
+#include "nvilidar_protocol.h"
+#include "serial/nvilidar_serial.h"
+#include "nvilidar_filter.h"
+#include "nvilidar_command.h"
+#include "nvilidar_link.h"
+#include "nvilidar_metrics.h"
+#include "nvilidar_trace.h"
+#include "nvilidar_health.h"
+#include "nvilidar_hub.h"
+#include "nvilidar_rt.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <math.h>
+
+#if defined(_WIN32)
+#include <conio.h>
+#include <WinSock2.h>
+#include <windows.h>
+#include <process.h>
+#include <tlhelp32.h>
+#include <sys/utime.h>
+#include <io.h>
+#include <direct.h>
+#else
+#include <assert.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+//serialport info 
+typedef struct 
+{
+	std::string portName;
+	std::string description;
+	std::string hardware_id;		//USB VID:PID=xxxx:xxxx SNR=xxx,"n/a" if not available 
+}NvilidarSerialPortInfo;
+
+//---vs lib 
+#ifdef WIN32
+	#define NVILIDAR_DRIVER_SERIAL_API __declspec(dllexport)
+#else
+	#define NVILIDAR_DRIVER_SERIAL_API
+#endif // ifdef WIN32
+
+namespace nvilidar
+{
+	class LidarPortDiscovery;
+
+    //lidar driver 
+	class  NVILIDAR_DRIVER_SERIAL_API LidarDriverSerialport
+    {
+		public:
+			LidarDriverSerialport();                
+			~LidarDriverSerialport();          
+
+			void LidarLoadConfig(Nvilidar_UserConfigTypeDef cfg);
+			bool LidarIsConnected();			//is lidar connected 
+			bool LidarGetScanState();			//is lidar transing data 
+			bool LidarInitialialize();			//lidar init 
+			bool LidarCloseHandle();			//lidar quit and disconnect 
+			bool LidarTurnOn();					//start scan    
+			bool LidarTurnOff();				//stop scan 
+			bool LidarReconfigure(Nvilidar_UserConfigTypeDef cfg);	//reload para while running 
+			LidarLinkStats LidarGetLinkStats();	//reconnect statistics 
+			void LidarSetStallCallback(LidarStallCallback callback);	//stall event 
+			LidarParseStats LidarGetParseStats();	//package parse statistics 
+			LidarStats LidarGetStats();				//runtime statistics 
+			LidarLatencyStats LidarGetLatencyStats();	//rolling latency of the last scans 
+			void LidarSetHealthCallback(LidarHealthCallback callback, uint32_t circles = NVILIDAR_HEALTH_CIRCLES);	//health record event 
+			bool LidarGetHealth(NviLidarHealth &health);	//last health record 
+			bool LidarSetHub(LidarHub *hub);				//read by the hub thread(NULL:own thread),call before LidarInitialialize 
+			int LidarGetHubId();							//id in the hub,-1:not in a hub 
+			bool LidarSetThreadPara(LidarThreadPara para);	//cpu/priority/memory lock of the own thread(hub:LidarHub::SetThreadPara),call before LidarInitialialize 
+			bool LidarSetSerialTuning(nvilidar_serial::SerialTuning tuning);	//low latency flag/vmin/vtime/rx queue,call before LidarInitialialize 
+			nvilidar_serial::SerialTuning LidarGetSerialTuning();				//settings the port really uses 
+			bool LidarSetPortDiscovery(LidarPortDiscovery *discovery);		//reopen at once on hotplug(NULL:stall timeout only),call before LidarInitialialize 
+
+
+			std::string getSDKVersion();										//get current sdk version 
+			static std::vector<NvilidarSerialPortInfo> getPortList();			//get serialport list 
+			bool StartScan(void);                           //start scan 
+			bool StopScan(void);                            //stop scan 
+			bool Reset(void);								//lidar reset 
+
+			bool SetIntensities(const uint8_t has_intensity, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);     //set lidar has/has not sensitive 
+			bool GetDeviceInfo(Nvilidar_DeviceInfo & info, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
+			bool SetScanMotorSpeed(uint16_t frequency_add, uint16_t &ret_frequency,    						//set lidar aim speed 
+													uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
+			bool SetSamplingRate(uint32_t rate_add, uint32_t &rate,
+											uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);   	//set lidar sampling 
+			bool SetTrailingLevel(uint8_t tral_set, uint8_t &tral,
+												uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);
+			bool SetApdValue(uint16_t apd_set, uint16_t &apd,
+											uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);		//set lidar apd value 
+
+			bool GetLidarCfg(Nvilidar_StoreConfigTypeDef &info,									//get config para 
+												uint32_t  timeout = NVILIDAR_DEFAULT_TIMEOUT);
+
+			bool GetZeroOffsetAngle(int16_t &angle,												//lidar lidar 0 offset 
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);
+			bool SetZeroOffsetAngle(int16_t angle_set, int16_t &angle,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT); 	//get lidar 0 offset 
+
+			bool GetFilterQualityThreshold(uint16_t &ret_filter_quality,uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);	 //get lidar filter quality 
+
+			bool SetFilterQualityThreshold(uint16_t filter_quality_set, uint16_t &ret_filter_quality,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);	//set lidar filter quality value 
+
+			bool SaveCfg(bool &flag,uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);				//save para
+
+			std::shared_future<LidarCommandResult> LidarCommandAsync(uint8_t cmd, const uint8_t *payload = NULL, uint16_t size = 0,	//async command
+												LidarCommandCallback callback = nullptr,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT,
+												uint8_t retries = NVILIDAR_DEFAULT_RETRY);
+
+			bool LidarSamplingProcess(LidarScan &scan, uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT);  //lidar data output 
+
+			Nvilidar_PackageStateTypeDef   lidar_state;											//lidar state 
+
+		private:
+			bool LidarConnect(std::string portname, uint32_t baud = 921600);  //serialport init 
+			void LidarDisconnect();      //close serialport 
+			bool SendSerial(const uint8_t *data, size_t size);      //send data to serail 
+			void FlushSerial();		//flush serialport data 
+			bool SendCommand(uint8_t cmd, uint8_t *payload = NULL,uint16_t payloadsize = 0);
+			void NormalDataUnpack(const uint8_t *buf, uint16_t len);		//unpack（normal data）
+			bool PointDataUnpack(const uint8_t *byte, uint16_t len);		//unpack（point cloud）
+			void PointDataAnalysis(const Nvilidar_PointViewerPackageInfoTypeDef &data);	
+			LidarModelListEnumTypeDef GetLidarModelName(Nvilidar_DeviceInfo info);			//get lidar model name  
+			bool LidarSetDevicePara(Nvilidar_UserConfigTypeDef &cfg, Nvilidar_StoreConfigTypeDef &store_para_read);	//set lidar para 
+			void LidarApplySdkPara();		//change sdk para between 2 circles 
+			bool LidarReopen();				//reopen the port only,for reconnect 
+			
+			//thread  
+			bool createThread();		//create thread 
+			void closeThread();			//stop the thread and wait for it 
+			void setCircleResponseUnlock();	//unlock point data 
+			bool LidarReadData();			//read the port once and unpack,false:no data 
+			void LidarReaderLoop();			//own reader thread,blocking read or busy poll 
+			void LidarApplyReadMode();		//port mode of the read mode 
+			void LidarApplySerialTuning(bool scanning);	//vmin while scanning only 
+			void LidarCheckSerialTuning();	//warn about the settings the port does not take 
+			void LidarFeedData(const uint8_t *buf, size_t len);	//unpack the received bytes 
+			void LidarPollTimer();			//command timeout,stall check and reopen 
+			void LidarSamplingData(const CircleDataInfoTypeDef &info, LidarScan &outscan);		//interface for lidar point data 
+			void LidarPutCircle();			//closed circle to circle_ready(circle lock held) 
+			void LidarTakeCircle();			//circle_ready to circle_taken(circle lock held) 
+
+			//----------------------serialport---------------------------
+
+			nvilidar_serial::Nvilidar_Serial serialport;
+
+			//----------------------value ----------------------------
+			Nvilidar_UserConfigTypeDef     lidar_cfg;				//lidar config data 
+			CircleDataInfoTypeDef		   circleDataInfo;			//lida circle data(reader thread) 
+			CircleDataInfoTypeDef		   circle_ready;			//closed circle not taken yet(circle lock) 
+			CircleDataInfoTypeDef		   circle_taken;			//circle of LidarSamplingProcess,filtered out of the lock 
+			uint64_t	circle_taken_us = 0;				//close time of circle_taken 
+			LidarCommandEngine			   command_engine;			//command/response engine 
+			Nvilidar_StoreConfigTypeDef	   lidar_store_para;		//para stored in lidar 
+			Nvilidar_UserConfigTypeDef     cfg_pending;				//para wait for next circle 
+			bool		cfg_pending_flag = false;			//has para wait for next circle 
+			Nvilidar_UserConfigTypeDef     cfg_pending_lidar;		//para set to the lidar,wait for next circle 
+			bool		cfg_pending_lidar_flag = false;		//has lidar para wait for next circle 
+			std::mutex	cfg_mutex;							//para lock 
+			LidarLinkSupervisor	link_supervisor;		//stall check and reconnect 
+			std::mutex	link_mutex;							//port lock,for reopen 
+
+			uint32_t    m_0cIndex = 0;                  //0 index
+			int32_t     m_last0cIndex = 0;              //0 index
+			uint32_t    m_differ0cIndex = 0;            //0 index
+			bool        m_first_circle_finish = false;  //first circle finish,case calc fault
+			uint64_t	m_run_circles = 0;				//has send data   
+			float		m_last_pack_angle = -1.0f;		//last point angle of the last package(-1:none)
+			uint32_t	m_circle_gap_count = 0;			//angle gaps of current circle 
+			uint32_t	m_circle_missing_packages = 0;	//lost packages of current circle 
+			uint32_t	m_circle_missing_points = 0;	//lost points of current circle 
+			LidarMetrics	metrics;						//runtime statistics 
+			std::atomic<bool>	m_circle_pending{false};	//circle not taken by LidarSamplingProcess 
+			std::atomic<bool>	m_has_sensitive{false};		//intensity in the packages,read by the reader 
+			std::atomic<float>	m_aim_speed{0.0f};			//aim speed(Hz) for the stall check of StartScan 
+			uint64_t	m_circle_ready_us = 0;			//circle close time 
+			uint64_t	m_last_circle_us = 0;			//last circle close time 
+			uint64_t	m_last_pack_us = 0;				//last valid package time(0:none)
+			uint32_t	m_circle_packages = 0;			//valid packages of current circle 
+			uint64_t	m_read_us = 0;					//last read time 
+			uint64_t	m_pack_read_us = 0;				//read time of the current package header 
+			LidarLatencyWindow	latency_window;			//rolling scan latency 
+			LidarHealthMonitor	health_monitor;			//speed/temperature of the package header 
+			LidarFilter	lidar_filter;					//filter para of this lidar 
+
+			//---------------------unpack state(per lidar)---------------------------
+			uint8_t		m_normal_crc = 0;					//CRC 
+			uint16_t	m_normal_recvPos = 0;				//current locate 
+			Nvilidar_Protocol_NormalResponseData	m_normalResponseData = {};	//response 
+			Nvilidar_PointViewerPackageInfoTypeDef	m_pack_info = {};			//package info 
+			uint16_t	m_checksum_temp = 0;				//checksum for 2byte 
+			uint32_t	m_package_after_0c_index = 0;		//package index after the 0 angle package 
+			uint16_t	m_checksum_packnum_index = 0;		//checksum of package number and 0 index 
+			int			m_recvPos = 0;						//current locate 
+			size_t		m_remain_size = 0;					//bytes after the package header 
+			uint8_t		m_raw_buf[sizeof(Nvilidar_PackageBufTypeDef)];	//all bytes of current package 
+			size_t		m_raw_len = 0;
+			bool		m_raw_rescan = false;				//current package start from the rescan bytes 
+			LidarCircleBuffer	m_point_list;				//points of current circle 
+			int			m_curr_circle_count = 0;
+			uint8_t		m_recv_data[8192];					//read buffer 
+
+			//---------------------hub---------------------------
+			LidarHub	*io_hub = NULL;						//NULL:own thread 
+			int			io_hub_id = -1;
+			uint32_t	m_port_open_id = 0;					//changed by every open,the fd number may be reused 
+			LidarPortDiscovery	*port_discovery = NULL;		//NULL:no hotplug event 
+			int			port_discovery_id = -1;
+
+			//---------------------thread---------------------------
+			LidarThreadPara		thread_para = {};		//applied in the own thread 
+			nvilidar_serial::SerialTuning	serial_tuning = {false, 0, 0, 0, -1};	//set to the port by every open 
+			std::atomic<bool>	m_thread_stop{false};	//cooperative stop of the own thread 
+			#if defined(_WIN32)
+				HANDLE  _thread = NULL;
+				HANDLE  _event_circle = NULL;
+				std::mutex	_mutex_circle;					//circle_ready lock 			
+
+				DWORD static WINAPI periodThread(LPVOID lpParameter);		//thread  
+			#else 
+				pthread_t _thread = -1;
+				pthread_cond_t _cond_point;
+				pthread_mutex_t _mutex_point;
+				static void *periodThread(void *lpParameter) ;
+			#endif
+    };
+}
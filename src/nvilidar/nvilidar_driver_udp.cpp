@@ -1,1980 +1,2292 @@
-#include "nvilidar_driver_udp.h"
-#include "socket/nvilidar_socket.h"
-#include <list>
-#include <string>
-#include "myconsole.h"
-#include "mytimer.h"
-#include "mystring.h"
-
-namespace nvilidar
-{
-	LidarDriverUDP::LidarDriverUDP(){
-		lidar_state.m_CommOpen = false;       
-		lidar_state.m_Scanning = false;        
-	}
-
-	LidarDriverUDP::~LidarDriverUDP(){
-	}
-
-	//load para  
-	void LidarDriverUDP::LidarLoadConfig(Nvilidar_UserConfigTypeDef cfg){
-		lidar_cfg = cfg; 
-		LidarFilter::instance()->LidarFilterLoadPara(cfg.filter_para);                  
-	}
-
-	//Lidar connected or not
-	bool LidarDriverUDP::LidarIsConnected(){
-		if (lidar_state.m_CommOpen)
-		{
-			return true;
-		}
-		return false;
-	}
-
-	//lidar init 
-	bool LidarDriverUDP::LidarInitialialize()
-	{
-		Nvilidar_StoreConfigTypeDef store_para_read;		
-		bool save_flag = false;								
-
-		//para is valid?
-		if ((lidar_cfg.ip_addr.length() == 0) || (lidar_cfg.lidar_udp_port == 0))
-		{
-			return false;		//网络参数信息不合法 
-		}
-
-		//start connect udp server  
-		if (!LidarConnect(lidar_cfg.ip_addr, lidar_cfg.lidar_udp_port))
-		{
-			nvilidar::console.error("Error initializing NVILIDAR scanner.");
-			return false;		//serialport connect fail 
-		}
-
-		//send stop cmd 
-		StopScan();
-		//sleep 
-		delayMS(300);
-		//create thread to read serialport data   
-		createThread();		
-		
-		//get lidar infomation 
-		if (false == GetDeviceInfo(lidar_cfg.deviceInfo))
-		{
-			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Device Info.");
-			return false;
-		}
-		lidar_cfg.lidar_model_name = GetLidarModelName(lidar_cfg.deviceInfo);
-		if(lidar_cfg.lidar_model_name == NVILIDAR_Unknow)
-		{
-			nvilidar::console.error("current lidar is not support!\n");
-			return false;
-		}
-		nvilidar::console.show("\nlidar device info:");
-		nvilidar::console.show("lidar name:%s", lidar_cfg.deviceInfo.m_ProductName.c_str());
-		nvilidar::console.show("lidar soft version:%s", lidar_cfg.deviceInfo.m_SoftVer.c_str());
-		nvilidar::console.show("lidar hard version:%s", lidar_cfg.deviceInfo.m_HardVer.c_str());
-		nvilidar::console.show("lidar serialnumber:%s", lidar_cfg.deviceInfo.m_SerialNum.c_str());
-
-		//get lidar config para 
-		if (false == GetLidarCfg(store_para_read))
-		{
-			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Config Info.");
-			return false;
-		}
-		//get lidar angle offset 
-		if(false == GetZeroOffsetAngle(store_para_read.angleOffset)){
-			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Angle Offset.");
-			return false;
-		}
-		if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
-			//get lidar quality filter value 
-			if(false == GetFilterQualityThreshold(store_para_read.qualityFilterThreshold)){
-				nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Quality Filter Threshod.");
-			}
-		}
-
-#if 1
-		bool isNeedSetPara = false;
-		bool isSetOK = true;
-		//is same? 
-		if (lidar_cfg.storePara.samplingRate != store_para_read.samplingRate){
-			isNeedSetPara = true;
-			if (!SetSamplingRate(lidar_cfg.storePara.samplingRate, store_para_read.samplingRate)){
-				isSetOK = false;
-			}
-		}
-		if (lidar_cfg.storePara.aimSpeed != store_para_read.aimSpeed){
-			isNeedSetPara = true;
-			if (!SetScanMotorSpeed(lidar_cfg.storePara.aimSpeed, store_para_read.aimSpeed)){
-				isSetOK = false;
-			}
-		}
-		if (lidar_cfg.storePara.isHasSensitive != store_para_read.isHasSensitive){
-			isNeedSetPara = true;
-			if(!SetIntensities(lidar_cfg.storePara.isHasSensitive)){
-				isSetOK = false;
-			}
-			store_para_read.isHasSensitive = lidar_cfg.storePara.isHasSensitive;
-		}
-		if (lidar_cfg.storePara.tailingLevel != store_para_read.tailingLevel){
-			isNeedSetPara = true;
-			if (!SetTrailingLevel(lidar_cfg.storePara.tailingLevel, store_para_read.tailingLevel)){
-				isSetOK = false;
-			}
-		}
-		if(true == lidar_cfg.angle_offset_change_flag){			//angle offset 
-			if (lidar_cfg.storePara.angleOffset != store_para_read.angleOffset){
-				isNeedSetPara = true;
-				if(!SetZeroOffsetAngle(lidar_cfg.storePara.angleOffset, store_para_read.angleOffset)){
-					isSetOK = true;
-				}
-			}
-		}
-		if (true == lidar_cfg.apd_change_flag){					//apd value 				
-			if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
-				if (lidar_cfg.storePara.apdValue != store_para_read.apdValue){
-					isNeedSetPara = true;
-					if (!SetApdValue(lidar_cfg.storePara.apdValue, store_para_read.apdValue)){
-						isSetOK = false;
-					}
-				}
-			}
-		}
-		if(true == lidar_cfg.quality_threshold_change_flag){		//quality threshold 
-			if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
-				if(lidar_cfg.storePara.qualityFilterThreshold != store_para_read.qualityFilterThreshold){
-					isNeedSetPara = true;
-					if(!SetFilterQualityThreshold(lidar_cfg.storePara.qualityFilterThreshold,store_para_read.qualityFilterThreshold)){
-						isSetOK = false;
-					}
-				}
-			}
-		}
-		if (isNeedSetPara)
-		{
-			if (isSetOK){
-				SaveCfg(save_flag);
-				if(save_flag){
-					nvilidar::console.show("NVILIDAR set para OK!");
-				}
-				else {
-					nvilidar::console.show("NVILIDAR set para Fail!");
-				}
-			}
-			else{
-				nvilidar::console.warning("NVILIDAR set para Fail!");
-			}
-		}
-#endif
-
-		//打印配置信息
-		nvilidar::console.show("\nlidar config info:");
-		nvilidar::console.show("lidar samplerate :%d", store_para_read.samplingRate);
-		nvilidar::console.show("lidar frequency :%d.%02d", store_para_read.aimSpeed/100, store_para_read.aimSpeed%100);
-		nvilidar::console.show("lidar sesitive :%s", store_para_read.isHasSensitive ? "yes" : "no");
-		nvilidar::console.show("lidar tailling filter level :%d", store_para_read.tailingLevel);
-		nvilidar::console.show("lidar angle offset :%.2f",(double)store_para_read.angleOffset/64.0);
-		if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
-			nvilidar::console.show("lidar apd value :%d",store_para_read.apdValue);
-			nvilidar::console.show("lidar quality filter threshold :%d\n",store_para_read.qualityFilterThreshold);
-		}
-
-		return true;
-	}
-
-	//lidar start  
-	bool LidarDriverUDP::LidarTurnOn()
-	{
-		if (!StartScan())
-		{
-			StopScan();
-
-			nvilidar::console.error("[CNviLidar] Failed to start scan");
-
-			return false;
-		}
-
-		m_run_circles = 0;
-		//success 
-		nvilidar::console.message("[NVILIDAR INFO] Now NVILIDAR is scanning ......");
-
-		return true;
-	}
-
-	//lidar stop 
-	bool LidarDriverUDP::LidarTurnOff()
-	{
-		//stop 
-		StopScan();
-
-		m_run_circles = 0;
-
-		return true;
-	}
-
-	bool LidarDriverUDP::LidarCloseHandle()
-	{
-		LidarDisconnect();
-		return true;
-	}
-
-	//---------------------------------------private---------------------------------
-
-	//lidar start 
-	bool LidarDriverUDP::StartScan()
-	{
-		//serialport state 
-		if (!lidar_state.m_CommOpen)
-		{
-			return false;
-		}
-		//is running 
-		if (lidar_state.m_Scanning)
-		{
-			return true;
-		}
-
-		//first circle false
-		m_first_circle_finish = false;
-
-		//send data 
-		if (!SendCommand(NVILIDAR_CMD_SCAN))
-		{
-			return false;
-		}
-
-		lidar_state.m_Scanning = true;
-
-		return true;
-	}
-
-	//lidar stop 
-	bool  LidarDriverUDP::StopScan()
-	{
-		//lidar is scanning 
-		lidar_state.m_Scanning = false;
-
-		//发送数据
-		//send data 
-		SendCommand(NVILIDAR_CMD_STOP);
-
-		return true;
-	}
-
-	//启动雷达串口
-	bool LidarDriverUDP::LidarConnect(std::string ip_addr, uint16_t port)
-	{ 
-		socket_udp.udpInit(ip_addr.c_str(),port);
-		
-		if (socket_udp.isudpOpen())
-		{
-			lidar_state.m_CommOpen = true;
-			return true;
-		}
-		else
-		{
-			lidar_state.m_CommOpen = false;
-
-			return false;
-		}
-		return false;
-	}
-
-	//close serialport 
-	void LidarDriverUDP::LidarDisconnect()
-	{
-		lidar_state.m_CommOpen = false;
-		socket_udp.udpClose();
-	}
-
-	//send serial 
-	bool LidarDriverUDP::SendUDP(const uint8_t *data, size_t size)
-	{
-		if (!lidar_state.m_CommOpen)
-		{
-			return false;
-		}
-
-		if (data == NULL || size == 0)
-		{
-			return false;
-		}
-
-		
-		//write data   
-		size_t r;
-		while (size) 
-		{
-			r = socket_udp.udpWriteData(data,size);
-			if (r < 1) 
-			{
-				return false;
-			}
-
-			size -= r;
-			data += r;
-		}
-
-		return true;
-	}
-
-	//雷达发送数据
-	//send data 
-	bool LidarDriverUDP::SendCommand(uint8_t cmd, uint8_t *payload, uint16_t payloadsize)
-	{
-		static uint8_t temp_buf[1024];
-		uint8_t checksum = 0;
-
-		//serialport not open 
-		if (!lidar_state.m_CommOpen)
-		{
-			return false;
-		}
-
-		if ((payload != nullptr) && (payloadsize > 0))   //command long or short 
-		{
-			temp_buf[0] = NVILIDAR_START_BYTE_LONG_CMD;
-			temp_buf[1] = cmd;
-			temp_buf[2] = (uint8_t)(payloadsize & 0xFF);
-			temp_buf[3] = (uint8_t)(payloadsize >> 8);
-
-			for(int i = 0; i<payloadsize; i++){
-				temp_buf[4+i] = payload[i];
-				checksum ^= payload[i];
-			}
-			temp_buf[4+payloadsize] = checksum;
-			temp_buf[5+payloadsize] = NVILIDAR_END_CMD;
-
-			SendUDP(temp_buf,6+payloadsize);
-		}
-		else
-		{
-			//short command 
-			temp_buf[0] = NVILIDAR_START_BYTE_SHORT_CMD;
-			temp_buf[1] = cmd;
-			
-			SendUDP(temp_buf, 2);
-		}
-
-		return true;
-	}
-
-	//normal data unpack 
-	void LidarDriverUDP::NormalDataUnpack(uint8_t *buf, uint16_t len)
-	{
-		static uint8_t   crc = 0;												//CRC校验值 
-		static uint16_t  normal_recvPos = 0;									//当前接到的位置信息
-		static Nvilidar_Protocol_NormalResponseData		normalResponseData;		//常规数据应答
-
-		for (int j = 0; j < len; j++)
-		{
-			uint8_t byte = buf[j];
-
-			switch (normal_recvPos)
-			{
-				case 0:		//first byte 
-				{
-					if (byte == NVILIDAR_START_BYTE_LONG_CMD)
-					{
-						normal_recvPos++;
-						break;
-					}
-					else
-					{
-						break;
-					}
-				}
-				case 1:		//second byte   
-				{
-					if (
-							(byte == NVILIDAR_CMD_GET_DEVICE_INFO) ||
-							(byte == NVILIDAR_CMD_GET_LIDAR_CFG) ||
-							(byte == NVILIDAR_CMD_SET_HAVE_INTENSITIES) ||
-							(byte == NVILIDAR_CMD_SET_NO_INTENSITIES) ||
-							(byte == NVILIDAR_CMD_SET_AIMSPEED) ||
-							(byte == NVILIDAR_CMD_SET_SAMPLING_RATE) ||
-							(byte == NVILIDAR_CMD_SET_TAILING_LEVEL) ||
-							(byte == NVILIDAR_CMD_SAVE_LIDAR_PARA) ||
-							(byte == NVILIDAR_CMD_GET_ANGLE_OFFSET) ||
-							(byte == NVILIDAR_CMD_SET_ANGLE_OFFSET) ||
-							(byte == NVILIDAR_CMD_GET_QUALITY_THRESHOLD) ||
-							(byte == NVILIDAR_CMD_SET_QUALITY_THRESHOLD) ||
-							(byte == NVILIDAR_CMD_SET_APD_VALUE)
-						)
-					{
-						normalResponseData.cmd = byte;
-						normal_recvPos++;
-					}
-					else
-					{
-						normalResponseData.cmd = 0;
-						normal_recvPos=0;
-					}
-					break;
-				}
-				case 2:		//third byte   
-				{
-					normalResponseData.length = byte;
-					normal_recvPos++;
-					break;
-				}
-				case 3:		
-				{
-					normalResponseData.length += byte * 256;
-					normal_recvPos++;
-					break;
-				}
-				default:	
-				{
-					if (normal_recvPos < normalResponseData.length + sizeof(Nvilidar_ProtocolHeader))			  
-					{
-						if (normal_recvPos >= sizeof(Nvilidar_ProtocolHeader))
-						{
-							if (normal_recvPos - sizeof(Nvilidar_ProtocolHeader) < 1024)
-							{
-								crc ^= byte;
-								normalResponseData.dataInfo[normal_recvPos - sizeof(Nvilidar_ProtocolHeader)] = byte;
-							}
-							else
-							{
-								crc = 0;
-								normal_recvPos = 0;
-								memset((char *)&normalResponseData, 0x00, sizeof(normalResponseData));
-							}
-						}
-						else
-						{
-							crc = 0;
-							normal_recvPos = 0;
-							memset((char *)&normalResponseData,0x00,sizeof(normalResponseData));
-						}
-
-						normal_recvPos++;
-					}
-					else if (normal_recvPos == normalResponseData.length + sizeof(Nvilidar_ProtocolHeader))	//校验  
-					{
-						if (byte != crc)
-						{
-							normal_recvPos = 0;
-							break;
-						}
-
-						normal_recvPos++;
-					}
-					else if (normal_recvPos == normalResponseData.length + sizeof(Nvilidar_ProtocolHeader) + 1)
-					{
-						if (byte != NVILIDAR_END_CMD)
-						{
-							normalResponseData.length = 0;
-							normalResponseData.cmd = 0;
-							crc = 0;
-							normal_recvPos = 0;
-							break;
-						}
-
-						//data analysis 
-						NormalDataAnalysis(normalResponseData);
-
-						//value recovery  
-						normalResponseData.length = 0;
-						normalResponseData.cmd = 0;
-						crc = 0;
-						normal_recvPos = 0;
-					}
-
-					break;
-				}
-			}
-		}
-	}
-
-	//协议解析  
-	void LidarDriverUDP::NormalDataAnalysis(Nvilidar_Protocol_NormalResponseData data)
-	{
-		switch (data.cmd)
-		{
-			case NVILIDAR_CMD_GET_DEVICE_INFO:		//获取设备信息 
-			{
-				if (data.length != sizeof(recv_info.lidar_device_info))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.lidar_device_info), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_GET_LIDAR_CFG:		//获取雷达部分参数信息 
-			{
-				if (data.length != sizeof(recv_info.lidar_get_para))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.lidar_get_para), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SET_HAVE_INTENSITIES:	//信号质量
-			case NVILIDAR_CMD_SET_NO_INTENSITIES:
-			{
-				if (data.length != sizeof(recv_info.isHasSensitive))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.isHasSensitive), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SET_AIMSPEED:		//目标转速
-			{
-				if (data.length != sizeof(recv_info.aimSpeed))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.aimSpeed), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SET_SAMPLING_RATE:	//采样率 
-			{
-				if (data.length != sizeof(recv_info.samplingRate))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.samplingRate), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SET_TAILING_LEVEL:	//写拖尾 
-			{
-				//printf("tail recv:\r\n");
-				if (data.length != sizeof(recv_info.tailingLevel))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.tailingLevel), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SET_APD_VALUE:	//设置apd值  
-			{
-				if (data.length != sizeof(recv_info.apdValue))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.apdValue), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//设置event失效 
-				setNormalResponseUnlock();				//解锁 
-
-				break;
-			}
-			case NVILIDAR_CMD_SAVE_LIDAR_PARA:	//write finish   
-			{
-				if(data.length != sizeof(recv_info.saveFlag))
-				{
-					break;
-				}
-				memcpy((char *)(&recv_info.saveFlag), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//recv finish   
-
-				//unlock 
-				setNormalResponseUnlock();				
-
-				break;
-			}
-			case NVILIDAR_CMD_GET_ANGLE_OFFSET:	//read angle offset  
-			case NVILIDAR_CMD_SET_ANGLE_OFFSET:	//write angle offset  
-			{
-				if (data.length != sizeof(recv_info.angleOffset))
-				{
-					break;
-				}
-
-				memcpy((char *)(&recv_info.angleOffset), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		//接收成功 
-
-				//unlock 
-				setNormalResponseUnlock();				
-
-				break;
-			}
-			case NVILIDAR_CMD_GET_QUALITY_THRESHOLD:  	//get the quality filter value
-			case NVILIDAR_CMD_SET_QUALITY_THRESHOLD:{	//set the quality filter value 
-				if (data.length != sizeof(recv_info.qualityFilter)){
-					break;
-				}
-
-				memcpy((char *)(&recv_info.qualityFilter), data.dataInfo, data.length);
-				recv_info.recvFinishFlag = true;		
-
-				//unlock 
-				setNormalResponseUnlock();		
-
-				break;
-			}
-			default:
-			{
-				break;
-			}
-		}
-	}
-
-	//点云数据解包 
-	bool LidarDriverUDP::PointDataUnpack(uint8_t *buf,uint16_t len)
-	{
-		static Nvilidar_PointViewerPackageInfoTypeDef  pack_info;        //包信息
-
-		static  uint16_t   checksum_temp = 0; 					//校验计算 for 2byte
-		static uint32_t    package_after_0c_index = 0;          //0度后的第几包
-		static uint16_t    checksum_packnum_index = 0;     		//包数目和0位索引校验
-
-		static int         recvPos = 0;							//当前接到的位置信息
-		static size_t      remain_size = 0;						//接完包头剩下来的数据信息 
-
-		//循环 
-		for (int j = 0; j < len; j++)
-		{
-			uint8_t byte = buf[j];
-
-			switch (recvPos)
-			{
-				case 0:     //第一个字节 包头
-				{
-					if (byte == (uint8_t)(NVILIDAR_POINT_HEADER & 0xFF))
-					{
-						recvPos++;      //index后移
-						//printf("get first head\n");
-					}
-					else        //没收到 直接发下一包
-					{
-						break;
-					}
-					break;
-				}
-				case 1:     //第二字节  包头信息
-				{
-					if (byte == (uint8_t)(NVILIDAR_POINT_HEADER >> 8))
-					{
-						pack_info.packageCheckSumCalc = NVILIDAR_POINT_HEADER; //更新校验值
-						recvPos++;      //index后移
-						//printf("get second head\n");
-					}
-					else
-					{
-						pack_info.packageErrFlag = true;      //包头错误鸟
-						recvPos = 0;
-					}
-					break;
-				}
-				case 2:     //频率或温度等信息
-				{
-					checksum_temp = byte;     //校验赋值
-
-					//0度角或其它信息
-					if (1 == package_after_0c_index)  //其它  0位后第1包为  温度值
-					{
-						pack_info.packageHas0CFirst = false;
-						pack_info.packageHasTempFirst = true;
-					}
-					else if (byte & 0x01)     //最低位是0位
-					{
-						pack_info.packageHas0CFirst = true;
-						pack_info.packageHasTempFirst = false;
-					}
-					else        //其它情况  该位置不含其它信息
-					{
-						pack_info.packageHas0CFirst = false;
-						pack_info.packageHasTempFirst = false;
-					}
-					recvPos++;      //index后移
-					break;
-				}
-				case 3:         //频率或者温度
-				{
-					checksum_temp += (byte * 256);     //校验计算
-					pack_info.packageCheckSumCalc ^= checksum_temp; //校验计算
-
-
-					if (pack_info.packageHas0CFirst)  //可能有0度
-					{
-						pack_info.packageHas0CFirst = false;
-						pack_info.packageHasTemp = false;
-
-						if (byte & 0x80)
-						{
-
-							package_after_0c_index = 0;     //0位包  则将0度后的个数  清0
-
-							pack_info.packageHas0CAngle = true;
-							checksum_temp += ((uint16_t)byte * 256);
-							pack_info.packageFreq = (checksum_temp & 0x7FFF) >> 1;
-						}
-						else
-						{
-							pack_info.packageHas0CAngle = false;
-						}
-					}
-					else if (pack_info.packageHasTempFirst)    //是温度计算信息
-					{
-
-						pack_info.packageHasTempFirst = false;
-
-						pack_info.packageHas0CAngle = false;
-
-
-						pack_info.packageHasTemp = true;
-						checksum_temp += ((uint16_t)byte * 256);
-						pack_info.packageTemp = (int16_t)(checksum_temp);
-					}
-					else
-					{
-
-						pack_info.packageHas0CAngle = false;
-						pack_info.packageHasTemp = false;
-					}
-					package_after_0c_index++;     //0度后的包数目
-
-					recvPos++;      //index后移
-					break;
-				}
-				case 4:     //包数目
-				{
-					checksum_packnum_index = byte;
-
-					if (byte != 0)
-					{
-						pack_info.packagePointNum = byte;
-						recvPos++;      //index后移
-					}
-					else
-					{
-						pack_info.packagePointNum = 0;
-						pack_info.packageErrFlag = true;      //包头错误鸟
-						recvPos = 0;
-					}
-					break;
-				}
-				case 5:     //0度索引
-				{
-					checksum_packnum_index += (uint16_t)byte * 256;
-					pack_info.packageCheckSumCalc ^= checksum_packnum_index; //校验计算
-
-					if (pack_info.packageHas0CAngle)       //如果是0c  则会告知0c index
-					{
-						if (byte > 0)
-						{
-							pack_info.package0CIndex = byte - 1;      //0度角
-						}
-						else
-						{
-							pack_info.package0CIndex = 0;
-						}
-						//printf("0c index:%d\r\n",packageInfo.package0CIndex);
-					}
-
-
-					recvPos++;
-					break;
-				}
-				case 6:             //起始角度低位
-				{
-					if (byte & NVILIDAR_RESP_MEASUREMENT_CHECKBIT)
-					{
-						checksum_temp = byte;
-						recvPos++;      //index后移
-					}
-					else
-					{
-						pack_info.packageErrFlag = true;
-						recvPos = 0;
-					}
-					break;
-				}
-				case 7:             //起始角度高位
-				{
-					checksum_temp += (uint16_t)byte * 256;
-					pack_info.packageCheckSumCalc ^= checksum_temp;
-					pack_info.packageFirstAngle = checksum_temp >> 1;
-
-					//printf("first angle = %f\n",(float)pointViewerPackageInfo.packageFirstAngle/64.0f);
-
-					recvPos++;      //index后移
-					break;
-				}
-				case 8:             //结束角低位
-				{
-					if (byte & NVILIDAR_RESP_MEASUREMENT_CHECKBIT)
-					{
-						checksum_temp = byte;
-
-						//  printf("last_angle_l = %d\n",package_last_angle_temp);
-
-						recvPos++;      //index后移
-					}
-					else
-					{
-						pack_info.packageErrFlag = true;
-						recvPos = 0;
-					}
-					break;
-				}
-				case 9:             //结束角高位
-				{
-					checksum_temp += (uint16_t)byte * 0x100;
-					pack_info.packageCheckSumCalc ^= checksum_temp;
-					pack_info.packageLastAngle = checksum_temp >> 1;
-
-					//printf("last angle = %f\n",(float)packageInfo.packageLastAngle/64.0f);
-
-					//计算每个角度之间的差值信息
-					if (1 == pack_info.packagePointNum)  //只有一个点  则没有差值
-					{
-						pack_info.packageAngleDiffer = 0;
-					}
-					else
-					{
-						//结束角小于起始角
-						if (pack_info.packageLastAngle < pack_info.packageFirstAngle)
-						{
-							//270~90度
-							if ((pack_info.packageFirstAngle > 270 * NVILIDAR_ANGULDAR_RESOLUTION) && (pack_info.packageLastAngle < 90 * NVILIDAR_ANGULDAR_RESOLUTION))
-							{
-								pack_info.packageAngleDiffer =
-									(float)((float)(360 * NVILIDAR_ANGULDAR_RESOLUTION + pack_info.packageLastAngle - pack_info.packageFirstAngle) /
-									((float)(pack_info.packagePointNum - 1)));
-								pack_info.packageLastAngleDiffer = pack_info.packageAngleDiffer;
-							}
-							else
-							{
-								pack_info.packageAngleDiffer = pack_info.packageLastAngleDiffer;
-							}
-						}
-						//结束角大于等于起始角
-						else
-						{
-							pack_info.packageAngleDiffer =
-								(float)((float)(pack_info.packageLastAngle - pack_info.packageFirstAngle) /
-								(float)(pack_info.packagePointNum - 1));
-							pack_info.packageLastAngleDiffer = pack_info.packageAngleDiffer;
-						}
-					}
-
-					recvPos++;      //index后移
-
-					break;
-				}
-				case 10:    //校验低位
-				{
-					pack_info.packageCheckSumGet = byte;
-
-					recvPos++;      //index后移
-					break;
-				}
-				case 11:     //校验高位
-				{
-					pack_info.packageCheckSumGet += byte * 256;
-
-					//计算基本信息 
-					if (lidar_cfg.storePara.isHasSensitive)
-					{
-						pack_info.packagePointDistSize = 4;
-					}
-					else
-					{
-						pack_info.packagePointDistSize = 2;
-					}
-					remain_size = pack_info.packagePointNum * pack_info.packagePointDistSize; //剩余的距离数据信息
-
-
-					recvPos++;      //index后移
-
-					break;
-				}
-				default:
-				{
-					pack_info.packageBuffer.buf[recvPos] = byte;
-					recvPos++;
-
-					//所有数据接完了 
-					if (recvPos == NVILIDAR_POINT_PACKAGE_HEAD_SIZE + remain_size)
-					{
-						uint16_t checksum_temp = 0;
-						//计算校验
-						for (size_t j = 0; j < remain_size; j++)
-						{
-							if (j % 2 == 0)
-							{
-								checksum_temp = pack_info.packageBuffer.buf[NVILIDAR_POINT_PACKAGE_HEAD_SIZE + j];  //低位
-							}
-							else
-							{
-								checksum_temp += (uint16_t)(pack_info.packageBuffer.buf[NVILIDAR_POINT_PACKAGE_HEAD_SIZE + j]) * 256;
-								pack_info.packageCheckSumCalc ^= checksum_temp;
-							}
-						}
-						//判断校验  
-						if (pack_info.packageCheckSumCalc == pack_info.packageCheckSumGet)
-						{
-							//获取时间戳 起始&结束 (包尾时间 非真实时间) 
-							if (pack_info.packageHas0CAngle)
-							{
-								pack_info.packageStamp = getStamp();
-							}
-							//计算一圈点的数据信息 
-							PointDataAnalysis(pack_info);
-						}
-						//清空所有数据  
-						memset((uint8_t *)(&pack_info), 0x00, sizeof(Nvilidar_PointViewerPackageInfoTypeDef));
-						checksum_temp = 0;        				//临时校验信息 
-						checksum_packnum_index = 0;     		//包数目和0位索引校验
-						recvPos = 0;                    //当前接到的位置信息
-						remain_size = 0;			//接完包头剩下来的数据信息 
-					}
-					break;
-				}
-			}
-		}
-		return false;
-	}
-
-	//点云数据解包 
-	void LidarDriverUDP::PointDataAnalysis(Nvilidar_PointViewerPackageInfoTypeDef pack_point)
-	{
-		//点集信息 
-		static std::vector<Nvilidar_Node_Info> point_list;
-		static int curr_circle_count = 0;
-		static int curr_pack_count = 0;
-
-		//计算数据信息 
-		for (int i = 0; i < pack_point.packagePointNum; i++)
-		{
-			Nvilidar_Node_Info node;
-
-			if (lidar_cfg.storePara.isHasSensitive)
-			{
-				//点信息更新
-				node.lidar_distance = pack_point.packageBuffer.pack_qua.package_Sample[i].PakageSampleDistance;     //距离
-				node.lidar_quality = pack_point.packageBuffer.pack_qua.package_Sample[i].PakageSampleQuality;       //信号质量
-				node.lidar_speed = (float)(pack_point.packageFreq) / 100.0;  //转速
-				node.lidar_temper = (float)(pack_point.packageTemp) / 10.0;      //温度
-				node.lidar_point_time = pack_point.packagePointTime;           //采样率
-				node.lidar_index = i;                 //当前索引
-				//是0度角
-				if (pack_point.packageHas0CAngle)
-				{
-					if (i == pack_point.package0CIndex)
-					{
-						//printf("circle_count:%d\r\n", curr_pack_count);
-						node.lidar_angle_zero_flag = true;
-						curr_pack_count = 0;
-					}
-					else
-					{
-						curr_pack_count++;
-						node.lidar_angle_zero_flag = false;
-					}
-				}
-				else
-				{
-					curr_pack_count++;
-					node.lidar_angle_zero_flag = false;
-				}
-
-				//角度计算
-				node.lidar_angle = (float)(pack_point.packageFirstAngle + i * pack_point.packageAngleDiffer)
-					/ (float)(NVILIDAR_ANGULDAR_RESOLUTION);
-				if(node.lidar_angle >= 360.0)
-				{
-					node.lidar_angle -= 360.0;
-				}
-			}
-			else
-			{
-				//点信息更新
-				node.lidar_distance = pack_point.packageBuffer.pack_no_qua.package_Sample[i].PakageSampleDistance;     //距离
-				node.lidar_quality = 0;
-				node.lidar_speed = (float)(pack_point.packageFreq) / 100.0;  	//转速
-				node.lidar_temper = (float)(pack_point.packageTemp) / 10.0;     //温度
-				node.lidar_point_time = pack_point.packagePointTime;           	//采样率
-				node.lidar_index = i;                 //当前索引
-				//是0度角
-				if (pack_point.packageHas0CAngle)
-				{
-					if (i == pack_point.package0CIndex)
-					{
-						node.lidar_angle_zero_flag = true;
-						curr_pack_count = 0;
-					}
-					else
-					{
-						node.lidar_angle_zero_flag = false;
-						curr_pack_count++;
-					}
-				}
-				else
-				{
-					node.lidar_angle_zero_flag = false;
-					curr_pack_count++; 
-				}
-
-				//角度计算
-				node.lidar_angle = (float)(pack_point.packageFirstAngle + i * pack_point.packageAngleDiffer)
-					/ (float)(NVILIDAR_ANGULDAR_RESOLUTION);
-				if (node.lidar_angle >= 360.0)
-				{
-					node.lidar_angle -= 360.0;
-				}
-			}
-
-			//追加到数据区内 
-			if(node.lidar_angle_zero_flag)
-			{
-				curr_circle_count = point_list.size();		//取到一圈的真实的点数信息 
-			}
-			point_list.push_back(node);
-		}
-
-		//找到点数信息 
-		if(pack_point.packageHas0CAngle)
-		{
-			uint32_t  all_pack_time;
-			uint32_t  all_count = 0;
-			uint32_t  circle_count = 0;
-			uint64_t  stamp_temp = 0;
-			uint64_t  stamp_differ = 0;
-
-			m_run_circles++;		//包数目++ 
-
-			circleDataInfo.lidarCircleNodePoints = point_list;	//上个零位包开始到本包结束了（到结尾，用来算真实时间戳）
-			all_count = point_list.size();
-			circle_count = curr_circle_count;
-
-			circleDataInfo.lidarCircleNodePoints.assign(point_list.begin(),point_list.begin() + curr_circle_count);		//取前半部分的值 	
-			point_list.erase(point_list.begin(),point_list.begin() + curr_circle_count);			//后半部分  下一圈的数据 erase掉 
-			curr_circle_count = 0;
-
-			//计算时间差  按比例减掉多传的时间  最后一包 踢掉后面的点所用的时间  重算时间戳 
-			if (circleDataInfo.stopStamp == 0)
-			{
-				stamp_temp = pack_point.packageStamp;
-			}
-			else
-			{
-				stamp_differ = pack_point.packageStamp - circleDataInfo.stopStamp;
-				stamp_temp = pack_point.packageStamp - (stamp_differ * (all_count - circle_count) / all_count);
-			}
-
-			//计算 
-			circleDataInfo.startStamp = circleDataInfo.stopStamp;
-			//判断是否有非法值 
-			if (m_run_circles <= 8)
-			{
-				circleDataInfo.stopStamp = pack_point.packageStamp;
-			}
-			else
-			{
-				circleDataInfo.stopStamp = stamp_temp;
-
-				//uint64_t diff = circleDataInfo.stopStamp - circleDataInfo.startStamp;
-				//printf("time differ:%lu\r\n", diff);
-			}
-			//按比例重算结束时间 因为一包固定128点 0位可能出在任意位置  会影响时间戳精确度 
-			//printf("pack_num:%d,indx:%d\r\n", circleDataInfo.lidarCircleNodePoints.size(), pack_point.package0CIndex);
-
-			if (m_run_circles > 3)
-			{
-				setCircleResponseUnlock();		//解锁  告知已接到一包数据信息 
-			}
-		}
-	}
-
-
-	//-------------------------------------对外接口信息-------------------------------------------
-
-	//获取SDK版本号
-	std::string LidarDriverUDP::getSDKVersion()
-	{
-		return NVILIDAR_SDKVerision;
-	}
-
-	//设置雷达是否带信号质量信息
-	bool LidarDriverUDP::SetIntensities(const uint8_t has_intensity, uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		uint8_t   cmd;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//刷新串口 并做接收处理
-		cmd = (has_intensity ? NVILIDAR_CMD_SET_HAVE_INTENSITIES : NVILIDAR_CMD_SET_NO_INTENSITIES);
-		//发送命令
-		if (!SendCommand(cmd))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//获取设备类型信息
-	bool LidarDriverUDP::GetDeviceInfo(Nvilidar_DeviceInfo &info, uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_GET_DEVICE_INFO))
-		{
-			return false;
-		}
-	
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if(recv_info.recvFinishFlag)
-			{
-				uint8_t productNameTemp[6] = { 0 };
-				memcpy(productNameTemp, recv_info.lidar_device_info.MODEL_NUM,5);
-
-				//生成字符信息
-				info.m_SoftVer = formatString("V%d.%d", recv_info.lidar_device_info.SW_V[0], recv_info.lidar_device_info.SW_V[1]);
-				info.m_HardVer = formatString("V%d.%d", recv_info.lidar_device_info.HW_V[0], recv_info.lidar_device_info.HW_V[1]);
-				info.m_ProductName = formatString("%s", productNameTemp);
-				info.m_SerialNum = formatString("%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d",
-					recv_info.lidar_device_info.serialnum[0], recv_info.lidar_device_info.serialnum[1], recv_info.lidar_device_info.serialnum[2], recv_info.lidar_device_info.serialnum[3],
-					recv_info.lidar_device_info.serialnum[4], recv_info.lidar_device_info.serialnum[5], recv_info.lidar_device_info.serialnum[6], recv_info.lidar_device_info.serialnum[7],
-					recv_info.lidar_device_info.serialnum[8], recv_info.lidar_device_info.serialnum[9], recv_info.lidar_device_info.serialnum[10], recv_info.lidar_device_info.serialnum[11],
-					recv_info.lidar_device_info.serialnum[12], recv_info.lidar_device_info.serialnum[13], recv_info.lidar_device_info.serialnum[14], recv_info.lidar_device_info.serialnum[15]);
-
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-
-	//复位雷达
-	bool LidarDriverUDP::Reset(void)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		if (!SendCommand(NVILIDAR_CMD_GET_DEVICE_INFO))
-		{
-			return false;
-		}
-
-		delayMS(800);
-
-		return true;
-	}
-
-	//设置雷达转速信息
-	bool LidarDriverUDP::SetScanMotorSpeed(uint16_t frequency, uint16_t &ret_frequency,
-		uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_AIMSPEED,
-			((uint8_t*)(&frequency)), sizeof(frequency)))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				ret_frequency = recv_info.aimSpeed;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//增加雷达采样率
-	bool LidarDriverUDP::SetSamplingRate(uint32_t rate_write, uint32_t &rate,
-		uint32_t timeout)   //雷达采样率增加
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_SAMPLING_RATE,
-			((uint8_t*)(&rate_write)), sizeof(rate_write)))
-		{
-			return false;
-		}
- 
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				rate = recv_info.samplingRate;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-
-	//读取角度偏移
-	bool LidarDriverUDP::GetZeroOffsetAngle(int16_t &angle, uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_GET_ANGLE_OFFSET))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				angle = recv_info.angleOffset;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//设置角度偏移
-	bool LidarDriverUDP::SetZeroOffsetAngle(int16_t angle_set, int16_t &angle,
-		uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_ANGLE_OFFSET,
-			((uint8_t*)(&angle_set)), sizeof(angle_set)))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				angle = recv_info.angleOffset;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//get the lidar quality filter 
-	bool LidarDriverUDP::GetFilterQualityThreshold(uint16_t &ret_filter_quality,uint32_t timeout){
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning){
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_GET_QUALITY_THRESHOLD)){
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout)){
-			if (recv_info.recvFinishFlag){
-				ret_filter_quality = recv_info.qualityFilter;
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//set the lidar quality filter 
-	bool LidarDriverUDP::SetFilterQualityThreshold(uint16_t filter_quality_set, uint16_t &ret_filter_quality,uint32_t timeout){
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning){
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_QUALITY_THRESHOLD,(uint8_t *)(&filter_quality_set), sizeof(filter_quality_set))){
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout)){
-			if (recv_info.recvFinishFlag){
-				ret_filter_quality = recv_info.qualityFilter;
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//设置拖尾等级
-	bool LidarDriverUDP::SetTrailingLevel(uint8_t tailing_set, uint8_t &tailing,
-		uint32_t  timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_TAILING_LEVEL, (uint8_t *)(&tailing_set), sizeof(tailing)))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				tailing = recv_info.tailingLevel;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//获取雷达配置信息
-	bool LidarDriverUDP::GetLidarCfg(Nvilidar_StoreConfigTypeDef &info, uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_GET_LIDAR_CFG))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				//生成字符信息
-				info.aimSpeed = recv_info.lidar_get_para.aimSpeed;
-				info.isHasSensitive = recv_info.lidar_get_para.hasSensitive;
-				info.samplingRate = recv_info.lidar_get_para.samplingRate;
-				info.tailingLevel = recv_info.lidar_get_para.tailingLevel;
-				info.apdValue = recv_info.lidar_get_para.apdValue;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//设置灵敏度 
-	bool LidarDriverUDP::SetApdValue(uint16_t apd_set, uint16_t &apd,uint32_t  timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if (lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SET_APD_VALUE, (uint8_t *)(&apd_set), sizeof(apd_set)))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				apd = recv_info.apdValue;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//保存雷达参数
-	bool LidarDriverUDP::SaveCfg(bool &flag, uint32_t timeout)
-	{
-		recv_info.recvFinishFlag = false;
-
-		//先停止雷达 如果雷达在运行 
-		if(lidar_state.m_Scanning)
-		{
-			StopScan();
-		}
-
-		//发送命令
-		if (!SendCommand(NVILIDAR_CMD_SAVE_LIDAR_PARA))
-		{
-			return false;
-		}
-
-		//等待线程同步 超时 
-		if (waitNormalResponse(timeout))
-		{
-			if (recv_info.recvFinishFlag)
-			{
-				flag = (bool)(recv_info.saveFlag);
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	//获取当前扫描状态
-	bool LidarDriverUDP::LidarGetScanState()
-	{
-		return lidar_state.m_Scanning;
-	}
-
-	//get lidar name  
-	LidarModelListEnumTypeDef LidarDriverUDP::GetLidarModelName(Nvilidar_DeviceInfo info){
-		std::string modelNum_String = info.m_ProductName;
-		std::string::size_type pos;
-
-		//ROC300
-		pos = modelNum_String.find("VP300");
-		if(pos != std::string::npos){
-			return NVILIDAR_ROC300;
-		}
-		pos = modelNum_String.find("R300");
-		if(pos != std::string::npos){
-			return NVILIDAR_ROC300;
-		}
-
-		//VP350 
-		pos = modelNum_String.find("VP350");
-		if(pos != std::string::npos){
-			return NVILIDAR_VP350;
-		}
-		pos = modelNum_String.find("VP351");
-		if(pos != std::string::npos){
-			return NVILIDAR_VP350;
-		}
-
-		return NVILIDAR_Unknow;
-	}
-
-	//---------------------------------------------thread API----------------------------------------------
-	//init thread 
-	bool LidarDriverUDP::createThread()
-	{
-		#if	defined(_WIN32)
-			/*
-			创建线程函数详细说明
-			*HANDLE WINAPI CreateThread(
-			__in_opt  LPSECURITY_ATTRIBUTES lpThreadAttributes,
-			__in      SIZE_T dwStackSize,
-			__in      LPTHREAD_START_ROUTINE lpStartAddress,
-			__in_opt __deref __drv_aliasesMem LPVOID lpParameter,
-			__in      DWORD dwCreationFlags,
-			__out_opt LPDWORD lpThreadId
-			);
-			*返回值：函数成功，返回线程句柄；函数失败返回false。若不想返回线程ID,设置值为NULL
-			*参数说明：
-			*lpThreadAttributes	线程安全性，使用缺省安全性,一般缺省null
-			*dwStackSize	堆栈大小，0为缺省大小
-			*lpStartAddress	线程要执行的函数指针，即入口函数
-			*lpParameter	线程参数
-			*dwCreationFlags	线程标记，如为0，则创建后立即运行
-			*lpThreadId	LPDWORD为返回值类型，一般传递地址去接收线程的标识符，一般设为null
-			*/
-			_thread = CreateThread(NULL, 0, LidarDriverUDP::periodThread, this, 0, NULL);
-			if (_thread == NULL)
-			{
-				return false;
-			}
-
-
-
-			/*
-			*创建事件对象
-			HANDLE WINAPI CreateEventA(
-			__in_opt LPSECURITY_ATTRIBUTES lpEventAttributes,
-			__in     BOOL bManualReset,
-			__in     BOOL bInitialState,
-			__in_opt LPCSTR lpName
-			);
-			*返回值：如果函数调用成功，函数返回事件对象的句柄。如果对于命名的对象，在函数调用前已经被创建，函数将返回存在的事件对象的句柄，而且在GetLastError函数中返回ERROR_ALREADY_EXISTS。
-			如果函数失败，函数返回值为NULL，如果需要获得详细的错误信息，需要调用GetLastError。
-			*参数说明：
-			*lpEventAttributes	安全性，采用null默认安全性。
-			*bManualReset	（TRUE）人工重置或（FALSE）自动重置事件对象为非信号状态，若设为人工重置，则当事件为有信号状态时，所有等待的线程都变为可调度线程。
-			*bInitialState		指定事件对象的初始化状态，TRUE：初始为有信号状态。
-			*lpName	事件对象的名字，一般null匿名即可
-			*/
-			_event_analysis = CreateEvent(NULL, false, false, NULL);;
-			if (_event_analysis == NULL)
-			{
-				return false;
-			}
-			ResetEvent(_event_analysis);
-
-			//一圈点的数据信息 信息同步 
-			_event_circle = CreateEvent(NULL, false, false, NULL);;
-			if (_event_circle == NULL)
-			{
-				return false;
-			}
-			ResetEvent(_event_circle);
-
-			return true;
-		#else 
-			//sync connect  
-			pthread_cond_init(&_cond_analysis, NULL);
-    		pthread_mutex_init(&_mutex_analysis, NULL);
-			pthread_cond_init(&_cond_point, NULL);
-    		pthread_mutex_init(&_mutex_point, NULL);
-
-			//create thread 
-     		if(-1 == pthread_create(&_thread, NULL, LidarDriverUDP::periodThread, this))
-     		{
-				 _thread = -1;
-         		return false;
-			}
-
-			return true;
-
-		#endif 
-	}
-
-	//close thread 
-	void LidarDriverUDP::closeThread()
-	{
-		#if	defined(_WIN32)
-			CloseHandle(_thread);
-			CloseHandle(_event_analysis);
-			CloseHandle(_event_circle);
-		#else 
-			pthread_cancel(_thread);
-			pthread_cond_destroy(&_cond_analysis);
-			pthread_mutex_destroy(&_mutex_analysis);
-			pthread_cond_destroy(&_cond_point);
-			pthread_mutex_destroy(&_mutex_point);
-
-		#endif 
-	}
-
-	//wait for response 
-	bool LidarDriverUDP::waitNormalResponse(uint32_t timeout)
-	{
-		#if	defined(_WIN32)
-			DWORD state;
-			ResetEvent(_event_analysis);		// 重置事件，让其他线程继续等待（相当于获取锁）
-			state = WaitForSingleObject(_event_analysis, timeout);
-			if(state == WAIT_OBJECT_0)
-			{
-				return true;
-			}
-		#else 
-			struct timeval now;
-    		struct timespec outtime;
-			int state = -1;
-
-			pthread_mutex_lock(&_mutex_analysis);
- 
-			gettimeofday(&now, NULL);
-			outtime.tv_sec = now.tv_sec + timeout / 1000;
-			outtime.tv_nsec = now.tv_usec * 1000 + timeout%1000*1000;
-		
-			state = pthread_cond_timedwait(&_cond_analysis, &_mutex_analysis, &outtime);
-			pthread_mutex_unlock(&_mutex_analysis);
-
-			if(0 == state)
-			{
-				return true;
-			}
-
-		#endif
-
-		return false;
-	}
-
-	//等待事件 解锁 
-	void LidarDriverUDP::setNormalResponseUnlock()
-	{
-		#if	defined(_WIN32)
-			SetEvent(_event_analysis);			// 重置事件，让其他线程继续等待（相当于获取锁）
-		#else 
-			pthread_mutex_lock(&_mutex_analysis);
-    		pthread_cond_signal(&_cond_analysis);
-    		pthread_mutex_unlock(&_mutex_analysis);
-		#endif 
-	}
-
-	//等待一圈点云 事件 
-	bool LidarDriverUDP::LidarSamplingProcess(LidarScan &scan, uint32_t timeout)
-	{
-		//等待解锁  即一圈点数据完成了  
-		#if	defined(_WIN32)
-			DWORD state;
-			std::vector<Nvilidar_Node_Info> node_in;
-			ResetEvent(_event_circle);		// 重置事件，让其他线程继续等待（相当于获取锁）
-			state = WaitForSingleObject(_event_circle, timeout);
-			if (state == WAIT_OBJECT_0){
-				//data filter 
-				node_in = circleDataInfo.lidarCircleNodePoints;
-				LidarFilter::instance()->LidarNoiseFilter(node_in,circleDataInfo.lidarCircleNodePoints);
-				//filter change 
-				LidarSamplingData(circleDataInfo, scan);
-				return true;
-			}	
-		#else 
-			struct timeval now;
-    		struct timespec outtime;
-			std::vector<Nvilidar_Node_Info> node_in;
-			int state = -1;
-
-			pthread_mutex_lock(&_mutex_point);
- 
-			gettimeofday(&now, NULL);
-			outtime.tv_sec = now.tv_sec + timeout / 1000;
-			outtime.tv_nsec = now.tv_usec * 1000 + timeout%1000*1000;
-		
-			state = pthread_cond_timedwait(&_cond_point, &_mutex_point, &outtime);
-			pthread_mutex_unlock(&_mutex_point);
-
-			if(0 == state){
-				//data filter 
-				node_in = circleDataInfo.lidarCircleNodePoints;
-				LidarFilter::instance()->LidarNoiseFilter(node_in,circleDataInfo.lidarCircleNodePoints);
-				//filter change 
-				LidarSamplingData(circleDataInfo, scan);
-				return true;
-			}
-		#endif
-
-		return false;
-	}
-
-	//采样数据分析  
-	void LidarDriverUDP::LidarSamplingData(CircleDataInfoTypeDef info, LidarScan &outscan)
-	{
-		uint32_t all_nodes_counts = 0;		//所有点数  不做截取等用法 
-		uint64_t scan_time = 0;				//2圈点的扫描间隔 
-
-		//扫描时间 
-		scan_time = info.stopStamp - info.startStamp;
-
-		//原始数据  计数
-		uint32_t lidar_ori_count = info.lidarCircleNodePoints.size();
-
-		//固定角分辨率 
-		if (lidar_cfg.resolution_fixed)
-		{
-			all_nodes_counts = (uint32_t)(lidar_cfg.storePara.samplingRate * 100 / lidar_cfg.storePara.aimSpeed);
-		}
-		else 	//非固定角分辨率 则是雷达默认一包多少点 就实际产生多少个点 
-		{
-			all_nodes_counts = lidar_ori_count;
-		}
-
-		//最大角与最小角问题 如是不对  则反转  
-		if (lidar_cfg.angle_max < lidar_cfg.angle_min)
-		{
-			float temp = lidar_cfg.angle_min;
-			lidar_cfg.angle_min = lidar_cfg.angle_max;
-			lidar_cfg.angle_max = temp;
-		}
-
-		//以角度为比例  计算输出信息 
-		outscan.stamp = info.startStamp;
-		outscan.config.max_angle = lidar_cfg.angle_max*M_PI / 180.0;			//计算最大角度  				
-		outscan.config.min_angle = lidar_cfg.angle_min*M_PI / 180.0;			//计算最小角度  
-		outscan.config.angle_increment = 2.0 * M_PI/(double)(all_nodes_counts - 1);	//计算2点之间的角度增量 
-			
-		outscan.config.scan_time = static_cast<float>(1.0 * scan_time / 1e9);  	//扫描时间信息  
-		outscan.config.time_increment = outscan.config.scan_time / (double)(all_nodes_counts - 1); 	//2点之间的时间 
-		outscan.config.min_range = lidar_cfg.range_min;
-		outscan.config.max_range = lidar_cfg.range_max;
-
-		//初始化变量  
-		float dist = 0.0;
-		float angle = 0.0;
-		float intensity = 0.0;
-		unsigned int i = 0;
-		outscan.points.clear();		//clear vector 
-
-		//从雷达原始数据中  提取数据  
-		for (; i < lidar_ori_count; i++)
-		{
-			dist = static_cast<float>(info.lidarCircleNodePoints.at(i).lidar_distance / 1000.f);
-			intensity = static_cast<float>(info.lidarCircleNodePoints.at(i).lidar_quality);
-			angle = static_cast<float>(info.lidarCircleNodePoints.at(i).lidar_angle);
-			angle = angle * M_PI / 180.0;
-
-			//Rotate 180 degrees or not
-			if (lidar_cfg.reversion)
-			{
-				angle = angle + M_PI;
-			}
-			//Is it counter clockwise
-			if (!lidar_cfg.inverted)
-			{
-				angle = 2 * M_PI - angle;
-			}
-
-			//忽略点（事先配置好哪个角度的范围）
-			if (lidar_cfg.ignore_array.size() != 0)
-			{
-				for (uint16_t j = 0; j < lidar_cfg.ignore_array.size(); j = j + 2)
-				{
-					double angle_start = lidar_cfg.ignore_array[j] * M_PI / 180.0;
-					double angle_end = lidar_cfg.ignore_array[j + 1] * M_PI / 180.0;
-
-					if ((angle_start <= angle) && (angle <= angle_end))
-					{
-						dist = 0.0;
-						intensity = 0.0; 
-
-						break;
-					}
-				}
-			}
-
-			//-pi ~ pi
-			angle = fmod(fmod(angle, 2.0 * M_PI) + 2.0 * M_PI, 2.0 * M_PI);
-			if (angle > M_PI)
-			{
-				angle -= 2.0 * M_PI;
-			}
-
-			//距离是否在有效范围内 
-			if (dist > lidar_cfg.range_max || dist < lidar_cfg.range_min)
-			{
-				dist = 0.0;
-				intensity = 0.0;
-			}
-
-			//角度是否在有效范围内 
-			if ((angle >= outscan.config.min_angle) &&
-				(angle <= outscan.config.max_angle)){
-				NviLidarPoint point;
-				point.angle = angle;
-				point.range = dist;
-				point.intensity = intensity;
-
-				outscan.points.push_back(point);
-			}
-		}
-		//fill 
-		if (lidar_cfg.resolution_fixed)
-		{
-			int output_count = all_nodes_counts * ((outscan.config.max_angle - outscan.config.min_angle) / M_PI / 2);
-			outscan.points.resize(output_count);
-		}	
-	}
-
-	//等待一圈点云 事件 解锁 
-	void LidarDriverUDP::setCircleResponseUnlock()
-	{
-		#if	defined(_WIN32)
-			SetEvent(_event_circle);			// 重置事件，让其他线程继续等待（相当于获取锁）
-		#else 
-			pthread_mutex_lock(&_mutex_point);
-    		pthread_cond_signal(&_cond_point);
-    		pthread_mutex_unlock(&_mutex_point);
-		#endif 
-	}
-
-	//线程进程 分win32和linux等   
-	#if	defined(_WIN32)
-		DWORD WINAPI  LidarDriverUDP::periodThread(LPVOID lpParameter)
-		{
-			static uint8_t recv_data[8192];
-			size_t recv_len = 0;
-
-			//在线程中要做的事情
-			LidarDriverUDP *pObj = (LidarDriverUDP *)lpParameter;   //传入的参数转化为类对象指针
-
-			while (pObj->lidar_state.m_CommOpen)
-			{	
-				//解包处理 === 正常解包 
-				if (! pObj->lidar_state.m_Scanning)	//点云数据包 
-				{
-					//读串口接收数据长度 
-					recv_len = pObj->socket_udp.udpReadData(recv_data, 8192);
-					if((recv_len > 0) && (recv_len <= 8192))
-					{
-						pObj->NormalDataUnpack(recv_data, recv_len);
-					}
-				}
-				//解包处理 ==== 点云解包 
-				else 
-				{
-					//读串口接收数据长度 
-					recv_len = pObj->socket_udp.udpReadData(recv_data, 8192);
-					if((recv_len > 0) && (recv_len <= 8192))
-					{
-						pObj->PointDataUnpack(recv_data, recv_len);
-					}
-				}
-
-				delayMS(1);		//必须要加sleep 不然会超高占用cpu	
-			}
-
-			return 0;
-		}
-	#else 
-		/* 定义线程pthread */
-	   	void * LidarDriverUDP::periodThread(void *lpParameter)
-		{
-			static uint8_t recv_data[8192];
-			size_t recv_len = 0;
-
-			//在线程中要做的事情
-			LidarDriverUDP *pObj = (LidarDriverUDP *)lpParameter;   //传入的参数转化为类对象指针
-
-			while (pObj->lidar_state.m_CommOpen)
-			{	
-				//解包处理 === 正常解包 
-				if (! pObj->lidar_state.m_Scanning)	//点云数据包 
-				{
-					//读串口接收数据长度 
-					recv_len = pObj->socket_udp.udpReadData(recv_data, 8192);
-					if((recv_len > 0) && (recv_len <= 8192))
-					{
-						pObj->NormalDataUnpack(recv_data, recv_len);
-					}
-				}
-				//解包处理 ==== 点云解包 
-				else 
-				{
-					//读串口接收数据长度 
-					recv_len = pObj->socket_udp.udpReadData(recv_data, 8192);
-					if((recv_len > 0) && (recv_len <= 8192))
-					{
-						pObj->PointDataUnpack(recv_data, recv_len);
-					}
-				}
-
-				delayMS(1);		//必须要加sleep 不然会超高占用cpu	
-			}
-
-			return 0;
-		}
-	#endif 
-
-	
-}
-
-
-
-
-
+#include "nvilidar_driver_udp.h"
+#include "socket/nvilidar_socket.h"
+#include <list>
+#include <string>
+#include "myconsole.h"
+#include "mytimer.h"
+#include "mystring.h"
+
+namespace nvilidar
+{
+	LidarDriverUDP::LidarDriverUDP(){
+		lidar_state.m_CommOpen = false;       
+		lidar_state.m_Scanning = false;        
+
+		//command send interface 
+		command_engine.SetSender([this](uint8_t cmd, uint8_t *payload, uint16_t size){
+			return SendCommand(cmd, payload, size);
+		});
+
+		//relay packages of one read,used by the reader thread only 
+		relay_buf.reserve(sizeof(m_recv_data));
+	}
+
+	LidarDriverUDP::~LidarDriverUDP(){
+		LidarDisconnect();
+		udp_mux = NULL;			//out of the mux hub too 
+		LidarSetHub(NULL);
+		#if	defined(_WIN32)
+			if (_event_circle != NULL)
+			{
+				CloseHandle(_event_circle);
+			}
+		#endif
+	}
+
+	//load para  
+	void LidarDriverUDP::LidarLoadConfig(Nvilidar_UserConfigTypeDef cfg){
+		lidar_cfg = cfg; 
+		lidar_filter.LidarFilterLoadPara(cfg.filter_para);                  
+		m_has_sensitive = (cfg.storePara.isHasSensitive != 0);
+		m_aim_speed = (float)cfg.aim_speed;
+		link_supervisor.SetStallCircles(cfg.stall_circles);
+	}
+
+	//Lidar connected or not
+	bool LidarDriverUDP::LidarIsConnected(){
+		if (lidar_state.m_CommOpen)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	//lidar init 
+	bool LidarDriverUDP::LidarInitialialize()
+	{
+		Nvilidar_StoreConfigTypeDef store_para_read;		
+
+		//para is valid?
+		if ((lidar_cfg.ip_addr.length() == 0) || (lidar_cfg.lidar_udp_port == 0))
+		{
+			return false;		//网络参数信息不合法 
+		}
+
+		//start connect udp server  
+		if (!LidarConnect(lidar_cfg.ip_addr, lidar_cfg.lidar_udp_port))
+		{
+			nvilidar::console.error("Error initializing NVILIDAR scanner.");
+			return false;		//serialport connect fail 
+		}
+
+		//send stop cmd 
+		StopScan();
+		//sleep 
+		delayMS(300);
+		//create thread to read serialport data   
+		createThread();		
+		
+		//get lidar infomation 
+		if (false == GetDeviceInfo(lidar_cfg.deviceInfo))
+		{
+			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Device Info.");
+			return false;
+		}
+		lidar_cfg.lidar_model_name = GetLidarModelName(lidar_cfg.deviceInfo);
+		if(lidar_cfg.lidar_model_name == NVILIDAR_Unknow)
+		{
+			nvilidar::console.error("current lidar is not support!\n");
+			return false;
+		}
+		nvilidar::console.show("\nlidar device info:");
+		nvilidar::console.show("lidar name:%s", lidar_cfg.deviceInfo.m_ProductName.c_str());
+		nvilidar::console.show("lidar soft version:%s", lidar_cfg.deviceInfo.m_SoftVer.c_str());
+		nvilidar::console.show("lidar hard version:%s", lidar_cfg.deviceInfo.m_HardVer.c_str());
+		nvilidar::console.show("lidar serialnumber:%s", lidar_cfg.deviceInfo.m_SerialNum.c_str());
+
+		//get lidar config para 
+		if (false == GetLidarCfg(store_para_read))
+		{
+			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Config Info.");
+			return false;
+		}
+		//get lidar angle offset 
+		if(false == GetZeroOffsetAngle(store_para_read.angleOffset)){
+			nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Angle Offset.");
+			return false;
+		}
+		if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
+			//get lidar quality filter value 
+			if(false == GetFilterQualityThreshold(store_para_read.qualityFilterThreshold)){
+				nvilidar::console.warning("Error initializing NVILIDAR scanner.Failed to get Lidar Quality Filter Threshod.");
+			}
+		}
+
+		//set the para which is different from the lidar 
+		LidarSetDevicePara(lidar_cfg, store_para_read);
+		lidar_store_para = store_para_read;			//cache the lidar para 
+
+		//打印配置信息
+		nvilidar::console.show("\nlidar config info:");
+		nvilidar::console.show("lidar samplerate :%d", store_para_read.samplingRate);
+		nvilidar::console.show("lidar frequency :%d.%02d", store_para_read.aimSpeed/100, store_para_read.aimSpeed%100);
+		nvilidar::console.show("lidar sesitive :%s", store_para_read.isHasSensitive ? "yes" : "no");
+		nvilidar::console.show("lidar tailling filter level :%d", store_para_read.tailingLevel);
+		nvilidar::console.show("lidar angle offset :%.2f",(double)store_para_read.angleOffset/64.0);
+		if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
+			nvilidar::console.show("lidar apd value :%d",store_para_read.apdValue);
+			nvilidar::console.show("lidar quality filter threshold :%d\n",store_para_read.qualityFilterThreshold);
+		}
+
+		return true;
+	}
+
+	//lidar start  
+	bool LidarDriverUDP::LidarTurnOn()
+	{
+		if (!StartScan())
+		{
+			StopScan();
+
+			nvilidar::console.error("[CNviLidar] Failed to start scan");
+
+			return false;
+		}
+
+		m_run_circles = 0;
+		//success 
+		nvilidar::console.message("[NVILIDAR INFO] Now NVILIDAR is scanning ......");
+
+		return true;
+	}
+
+	//lidar stop 
+	bool LidarDriverUDP::LidarTurnOff()
+	{
+		//stop 
+		StopScan();
+
+		m_run_circles = 0;
+
+		return true;
+	}
+
+	bool LidarDriverUDP::LidarCloseHandle()
+	{
+		LidarDisconnect();
+		return true;
+	}
+
+	//set the lidar para which is different from the lidar,the lidar is stopped at the first set 
+	bool LidarDriverUDP::LidarSetDevicePara(Nvilidar_UserConfigTypeDef &cfg, Nvilidar_StoreConfigTypeDef &store_para_read)
+	{
+		bool save_flag = false;
+		bool isNeedSetPara = false;
+		bool isSetOK = true;
+		//is same? 
+		if (cfg.storePara.samplingRate != store_para_read.samplingRate){
+			isNeedSetPara = true;
+			if (!SetSamplingRate(cfg.storePara.samplingRate, store_para_read.samplingRate)){
+				isSetOK = false;
+			}
+		}
+		if (cfg.storePara.aimSpeed != store_para_read.aimSpeed){
+			isNeedSetPara = true;
+			if (!SetScanMotorSpeed(cfg.storePara.aimSpeed, store_para_read.aimSpeed)){
+				isSetOK = false;
+			}
+		}
+		if (cfg.storePara.isHasSensitive != store_para_read.isHasSensitive){
+			isNeedSetPara = true;
+			if(!SetIntensities(cfg.storePara.isHasSensitive)){
+				isSetOK = false;
+			}
+			store_para_read.isHasSensitive = cfg.storePara.isHasSensitive;
+		}
+		if (cfg.storePara.tailingLevel != store_para_read.tailingLevel){
+			isNeedSetPara = true;
+			if (!SetTrailingLevel(cfg.storePara.tailingLevel, store_para_read.tailingLevel)){
+				isSetOK = false;
+			}
+		}
+		if(true == cfg.angle_offset_change_flag){			//angle offset 
+			if (cfg.storePara.angleOffset != store_para_read.angleOffset){
+				isNeedSetPara = true;
+				if(!SetZeroOffsetAngle(cfg.storePara.angleOffset, store_para_read.angleOffset)){
+					isSetOK = false;
+				}
+			}
+		}
+		if (true == cfg.apd_change_flag){					//apd value 				
+			if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
+				if (cfg.storePara.apdValue != store_para_read.apdValue){
+					isNeedSetPara = true;
+					if (!SetApdValue(cfg.storePara.apdValue, store_para_read.apdValue)){
+						isSetOK = false;
+					}
+				}
+			}
+		}
+		if(true == cfg.quality_threshold_change_flag){		//quality threshold 
+			if(lidar_cfg.lidar_model_name == NVILIDAR_ROC300){
+				if(cfg.storePara.qualityFilterThreshold != store_para_read.qualityFilterThreshold){
+					isNeedSetPara = true;
+					if(!SetFilterQualityThreshold(cfg.storePara.qualityFilterThreshold,store_para_read.qualityFilterThreshold)){
+						isSetOK = false;
+					}
+				}
+			}
+		}
+		if (isNeedSetPara)
+		{
+			if (isSetOK){
+				SaveCfg(save_flag);
+				isSetOK = save_flag;
+				if(save_flag){
+					nvilidar::console.show("NVILIDAR set para OK!");
+				}
+				else {
+					nvilidar::console.show("NVILIDAR set para Fail!");
+				}
+			}
+			else{
+				nvilidar::console.warning("NVILIDAR set para Fail!");
+			}
+		}
+		return isSetOK;
+	}
+
+	//reload para while running,lidar para is set in one stop/set/save/start cycle,sdk para is changed between 2 circles 
+	bool LidarDriverUDP::LidarReconfigure(Nvilidar_UserConfigTypeDef cfg)
+	{
+		Nvilidar_StoreConfigTypeDef store_para_read = lidar_store_para;
+		bool scanning = lidar_state.m_Scanning;
+		bool ret = true;
+
+		//lidar para 
+		if (lidar_state.m_CommOpen)
+		{
+			ret = LidarSetDevicePara(cfg, store_para_read);
+			lidar_store_para = store_para_read;
+			cfg.storePara.isHasSensitive = store_para_read.isHasSensitive;
+
+			//the reader and the restart take them now,lidar_cfg is changed by the output thread 
+			m_has_sensitive = (store_para_read.isHasSensitive != 0);
+			m_aim_speed = (float)cfg.aim_speed;
+			{
+				std::lock_guard<std::mutex> lock(cfg_mutex);
+				cfg_pending_lidar = cfg;
+				cfg_pending_lidar_flag = true;
+			}
+		}
+
+		//sdk para,take effect at next circle 
+		{
+			std::lock_guard<std::mutex> lock(cfg_mutex);
+			cfg_pending = cfg;
+			cfg_pending_flag = true;
+		}
+
+		if (lidar_state.m_CommOpen)
+		{
+			//lidar is stopped by set,restart it 
+			if (scanning && (!lidar_state.m_Scanning))
+			{
+				m_run_circles = 0;
+				if (!StartScan())
+				{
+					nvilidar::console.error("[CNviLidar] Failed to restart scan");
+					ret = false;
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	//change sdk para between 2 circles (called by the output thread)
+	void LidarDriverUDP::LidarApplySdkPara()
+	{
+		std::lock_guard<std::mutex> lock(cfg_mutex);
+
+		//lidar para,set to the lidar by LidarReconfigure 
+		if (cfg_pending_lidar_flag)
+		{
+			cfg_pending_lidar_flag = false;
+
+			lidar_cfg.storePara = cfg_pending_lidar.storePara;
+			lidar_cfg.aim_speed = cfg_pending_lidar.aim_speed;
+			lidar_cfg.sampling_rate = cfg_pending_lidar.sampling_rate;
+			lidar_cfg.sensitive = cfg_pending_lidar.sensitive;
+			lidar_cfg.tailing_level = cfg_pending_lidar.tailing_level;
+			lidar_cfg.apd_change_flag = cfg_pending_lidar.apd_change_flag;
+			lidar_cfg.apd_value = cfg_pending_lidar.apd_value;
+			lidar_cfg.angle_offset_change_flag = cfg_pending_lidar.angle_offset_change_flag;
+			lidar_cfg.angle_offset = cfg_pending_lidar.angle_offset;
+			lidar_cfg.quality_threshold_change_flag = cfg_pending_lidar.quality_threshold_change_flag;
+			lidar_cfg.quality_threshold = cfg_pending_lidar.quality_threshold;
+		}
+
+		if (!cfg_pending_flag)
+		{
+			return;
+		}
+		cfg_pending_flag = false;
+
+		lidar_cfg.frame_id = cfg_pending.frame_id;
+		lidar_cfg.auto_reconnect = cfg_pending.auto_reconnect;
+		lidar_cfg.reversion = cfg_pending.reversion;
+		lidar_cfg.inverted = cfg_pending.inverted;
+		lidar_cfg.angle_max = cfg_pending.angle_max;
+		lidar_cfg.angle_min = cfg_pending.angle_min;
+		lidar_cfg.range_max = cfg_pending.range_max;
+		lidar_cfg.range_min = cfg_pending.range_min;
+		lidar_cfg.ignore_array_string = cfg_pending.ignore_array_string;
+		lidar_cfg.ignore_array = cfg_pending.ignore_array;
+		lidar_cfg.resolution_fixed = cfg_pending.resolution_fixed;
+		lidar_cfg.filter_para = cfg_pending.filter_para;
+		lidar_cfg.stall_circles = cfg_pending.stall_circles;
+		link_supervisor.SetStallCircles(lidar_cfg.stall_circles);
+
+		lidar_filter.LidarFilterLoadPara(lidar_cfg.filter_para);
+	}
+
+	//reconnect statistics 
+	LidarLinkStats LidarDriverUDP::LidarGetLinkStats()
+	{
+		return link_supervisor.GetStats();
+	}
+
+	//stall event 
+	void LidarDriverUDP::LidarSetStallCallback(LidarStallCallback callback)
+	{
+		link_supervisor.SetStallCallback(callback);
+	}
+
+	//package parse statistics 
+	LidarParseStats LidarDriverUDP::LidarGetParseStats()
+	{
+		LidarParseStats stats;
+
+		stats.valid_packages = metrics.Get(NVILIDAR_METRIC_PACKAGES_VALID);
+		stats.rejected_packages = metrics.Get(NVILIDAR_METRIC_HEADER_ERRORS) + metrics.Get(NVILIDAR_METRIC_CHECKSUM_ERRORS);
+		stats.recovered_packages = metrics.Get(NVILIDAR_METRIC_PACKAGES_RECOVERED);
+		stats.discarded_bytes = metrics.Get(NVILIDAR_METRIC_BYTES_DISCARDED);
+
+		return stats;
+	}
+
+	//rolling latency of the last scans 
+	LidarLatencyStats LidarDriverUDP::LidarGetLatencyStats()
+	{
+		LidarLatencyStats stats;
+
+		latency_window.Get(stats);
+
+		return stats;
+	}
+
+	//health record event 
+	void LidarDriverUDP::LidarSetHealthCallback(LidarHealthCallback callback, uint32_t circles)
+	{
+		health_monitor.SetCallback(callback, circles);
+	}
+
+	//last health record 
+	bool LidarDriverUDP::LidarGetHealth(NviLidarHealth &health)
+	{
+		return health_monitor.Get(health);
+	}
+
+	//one socket for many lidars,the datagrams are sorted by the source ip:port 
+	//fed by the hub thread of the mux,the lidar is put in that hub(no own thread) 
+	bool LidarDriverUDP::LidarSetUdpMux(LidarUdpMux *mux)
+	{
+		if (lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+		if (mux == NULL)
+		{
+			udp_mux = NULL;
+			return true;
+		}
+
+		LidarHub *hub = mux->GetHub();
+		if (hub == NULL)
+		{
+			nvilidar::console.warning("udp mux is not open,call LidarUdpMux::Open first");
+			return false;
+		}
+		if ((io_hub != NULL) && (io_hub != hub))
+		{
+			nvilidar::console.warning("udp mux lidar must be in the hub of the mux");
+			return false;
+		}
+		if ((io_hub == NULL) && !LidarSetHub(hub))
+		{
+			return false;
+		}
+		udp_mux = mux;
+
+		return true;
+	}
+
+	//multicast to the processes on this host,the kernel copies it to every subscriber 
+	bool LidarDriverUDP::LidarStartRelay(std::string group, uint16_t port, LidarRelayModeEnum mode, std::string iface, uint8_t ttl)
+	{
+		return relay.Open(group, port, mode, iface, ttl);
+	}
+
+	void LidarDriverUDP::LidarStopRelay()
+	{
+		relay.Close();
+	}
+
+	LidarRelayStats LidarDriverUDP::LidarGetRelayStats()
+	{
+		return relay.GetStats();
+	}
+
+	//real time para of the own reader thread 
+	bool LidarDriverUDP::LidarSetThreadPara(LidarThreadPara para)
+	{
+		if (lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+		thread_para = para;
+
+		return true;
+	}
+
+	//runtime statistics 
+	LidarStats LidarDriverUDP::LidarGetStats()
+	{
+		LidarStats stats;
+
+		metrics.Snapshot(stats);
+		stats.link = link_supervisor.GetStats();
+
+		return stats;
+	}
+
+	//read by the hub thread,one I/O thread for all the lidars in the hub 
+	bool LidarDriverUDP::LidarSetHub(LidarHub *hub)
+	{
+		if (lidar_state.m_CommOpen)		//own thread is running 
+		{
+			return false;
+		}
+		if ((udp_mux != NULL) && (hub != udp_mux->GetHub()))		//fed by the thread of the mux hub 
+		{
+			nvilidar::console.warning("udp mux lidar must be in the hub of the mux");
+			return false;
+		}
+
+		if (io_hub != NULL)
+		{
+			io_hub->Remove(io_hub_id);
+			io_hub = NULL;
+			io_hub_id = -1;
+		}
+		if (hub == NULL)
+		{
+			return true;
+		}
+
+		LidarHubSource source;
+		source.fd = [this]() {
+		#if defined(__linux__)
+			return lidar_state.m_CommOpen ? socket_udp.udpGetHandle() : -1;
+		#else
+			return -1;
+		#endif
+		};
+		source.read = [this]() { LidarReadData(); };
+		source.tick = [this]() { LidarPollTimer(); };
+		source.feed = [this](const uint8_t *buf, size_t len) {
+			if (lidar_state.m_CommOpen)
+			{
+				LidarFeedData(buf, len);
+			}
+		};
+		source.open_id = [this]() { return m_port_open_id; };
+
+		io_hub_id = hub->Add(source);
+		if (io_hub_id < 0)
+		{
+			return false;
+		}
+		io_hub = hub;
+
+		return true;
+	}
+
+	//id in the hub,-1:not in a hub 
+	int LidarDriverUDP::LidarGetHubId()
+	{
+		return io_hub_id;
+	}
+
+	//---------------------------------------private---------------------------------
+
+	//lidar start 
+	bool LidarDriverUDP::StartScan()
+	{
+		//serialport state 
+		if (!lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+		//is running 
+		if (lidar_state.m_Scanning)
+		{
+			return true;
+		}
+
+		//first circle false
+		m_first_circle_finish = false;
+		m_last_pack_angle = -1.0f;
+		m_last_pack_us = 0;
+
+		//send data 
+		if (!SendCommand(NVILIDAR_CMD_SCAN))
+		{
+			return false;
+		}
+
+		lidar_state.m_Scanning = true;
+		link_supervisor.Start(m_aim_speed, getMS());
+
+		return true;
+	}
+
+	//lidar stop 
+	bool  LidarDriverUDP::StopScan()
+	{
+		//lidar is scanning 
+		lidar_state.m_Scanning = false;
+		link_supervisor.Stop();
+
+		//发送数据
+		//send data 
+		SendCommand(NVILIDAR_CMD_STOP);
+
+		return true;
+	}
+
+	//启动雷达串口
+	bool LidarDriverUDP::LidarConnect(std::string ip_addr, uint16_t port)
+	{ 
+		//shared socket,the datagrams of ip:port are given by the mux 
+		if (udp_mux != NULL)
+		{
+			bool ret = udp_mux->IsOpen() && udp_mux->Add(ip_addr, port, [this](const uint8_t *buf, size_t len) {
+				if (lidar_state.m_CommOpen)
+				{
+					LidarFeedData(buf, len);
+				}
+			});
+			if (ret)
+			{
+				m_port_open_id++;
+			}
+			lidar_state.m_CommOpen = ret;
+
+			return ret;
+		}
+
+		socket_udp.udpInit(ip_addr.c_str(),port);
+		
+		if (socket_udp.isudpOpen())
+		{
+			m_port_open_id++;
+			lidar_state.m_CommOpen = true;
+			return true;
+		}
+		else
+		{
+			lidar_state.m_CommOpen = false;
+
+			return false;
+		}
+		return false;
+	}
+
+	//close serialport 
+	void LidarDriverUDP::LidarDisconnect()
+	{
+		lidar_state.m_CommOpen = false;
+		command_engine.CancelAll();		//no response any more 
+		closeThread();					//no read after the port is closed 
+		if (udp_mux != NULL)
+		{
+			udp_mux->Remove(lidar_cfg.ip_addr, lidar_cfg.lidar_udp_port);
+		}
+		socket_udp.udpClose();
+	}
+
+	//reopen socket only,thread,buffer and config are kept 
+	bool LidarDriverUDP::LidarReopen()
+	{
+		bool ret = false;
+
+		{
+			std::lock_guard<std::mutex> lock(link_mutex);
+			if (udp_mux != NULL)
+			{
+				ret = udp_mux->IsOpen();		//shared socket is kept 
+			}
+			else
+			{
+				socket_udp.udpClose();
+				socket_udp.udpInit(lidar_cfg.ip_addr.c_str(), lidar_cfg.lidar_udp_port);
+				ret = socket_udp.isudpOpen();
+				m_port_open_id++;
+			}
+		}
+
+		if (ret)
+		{
+			m_first_circle_finish = false;
+			m_last_pack_angle = -1.0f;
+			m_last_pack_us = 0;
+			ret = SendCommand(NVILIDAR_CMD_SCAN);		//lidar may be power off,start again 
+		}
+		link_supervisor.ReopenResult(ret, getMS());
+
+		if (ret)
+		{
+			nvilidar::console.message("[NVILIDAR INFO] reopen %s:%d ok,wait for data", lidar_cfg.ip_addr.c_str(), lidar_cfg.lidar_udp_port);
+		}
+		else
+		{
+			nvilidar::console.warning("reopen %s:%d fail,retry later", lidar_cfg.ip_addr.c_str(), lidar_cfg.lidar_udp_port);
+		}
+
+		return ret;
+	}
+
+	//send serial 
+	bool LidarDriverUDP::SendUDP(const uint8_t *data, size_t size)
+	{
+		if (!lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+
+		if (data == NULL || size == 0)
+		{
+			return false;
+		}
+
+		
+		//write data   
+		int r;
+		while (size) 
+		{
+			{
+				std::lock_guard<std::mutex> lock(link_mutex);
+				if (udp_mux != NULL)
+				{
+					r = udp_mux->Send(lidar_cfg.ip_addr, lidar_cfg.lidar_udp_port, data, size);
+				}
+				else
+				{
+					r = socket_udp.udpWriteData(data,size);
+				}
+			}
+			if (r < 1) 
+			{
+				return false;
+			}
+
+			size -= (size_t)r;
+			data += r;
+		}
+
+		return true;
+	}
+
+	//雷达发送数据
+	//send data 
+	bool LidarDriverUDP::SendCommand(uint8_t cmd, uint8_t *payload, uint16_t payloadsize)
+	{
+		uint8_t temp_buf[1024];
+		uint8_t checksum = 0;
+
+		//serialport not open 
+		if (!lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+
+		if ((payload != nullptr) && (payloadsize > 0))   //command long or short 
+		{
+			temp_buf[0] = NVILIDAR_START_BYTE_LONG_CMD;
+			temp_buf[1] = cmd;
+			temp_buf[2] = (uint8_t)(payloadsize & 0xFF);
+			temp_buf[3] = (uint8_t)(payloadsize >> 8);
+
+			for(int i = 0; i<payloadsize; i++){
+				temp_buf[4+i] = payload[i];
+				checksum ^= payload[i];
+			}
+			temp_buf[4+payloadsize] = checksum;
+			temp_buf[5+payloadsize] = NVILIDAR_END_CMD;
+
+			return SendUDP(temp_buf,6+payloadsize);
+		}
+		else
+		{
+			//short command 
+			temp_buf[0] = NVILIDAR_START_BYTE_SHORT_CMD;
+			temp_buf[1] = cmd;
+			
+			return SendUDP(temp_buf, 2);
+		}
+
+		return false;
+	}
+
+	//normal data unpack 
+	void LidarDriverUDP::NormalDataUnpack(const uint8_t *buf, uint16_t len)
+	{
+		for (int j = 0; j < len; j++)
+		{
+			uint8_t byte = buf[j];
+
+			switch (m_normal_recvPos)
+			{
+				case 0:		//first byte 
+				{
+					if (byte == NVILIDAR_START_BYTE_LONG_CMD)
+					{
+						m_normal_recvPos++;
+						break;
+					}
+					else
+					{
+						break;
+					}
+				}
+				case 1:		//second byte   
+				{
+					if (command_engine.IsResponseCmd(byte))		//dispatch table
+					{
+						m_normalResponseData.cmd = byte;
+						m_normal_recvPos++;
+					}
+					else
+					{
+						m_normalResponseData.cmd = 0;
+						m_normal_recvPos=0;
+					}
+					break;
+				}
+				case 2:		//third byte   
+				{
+					m_normalResponseData.length = byte;
+					m_normal_recvPos++;
+					break;
+				}
+				case 3:		
+				{
+					m_normalResponseData.length += byte * 256;
+					m_normal_recvPos++;
+					break;
+				}
+				default:	
+				{
+					if (m_normal_recvPos < m_normalResponseData.length + sizeof(Nvilidar_ProtocolHeader))			  
+					{
+						if (m_normal_recvPos >= sizeof(Nvilidar_ProtocolHeader))
+						{
+							if (m_normal_recvPos - sizeof(Nvilidar_ProtocolHeader) < 1024)
+							{
+								m_normal_crc ^= byte;
+								m_normalResponseData.dataInfo[m_normal_recvPos - sizeof(Nvilidar_ProtocolHeader)] = byte;
+							}
+							else
+							{
+								m_normal_crc = 0;
+								m_normal_recvPos = 0;
+								memset((char *)&m_normalResponseData, 0x00, sizeof(m_normalResponseData));
+							}
+						}
+						else
+						{
+							m_normal_crc = 0;
+							m_normal_recvPos = 0;
+							memset((char *)&m_normalResponseData,0x00,sizeof(m_normalResponseData));
+						}
+
+						m_normal_recvPos++;
+					}
+					else if (m_normal_recvPos == m_normalResponseData.length + sizeof(Nvilidar_ProtocolHeader))	//校验  
+					{
+						if (byte != m_normal_crc)
+						{
+							m_normal_recvPos = 0;
+							break;
+						}
+
+						m_normal_recvPos++;
+					}
+					else if (m_normal_recvPos == m_normalResponseData.length + sizeof(Nvilidar_ProtocolHeader) + 1)
+					{
+						if (byte != NVILIDAR_END_CMD)
+						{
+							m_normalResponseData.length = 0;
+							m_normalResponseData.cmd = 0;
+							m_normal_crc = 0;
+							m_normal_recvPos = 0;
+							break;
+						}
+
+						//data analysis 
+						command_engine.Dispatch(m_normalResponseData);
+
+						//value recovery  
+						m_normalResponseData.length = 0;
+						m_normalResponseData.cmd = 0;
+						m_normal_crc = 0;
+						m_normal_recvPos = 0;
+					}
+
+					break;
+				}
+			}
+		}
+	}
+
+	//点云数据解包 
+	bool LidarDriverUDP::PointDataUnpack(const uint8_t *buf,uint16_t len)
+	{
+		NVILIDAR_TRACE_SCOPE("PointDataUnpack");
+		uint8_t            rescan_buf[sizeof(Nvilidar_PackageBufTypeDef)];	//bytes of a wrong package,parse again 
+		size_t             rescan_len = 0;
+		size_t             rescan_pos = 0;
+		bool               resync = false;						//package is wrong,find the next header 
+		bool               checksum_error = false;				//resync for checksum error(else header error)
+		int                j = 0;
+
+		//循环 (rescan bytes first)
+		while ((rescan_pos < rescan_len) || (j < len))
+		{
+			bool from_rescan = (rescan_pos < rescan_len);
+			uint8_t byte = from_rescan ? rescan_buf[rescan_pos++] : buf[j++];
+
+			if (0 == m_raw_len)
+			{
+				m_raw_rescan = from_rescan;
+			}
+			m_raw_buf[m_raw_len++] = byte;
+
+			switch (m_recvPos)
+			{
+				case 0:     //第一个字节 包头
+				{
+					if (byte == (uint8_t)(NVILIDAR_POINT_HEADER & 0xFF))
+					{
+						m_pack_read_us = m_read_us;		//time of the first byte 
+						m_recvPos++;      //index后移
+						//printf("get first head\n");
+					}
+					else        //没收到 直接发下一包
+					{
+						m_raw_len = 0;
+						metrics.Add(NVILIDAR_METRIC_BYTES_DISCARDED);
+						break;
+					}
+					break;
+				}
+				case 1:     //第二字节  包头信息
+				{
+					if (byte == (uint8_t)(NVILIDAR_POINT_HEADER >> 8))
+					{
+						m_pack_info.packageCheckSumCalc = NVILIDAR_POINT_HEADER; //更新校验值
+						m_recvPos++;      //index后移
+						//printf("get second head\n");
+					}
+					else
+					{
+						m_pack_info.packageErrFlag = true;      //包头错误鸟
+						resync = true;
+					}
+					break;
+				}
+				case 2:     //频率或温度等信息
+				{
+					m_checksum_temp = byte;     //校验赋值
+
+					//0度角或其它信息
+					if (1 == m_package_after_0c_index)  //其它  0位后第1包为  温度值
+					{
+						m_pack_info.packageHas0CFirst = false;
+						m_pack_info.packageHasTempFirst = true;
+					}
+					else if (byte & 0x01)     //最低位是0位
+					{
+						m_pack_info.packageHas0CFirst = true;
+						m_pack_info.packageHasTempFirst = false;
+					}
+					else        //其它情况  该位置不含其它信息
+					{
+						m_pack_info.packageHas0CFirst = false;
+						m_pack_info.packageHasTempFirst = false;
+					}
+					m_recvPos++;      //index后移
+					break;
+				}
+				case 3:         //频率或者温度
+				{
+					m_checksum_temp += (byte * 256);     //校验计算
+					m_pack_info.packageCheckSumCalc ^= m_checksum_temp; //校验计算
+
+
+					if (m_pack_info.packageHas0CFirst)  //可能有0度
+					{
+						m_pack_info.packageHas0CFirst = false;
+						m_pack_info.packageHasTemp = false;
+
+						if (byte & 0x80)
+						{
+
+							m_package_after_0c_index = 0;     //0位包  则将0度后的个数  清0
+
+							m_pack_info.packageHas0CAngle = true;
+							m_pack_info.packageFreq = (m_checksum_temp & 0x7FFF) >> 1;
+						}
+						else
+						{
+							m_pack_info.packageHas0CAngle = false;
+						}
+					}
+					else if (m_pack_info.packageHasTempFirst)    //是温度计算信息
+					{
+
+						m_pack_info.packageHasTempFirst = false;
+
+						m_pack_info.packageHas0CAngle = false;
+
+
+						m_pack_info.packageHasTemp = true;
+						m_pack_info.packageTemp = (int16_t)(m_checksum_temp);
+					}
+					else
+					{
+
+						m_pack_info.packageHas0CAngle = false;
+						m_pack_info.packageHasTemp = false;
+					}
+					m_package_after_0c_index++;     //0度后的包数目
+
+					m_recvPos++;      //index后移
+					break;
+				}
+				case 4:     //包数目
+				{
+					m_checksum_packnum_index = byte;
+
+					if (byte != 0)
+					{
+						m_pack_info.packagePointNum = byte;
+						m_recvPos++;      //index后移
+					}
+					else
+					{
+						m_pack_info.packagePointNum = 0;
+						m_pack_info.packageErrFlag = true;      //包头错误鸟
+						resync = true;
+					}
+					break;
+				}
+				case 5:     //0度索引
+				{
+					m_checksum_packnum_index += (uint16_t)byte * 256;
+					m_pack_info.packageCheckSumCalc ^= m_checksum_packnum_index; //校验计算
+
+					if (m_pack_info.packageHas0CAngle)       //如果是0c  则会告知0c index
+					{
+						if (byte > 0)
+						{
+							m_pack_info.package0CIndex = byte - 1;      //0度角
+						}
+						else
+						{
+							m_pack_info.package0CIndex = 0;
+						}
+						//printf("0c index:%d\r\n",packageInfo.package0CIndex);
+					}
+
+
+					m_recvPos++;
+					break;
+				}
+				case 6:             //起始角度低位
+				{
+					if (byte & NVILIDAR_RESP_MEASUREMENT_CHECKBIT)
+					{
+						m_checksum_temp = byte;
+						m_recvPos++;      //index后移
+					}
+					else
+					{
+						m_pack_info.packageErrFlag = true;
+						resync = true;
+					}
+					break;
+				}
+				case 7:             //起始角度高位
+				{
+					m_checksum_temp += (uint16_t)byte * 256;
+					m_pack_info.packageCheckSumCalc ^= m_checksum_temp;
+					m_pack_info.packageFirstAngle = m_checksum_temp >> 1;
+
+					//printf("first angle = %f\n",(float)pointViewerPackageInfo.packageFirstAngle/64.0f);
+
+					m_recvPos++;      //index后移
+					break;
+				}
+				case 8:             //结束角低位
+				{
+					if (byte & NVILIDAR_RESP_MEASUREMENT_CHECKBIT)
+					{
+						m_checksum_temp = byte;
+
+						//  printf("last_angle_l = %d\n",package_last_angle_temp);
+
+						m_recvPos++;      //index后移
+					}
+					else
+					{
+						m_pack_info.packageErrFlag = true;
+						resync = true;
+					}
+					break;
+				}
+				case 9:             //结束角高位
+				{
+					m_checksum_temp += (uint16_t)byte * 0x100;
+					m_pack_info.packageCheckSumCalc ^= m_checksum_temp;
+					m_pack_info.packageLastAngle = m_checksum_temp >> 1;
+
+					//printf("last angle = %f\n",(float)packageInfo.packageLastAngle/64.0f);
+
+					//计算每个角度之间的差值信息
+					if (1 == m_pack_info.packagePointNum)  //只有一个点  则没有差值
+					{
+						m_pack_info.packageAngleDiffer = 0;
+					}
+					else
+					{
+						//结束角小于起始角
+						if (m_pack_info.packageLastAngle < m_pack_info.packageFirstAngle)
+						{
+							//270~90度
+							if ((m_pack_info.packageFirstAngle > 270 * NVILIDAR_ANGULDAR_RESOLUTION) && (m_pack_info.packageLastAngle < 90 * NVILIDAR_ANGULDAR_RESOLUTION))
+							{
+								m_pack_info.packageAngleDiffer =
+									(float)((float)(360 * NVILIDAR_ANGULDAR_RESOLUTION + m_pack_info.packageLastAngle - m_pack_info.packageFirstAngle) /
+									((float)(m_pack_info.packagePointNum - 1)));
+								m_pack_info.packageLastAngleDiffer = m_pack_info.packageAngleDiffer;
+							}
+							else
+							{
+								m_pack_info.packageAngleDiffer = m_pack_info.packageLastAngleDiffer;
+							}
+						}
+						//结束角大于等于起始角
+						else
+						{
+							m_pack_info.packageAngleDiffer =
+								(float)((float)(m_pack_info.packageLastAngle - m_pack_info.packageFirstAngle) /
+								(float)(m_pack_info.packagePointNum - 1));
+							m_pack_info.packageLastAngleDiffer = m_pack_info.packageAngleDiffer;
+						}
+					}
+
+					m_recvPos++;      //index后移
+
+					break;
+				}
+				case 10:    //校验低位
+				{
+					m_pack_info.packageCheckSumGet = byte;
+
+					m_recvPos++;      //index后移
+					break;
+				}
+				case 11:     //校验高位
+				{
+					m_pack_info.packageCheckSumGet += byte * 256;
+
+					//计算基本信息 
+					if (m_has_sensitive)
+					{
+						m_pack_info.packagePointDistSize = 4;
+					}
+					else
+					{
+						m_pack_info.packagePointDistSize = 2;
+					}
+					m_remain_size = m_pack_info.packagePointNum * m_pack_info.packagePointDistSize; //剩余的距离数据信息
+
+
+					m_recvPos++;      //index后移
+
+					break;
+				}
+				default:
+				{
+					//samples,take the rest of this package in the buffer at once 
+					size_t need = NVILIDAR_POINT_PACKAGE_HEAD_SIZE + m_remain_size - m_recvPos - 1;
+					size_t avail = from_rescan ? (rescan_len - rescan_pos) : (size_t)(len - j);
+					size_t take = (need < avail) ? need : avail;
+
+					memcpy(m_raw_buf + m_raw_len, from_rescan ? (rescan_buf + rescan_pos) : (buf + j), take);
+					m_raw_len += take;
+					if (from_rescan)
+					{
+						rescan_pos += take;
+					}
+					else
+					{
+						j += take;
+					}
+					m_recvPos += 1 + take;
+
+					//所有数据接完了 
+					if (m_recvPos == NVILIDAR_POINT_PACKAGE_HEAD_SIZE + m_remain_size)
+					{
+						uint16_t sum_word = 0;
+						//计算校验
+						for (size_t k = 0; k < m_remain_size; k++)
+						{
+							if (k % 2 == 0)
+							{
+								sum_word = m_raw_buf[NVILIDAR_POINT_PACKAGE_HEAD_SIZE + k];  //低位
+							}
+							else
+							{
+								sum_word += (uint16_t)(m_raw_buf[NVILIDAR_POINT_PACKAGE_HEAD_SIZE + k]) * 256;
+								m_pack_info.packageCheckSumCalc ^= sum_word;
+							}
+						}
+						//判断校验  
+						if (m_pack_info.packageCheckSumCalc == m_pack_info.packageCheckSumGet)
+						{
+							//获取时间戳 起始&结束 (包尾时间 非真实时间) every package,a circle may be closed at angle wrap 
+							m_pack_info.packageStamp = getStamp();
+							//计算一圈点的数据信息 (点数据直接从接收的字节中读取)
+							m_pack_info.packageSamples = m_raw_buf + NVILIDAR_POINT_PACKAGE_HEAD_SIZE;
+							PointDataAnalysis(m_pack_info);
+							if ((NVILIDAR_RELAY_RAW == relay.GetMode()) && relay.IsOpen())
+							{
+								relay_buf.insert(relay_buf.end(), m_raw_buf, m_raw_buf + m_raw_len);
+							}
+
+							metrics.Add(NVILIDAR_METRIC_PACKAGES_VALID);
+							if (m_raw_rescan)
+							{
+								metrics.Add(NVILIDAR_METRIC_PACKAGES_RECOVERED);
+							}
+							uint64_t now_us = getUS();
+							if (m_last_pack_us != 0)
+							{
+								metrics.Record(NVILIDAR_METRIC_PACKAGE_INTERVAL_US, now_us - m_last_pack_us);
+							}
+							m_last_pack_us = now_us;
+							m_circle_packages++;
+							m_raw_len = 0;
+						}
+						else
+						{
+							resync = true;		//checksum error 
+							checksum_error = true;
+						}
+						//清空所有数据  
+						memset((uint8_t *)(&m_pack_info), 0x00, sizeof(Nvilidar_PointViewerPackageInfoTypeDef));
+						m_checksum_temp = 0;        				//临时校验信息 
+						m_checksum_packnum_index = 0;     		//包数目和0位索引校验
+						m_recvPos = 0;                    //当前接到的位置信息
+						m_remain_size = 0;			//接完包头剩下来的数据信息 
+					}
+					break;
+				}
+			}
+
+			//wrong package,the header may be in the received bytes,find it and parse again 
+			if (resync)
+			{
+				size_t k = 1;
+				size_t rest = rescan_len - rescan_pos;
+
+				resync = false;
+				while ((k < m_raw_len) && (m_raw_buf[k] != (uint8_t)(NVILIDAR_POINT_HEADER & 0xFF)))
+				{
+					k++;
+				}
+				metrics.Add(checksum_error ? NVILIDAR_METRIC_CHECKSUM_ERRORS : NVILIDAR_METRIC_HEADER_ERRORS);
+				metrics.Add(NVILIDAR_METRIC_BYTES_DISCARDED, k);
+				checksum_error = false;
+
+				//rescan = bytes after the wrong header + bytes not rescanned yet 
+				memmove(rescan_buf + (m_raw_len - k), rescan_buf + rescan_pos, rest);
+				memcpy(rescan_buf, m_raw_buf + k, m_raw_len - k);
+				rescan_len = m_raw_len - k + rest;
+				rescan_pos = 0;
+
+				//清空所有数据  
+				memset((uint8_t *)(&m_pack_info), 0x00, sizeof(Nvilidar_PointViewerPackageInfoTypeDef));
+				m_checksum_temp = 0;
+				m_checksum_packnum_index = 0;
+				m_recvPos = 0;
+				m_remain_size = 0;
+				m_raw_len = 0;
+			}
+		}
+		return false;
+	}
+
+	//点云数据解包 
+	void LidarDriverUDP::PointDataAnalysis(const Nvilidar_PointViewerPackageInfoTypeDef &pack_point)
+	{
+		NVILIDAR_TRACE_SCOPE("PointDataAnalysis");
+		bool  circle_wrap = false;		//zero angle package is lost,close the circle at angle wrap 
+		float first_angle = (float)(pack_point.packageFirstAngle) / (float)(NVILIDAR_ANGULDAR_RESOLUTION);
+		float angle_step = pack_point.packageAngleDiffer / (float)(NVILIDAR_ANGULDAR_RESOLUTION);
+
+		//temperature is in the package after the 0 angle package 
+		if (pack_point.packageHasTemp)
+		{
+			health_monitor.Temperature((float)(pack_point.packageTemp) / 10.0f);
+		}
+
+		//angle continuity with the last package 
+		if (m_last_pack_angle >= 0.0f)
+		{
+			//angle go back,but no zero angle package 
+			if ((!pack_point.packageHas0CAngle) && (first_angle + 180.0f < m_last_pack_angle))
+			{
+				circle_wrap = true;
+			}
+
+			//angle gap,some packages are lost or wrong 
+			float gap = first_angle - m_last_pack_angle - angle_step;
+			if (gap < -180.0f)
+			{
+				gap += 360.0f;
+			}
+			if ((angle_step > 0.0f) && (gap > angle_step * 0.5f))
+			{
+				uint32_t points = (uint32_t)(gap / angle_step + 0.5f);
+				uint32_t packages = (points + pack_point.packagePointNum / 2) / pack_point.packagePointNum;
+
+				m_circle_gap_count++;
+				m_circle_missing_points += points;
+				m_circle_missing_packages += (packages > 0) ? packages : 1;
+			}
+		}
+		//close the circle before this package 
+		if (circle_wrap)
+		{
+			m_curr_circle_count = m_point_list.size();
+		}
+
+		//计算数据信息 按列追加到数据区内 
+		Nvilidar_Package_Meta meta;
+		meta.stamp = pack_point.packageStamp;
+		meta.point_time = pack_point.packagePointTime;           //采样率
+		meta.first_point = 0;
+		meta.point_num = pack_point.packagePointNum;
+		meta.first_angle = pack_point.packageFirstAngle;
+		meta.angle_differ = pack_point.packageAngleDiffer;
+
+		//是0度角 取到一圈的真实的点数信息 
+		if ((pack_point.packageHas0CAngle) && (pack_point.package0CIndex < pack_point.packagePointNum))
+		{
+			m_curr_circle_count = m_point_list.size() + pack_point.package0CIndex;
+		}
+		if (m_has_sensitive)
+		{
+			m_point_list.AppendPackage(meta, (const Nvilidar_Protocol_PackageNode_Quality *)(pack_point.packageSamples));
+		}
+		else
+		{
+			m_point_list.AppendPackage(meta, (const Nvilidar_Protocol_PackageNode_NoQualiry *)(pack_point.packageSamples));
+		}
+		if (m_point_list.size() > 0)
+		{
+			m_last_pack_angle = m_point_list.Angle(m_point_list.size() - 1);
+		}
+
+		//找到点数信息 (zero angle package,or angle wrap when it is lost)
+		if(pack_point.packageHas0CAngle || circle_wrap)
+		{
+			uint32_t  all_pack_time;
+			uint32_t  all_count = 0;
+			uint32_t  circle_count = 0;
+			uint64_t  stamp_temp = 0;
+			uint64_t  stamp_differ = 0;
+
+			m_run_circles++;		//包数目++ 
+			if (pack_point.packageHas0CAngle)
+			{
+				link_supervisor.SetSpeed((float)(pack_point.packageFreq) / 100.0f);		//stall timeout follow the real speed 
+				health_monitor.Speed((float)(pack_point.packageFreq) / 100.0f);
+			}
+
+			//gap info of this circle 
+			circleDataInfo.zeroLost = circle_wrap;
+			circleDataInfo.gapCount = m_circle_gap_count;
+			circleDataInfo.missingPackages = m_circle_missing_packages;
+			circleDataInfo.missingPoints = m_circle_missing_points;
+			circleDataInfo.firstByteUs = m_pack_read_us;
+			m_circle_gap_count = 0;
+			m_circle_missing_packages = 0;
+			m_circle_missing_points = 0;
+
+			all_count = m_point_list.size();		//上个零位包开始到本包结束了（到结尾，用来算真实时间戳）
+			circle_count = m_curr_circle_count;
+
+			m_point_list.MoveFront(m_curr_circle_count, circleDataInfo.lidarCirclePoints);		//取前半部分的值  后半部分是下一圈的数据 
+			m_curr_circle_count = 0;
+
+			//计算时间差  按比例减掉多传的时间  最后一包 踢掉后面的点所用的时间  重算时间戳 
+			if (circleDataInfo.stopStamp == 0)
+			{
+				stamp_temp = pack_point.packageStamp;
+			}
+			else
+			{
+				stamp_differ = pack_point.packageStamp - circleDataInfo.stopStamp;
+				stamp_temp = pack_point.packageStamp - (stamp_differ * (all_count - circle_count) / all_count);
+			}
+
+			//计算 
+			circleDataInfo.startStamp = circleDataInfo.stopStamp;
+			//判断是否有非法值 
+			if (m_run_circles <= 8)
+			{
+				circleDataInfo.stopStamp = pack_point.packageStamp;
+			}
+			else
+			{
+				circleDataInfo.stopStamp = stamp_temp;
+
+				//uint64_t diff = circleDataInfo.stopStamp - circleDataInfo.startStamp;
+				//printf("time differ:%lu\r\n", diff);
+			}
+			//按比例重算结束时间 因为一包固定128点 0位可能出在任意位置  会影响时间戳精确度 
+			//printf("pack_num:%d,indx:%d\r\n", circleDataInfo.lidarCirclePoints.size(), pack_point.package0CIndex);
+
+			//circle statistics 
+			uint64_t now_us = getUS();
+			metrics.Add(NVILIDAR_METRIC_CIRCLES);
+			metrics.Add(NVILIDAR_METRIC_MISSING_PACKAGES, circleDataInfo.missingPackages);
+			if (circle_wrap)
+			{
+				metrics.Add(NVILIDAR_METRIC_ZERO_LOST);
+			}
+			metrics.Set(NVILIDAR_METRIC_POINTS_PER_CIRCLE, circleDataInfo.lidarCirclePoints.size());
+			metrics.Record(NVILIDAR_METRIC_POINTS_HIST, circleDataInfo.lidarCirclePoints.size());
+			metrics.Set(NVILIDAR_METRIC_PACKAGES_PER_CIRCLE, m_circle_packages);
+			m_circle_packages = 0;
+			if (m_last_circle_us != 0)
+			{
+				metrics.Set(NVILIDAR_METRIC_CIRCLE_PERIOD_US, now_us - m_last_circle_us);
+				metrics.Record(NVILIDAR_METRIC_CIRCLE_PERIOD_HIST_US, now_us - m_last_circle_us);
+			}
+			m_last_circle_us = now_us;
+			health_monitor.Circle(getStamp(), metrics.Get(NVILIDAR_METRIC_PACKAGES_VALID) + metrics.Get(NVILIDAR_METRIC_HEADER_ERRORS) +
+								metrics.Get(NVILIDAR_METRIC_CHECKSUM_ERRORS), metrics.Get(NVILIDAR_METRIC_CHECKSUM_ERRORS));
+
+			if (m_run_circles > 3)
+			{
+				setCircleResponseUnlock();		//解锁  告知已接到一包数据信息 
+			}
+		}
+	}
+
+
+	//-------------------------------------对外接口信息-------------------------------------------
+
+	//获取SDK版本号
+	std::string LidarDriverUDP::getSDKVersion()
+	{
+		return NVILIDAR_SDKVerision;
+	}
+
+	//设置雷达是否带信号质量信息
+	bool LidarDriverUDP::SetIntensities(const uint8_t has_intensity, uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+		uint8_t   cmd;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		cmd = (has_intensity ? NVILIDAR_CMD_SET_HAVE_INTENSITIES : NVILIDAR_CMD_SET_NO_INTENSITIES);
+		//发送命令 等待应答
+		if (!command_engine.Command(cmd, NULL, 0, response, timeout))
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	//获取设备类型信息
+	bool LidarDriverUDP::GetDeviceInfo(Nvilidar_DeviceInfo &info, uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+		Nvilidar_Protocol_DeviceInfo device_info;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_GET_DEVICE_INFO, NULL, 0, response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&device_info), response.dataInfo, sizeof(device_info));
+
+		uint8_t productNameTemp[6] = { 0 };
+		memcpy(productNameTemp, device_info.MODEL_NUM,5);
+
+		//生成字符信息
+		info.m_SoftVer = formatString("V%d.%d", device_info.SW_V[0], device_info.SW_V[1]);
+		info.m_HardVer = formatString("V%d.%d", device_info.HW_V[0], device_info.HW_V[1]);
+		info.m_ProductName = formatString("%s", productNameTemp);
+		info.m_SerialNum = formatString("%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d%01d",
+			device_info.serialnum[0], device_info.serialnum[1], device_info.serialnum[2], device_info.serialnum[3],
+			device_info.serialnum[4], device_info.serialnum[5], device_info.serialnum[6], device_info.serialnum[7],
+			device_info.serialnum[8], device_info.serialnum[9], device_info.serialnum[10], device_info.serialnum[11],
+			device_info.serialnum[12], device_info.serialnum[13], device_info.serialnum[14], device_info.serialnum[15]);
+
+		return true;
+	}
+
+
+	//复位雷达
+	bool LidarDriverUDP::Reset(void)
+	{
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		if (!SendCommand(NVILIDAR_CMD_GET_DEVICE_INFO))
+		{
+			return false;
+		}
+
+		delayMS(800);
+
+		return true;
+	}
+
+	//设置雷达转速信息
+	bool LidarDriverUDP::SetScanMotorSpeed(uint16_t frequency, uint16_t &ret_frequency,
+		uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_AIMSPEED,
+			((uint8_t*)(&frequency)), sizeof(frequency), response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&ret_frequency), response.dataInfo, sizeof(ret_frequency));
+
+		return true;
+	}
+
+	//增加雷达采样率
+	bool LidarDriverUDP::SetSamplingRate(uint32_t rate_write, uint32_t &rate,
+		uint32_t timeout)   //雷达采样率增加
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_SAMPLING_RATE,
+			((uint8_t*)(&rate_write)), sizeof(rate_write), response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&rate), response.dataInfo, sizeof(rate));
+
+		return true;
+	}
+
+
+	//读取角度偏移
+	bool LidarDriverUDP::GetZeroOffsetAngle(int16_t &angle, uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_GET_ANGLE_OFFSET, NULL, 0, response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&angle), response.dataInfo, sizeof(angle));
+
+		return true;
+	}
+
+	//设置角度偏移
+	bool LidarDriverUDP::SetZeroOffsetAngle(int16_t angle_set, int16_t &angle,
+		uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_ANGLE_OFFSET,
+			((uint8_t*)(&angle_set)), sizeof(angle_set), response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&angle), response.dataInfo, sizeof(angle));
+
+		return true;
+	}
+
+	//get the lidar quality filter
+	bool LidarDriverUDP::GetFilterQualityThreshold(uint16_t &ret_filter_quality,uint32_t timeout){
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning){
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_GET_QUALITY_THRESHOLD, NULL, 0, response, timeout)){
+			return false;
+		}
+		memcpy((char *)(&ret_filter_quality), response.dataInfo, sizeof(ret_filter_quality));
+
+		return true;
+	}
+
+	//set the lidar quality filter
+	bool LidarDriverUDP::SetFilterQualityThreshold(uint16_t filter_quality_set, uint16_t &ret_filter_quality,uint32_t timeout){
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning){
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_QUALITY_THRESHOLD,(uint8_t *)(&filter_quality_set), sizeof(filter_quality_set), response, timeout)){
+			return false;
+		}
+		memcpy((char *)(&ret_filter_quality), response.dataInfo, sizeof(ret_filter_quality));
+
+		return true;
+	}
+
+	//设置拖尾等级
+	bool LidarDriverUDP::SetTrailingLevel(uint8_t tailing_set, uint8_t &tailing,
+		uint32_t  timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_TAILING_LEVEL, (uint8_t *)(&tailing_set), sizeof(tailing_set), response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&tailing), response.dataInfo, sizeof(tailing));
+
+		return true;
+	}
+
+	//获取雷达配置信息
+	bool LidarDriverUDP::GetLidarCfg(Nvilidar_StoreConfigTypeDef &info, uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+		Nvilidar_Protocol_GetPara get_para;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_GET_LIDAR_CFG, NULL, 0, response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&get_para), response.dataInfo, sizeof(get_para));
+
+		//生成字符信息
+		info.aimSpeed = get_para.aimSpeed;
+		info.isHasSensitive = get_para.hasSensitive;
+		info.samplingRate = get_para.samplingRate;
+		info.tailingLevel = get_para.tailingLevel;
+		info.apdValue = get_para.apdValue;
+
+		return true;
+	}
+
+	//设置灵敏度
+	bool LidarDriverUDP::SetApdValue(uint16_t apd_set, uint16_t &apd,uint32_t  timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if (lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SET_APD_VALUE, (uint8_t *)(&apd_set), sizeof(apd_set), response, timeout))
+		{
+			return false;
+		}
+		memcpy((char *)(&apd), response.dataInfo, sizeof(apd));
+
+		return true;
+	}
+
+	//保存雷达参数
+	bool LidarDriverUDP::SaveCfg(bool &flag, uint32_t timeout)
+	{
+		Nvilidar_Protocol_NormalResponseData response;
+
+		//先停止雷达 如果雷达在运行 
+		if(lidar_state.m_Scanning)
+		{
+			StopScan();
+		}
+
+		//发送命令 等待应答
+		if (!command_engine.Command(NVILIDAR_CMD_SAVE_LIDAR_PARA, NULL, 0, response, timeout))
+		{
+			return false;
+		}
+		flag = (bool)(response.dataInfo[0]);
+
+		return true;
+	}
+
+	//async command,response is matched by command byte
+	std::shared_future<LidarCommandResult> LidarDriverUDP::LidarCommandAsync(uint8_t cmd, const uint8_t *payload, uint16_t size,
+							LidarCommandCallback callback, uint32_t timeout, uint8_t retries)
+	{
+		return command_engine.CommandAsync(cmd, payload, size, callback, timeout, retries);
+	}
+
+	//获取当前扫描状态
+	bool LidarDriverUDP::LidarGetScanState()
+	{
+		return lidar_state.m_Scanning;
+	}
+
+	//get lidar name  
+	LidarModelListEnumTypeDef LidarDriverUDP::GetLidarModelName(Nvilidar_DeviceInfo info){
+		std::string modelNum_String = info.m_ProductName;
+		std::string::size_type pos;
+
+		//ROC300
+		pos = modelNum_String.find("VP300");
+		if(pos != std::string::npos){
+			return NVILIDAR_ROC300;
+		}
+		pos = modelNum_String.find("R300");
+		if(pos != std::string::npos){
+			return NVILIDAR_ROC300;
+		}
+
+		//VP350 
+		pos = modelNum_String.find("VP350");
+		if(pos != std::string::npos){
+			return NVILIDAR_VP350;
+		}
+		pos = modelNum_String.find("VP351");
+		if(pos != std::string::npos){
+			return NVILIDAR_VP350;
+		}
+
+		return NVILIDAR_Unknow;
+	}
+
+	//---------------------------------------------thread API----------------------------------------------
+	//init thread 
+	bool LidarDriverUDP::createThread()
+	{
+		#if	defined(_WIN32)
+			/*
+			创建线程函数详细说明
+			*HANDLE WINAPI CreateThread(
+			__in_opt  LPSECURITY_ATTRIBUTES lpThreadAttributes,
+			__in      SIZE_T dwStackSize,
+			__in      LPTHREAD_START_ROUTINE lpStartAddress,
+			__in_opt __deref __drv_aliasesMem LPVOID lpParameter,
+			__in      DWORD dwCreationFlags,
+			__out_opt LPDWORD lpThreadId
+			);
+			*返回值：函数成功，返回线程句柄；函数失败返回false。若不想返回线程ID,设置值为NULL
+			*参数说明：
+			*lpThreadAttributes	线程安全性，使用缺省安全性,一般缺省null
+			*dwStackSize	堆栈大小，0为缺省大小
+			*lpStartAddress	线程要执行的函数指针，即入口函数
+			*lpParameter	线程参数
+			*dwCreationFlags	线程标记，如为0，则创建后立即运行
+			*lpThreadId	LPDWORD为返回值类型，一般传递地址去接收线程的标识符，一般设为null
+			*/
+			//read by the hub thread(mux:fed by it) 
+			if ((io_hub != NULL) || (udp_mux != NULL))
+			{
+				_event_circle = CreateEvent(NULL, false, false, NULL);
+				return (_event_circle != NULL);
+			}
+
+			closeThread();			//the last one,reinit without close 
+			m_thread_stop = false;
+			LidarApplyReadMode();
+			_thread = CreateThread(NULL, 0, LidarDriverUDP::periodThread, this, 0, NULL);
+			if (_thread == NULL)
+			{
+				return false;
+			}
+
+
+
+			//一圈点的数据信息 信息同步 
+			_event_circle = CreateEvent(NULL, false, false, NULL);;
+			if (_event_circle == NULL)
+			{
+				return false;
+			}
+			ResetEvent(_event_circle);
+
+			return true;
+		#else 
+			//sync connect  
+			pthread_cond_init(&_cond_point, NULL);
+    		pthread_mutex_init(&_mutex_point, NULL);
+
+			//read by the hub thread(mux:fed by it) 
+			if ((io_hub != NULL) || (udp_mux != NULL))
+			{
+				return true;
+			}
+
+			//create thread 
+			closeThread();			//the last one,reinit without close 
+			m_thread_stop = false;
+			LidarApplyReadMode();
+     		if(0 != pthread_create(&_thread, NULL, LidarDriverUDP::periodThread, this))
+     		{
+				 _thread = -1;
+         		return false;
+			}
+
+			return true;
+
+		#endif 
+	}
+
+	//non-blocking port for busy poll,kept by the reopen 
+	void LidarDriverUDP::LidarApplyReadMode()
+	{
+		bool busy = (NVILIDAR_READ_BUSY_POLL == thread_para.read_mode);
+		if (!socket_udp.udpSetBusyPoll(busy ? NVILIDAR_RT_BUSY_POLL_US : -1))
+		{
+			nvilidar::console.warning("set busy poll of the port failed");
+		}
+	}
+
+	//stop the thread and wait for it,the read returns in the read timeout 
+	//a callback in the thread may close the lidar,the thread is detached then 
+	void LidarDriverUDP::closeThread()
+	{
+		m_thread_stop = true;
+		#if	defined(_WIN32)
+			if (_thread != NULL)
+			{
+				if (GetCurrentThreadId() != GetThreadId(_thread))
+				{
+					WaitForSingleObject(_thread, INFINITE);
+				}
+				CloseHandle(_thread);
+				_thread = NULL;
+			}
+		#else 
+			if (_thread != (pthread_t)-1)
+			{
+				if (pthread_equal(_thread, pthread_self()))
+				{
+					pthread_detach(_thread);
+				}
+				else
+				{
+					pthread_join(_thread, NULL);
+				}
+				_thread = (pthread_t)-1;
+			}
+		#endif 
+	}
+
+	//等待一圈点云 事件 
+	bool LidarDriverUDP::LidarSamplingProcess(LidarScan &scan, uint32_t timeout)
+	{
+		//auto timeout,N circles of the lidar speed 
+		if (NVILIDAR_POINT_TIMEOUT_AUTO == timeout)
+		{
+			timeout = link_supervisor.GetWaitTimeout();
+		}
+
+		//等待解锁  即一圈点数据完成了  
+		#if	defined(_WIN32)
+			bool taken = false;
+			WaitForSingleObject(_event_circle, timeout);		//auto reset,a circle not taken yet is returned at once 
+			{
+				std::lock_guard<std::mutex> lock(_mutex_circle);
+				taken = m_circle_pending;
+				if (taken)
+				{
+					LidarTakeCircle();			//swapped under the lock,the reader fills the other buffer 
+				}
+			}
+			if (taken){
+				uint64_t start_us = getUS();
+				NVILIDAR_TRACE_INSTANT("circle_taken");
+				//sdk para changed,take effect from this circle 
+				LidarApplySdkPara();
+				//data filter 
+				lidar_filter.LidarNoiseFilter(circle_taken.lidarCirclePoints);
+				uint64_t filter_us = getUS();
+				//filter change 
+				LidarSamplingData(circle_taken, scan);
+				//output statistics 
+				uint64_t stop_us = getUS();
+				scan.latency.first_byte_us = circle_taken.firstByteUs;
+				scan.latency.decode_us = circle_taken_us;
+				scan.latency.filter_us = filter_us;
+				scan.latency.handoff_us = stop_us;
+				latency_window.Record(scan.latency);
+				metrics.Record(NVILIDAR_METRIC_PROCESS_US, stop_us - start_us);
+				metrics.Record(NVILIDAR_METRIC_DELIVERY_US, stop_us - circle_taken_us);
+				metrics.Add(NVILIDAR_METRIC_SCANS_OUTPUT);
+				if ((NVILIDAR_RELAY_SCAN == relay.GetMode()) && relay.IsOpen())
+				{
+					relay.PublishScan(scan);
+				}
+				return true;
+			}	
+		#else 
+			struct timeval now;
+    		struct timespec outtime;
+			int state = 0;
+
+			pthread_mutex_lock(&_mutex_point);
+ 
+			gettimeofday(&now, NULL);
+			outtime.tv_sec = now.tv_sec + timeout / 1000;
+			outtime.tv_nsec = now.tv_usec * 1000 + (timeout % 1000) * 1000000;
+			if (outtime.tv_nsec >= 1000000000)
+			{
+				outtime.tv_sec += 1;
+				outtime.tv_nsec -= 1000000000;
+			}
+		
+			while ((!m_circle_pending) && (0 == state))		//a circle not taken yet is returned at once 
+			{
+				state = pthread_cond_timedwait(&_cond_point, &_mutex_point, &outtime);
+			}
+			state = m_circle_pending ? 0 : -1;
+			if (0 == state)
+			{
+				LidarTakeCircle();			//swapped under the lock,the reader fills the other buffer 
+			}
+			pthread_mutex_unlock(&_mutex_point);
+
+			if(0 == state){
+				uint64_t start_us = getUS();
+				NVILIDAR_TRACE_INSTANT("circle_taken");
+				//sdk para changed,take effect from this circle 
+				LidarApplySdkPara();
+				//data filter 
+				lidar_filter.LidarNoiseFilter(circle_taken.lidarCirclePoints);
+				uint64_t filter_us = getUS();
+				//filter change 
+				LidarSamplingData(circle_taken, scan);
+				//output statistics 
+				uint64_t stop_us = getUS();
+				scan.latency.first_byte_us = circle_taken.firstByteUs;
+				scan.latency.decode_us = circle_taken_us;
+				scan.latency.filter_us = filter_us;
+				scan.latency.handoff_us = stop_us;
+				latency_window.Record(scan.latency);
+				metrics.Record(NVILIDAR_METRIC_PROCESS_US, stop_us - start_us);
+				metrics.Record(NVILIDAR_METRIC_DELIVERY_US, stop_us - circle_taken_us);
+				metrics.Add(NVILIDAR_METRIC_SCANS_OUTPUT);
+				if ((NVILIDAR_RELAY_SCAN == relay.GetMode()) && relay.IsOpen())
+				{
+					relay.PublishScan(scan);
+				}
+				return true;
+			}
+		#endif
+
+		metrics.Add(NVILIDAR_METRIC_SAMPLING_TIMEOUTS);
+		return false;
+	}
+
+	//采样数据分析  
+	void LidarDriverUDP::LidarSamplingData(const CircleDataInfoTypeDef &info, LidarScan &outscan)
+	{
+		NVILIDAR_TRACE_SCOPE("LidarSamplingData");
+		uint32_t all_nodes_counts = 0;		//所有点数  不做截取等用法 
+		uint64_t scan_time = 0;				//2圈点的扫描间隔 
+
+		//扫描时间 
+		scan_time = info.stopStamp - info.startStamp;
+
+		//原始数据  计数
+		uint32_t lidar_ori_count = info.lidarCirclePoints.size();
+
+		//固定角分辨率 
+		if (lidar_cfg.resolution_fixed)
+		{
+			all_nodes_counts = (uint32_t)(lidar_cfg.storePara.samplingRate * 100 / lidar_cfg.storePara.aimSpeed);
+		}
+		else 	//非固定角分辨率 则是雷达默认一包多少点 就实际产生多少个点 
+		{
+			all_nodes_counts = lidar_ori_count;
+		}
+
+		//最大角与最小角问题 如是不对  则反转  
+		if (lidar_cfg.angle_max < lidar_cfg.angle_min)
+		{
+			float temp = lidar_cfg.angle_min;
+			lidar_cfg.angle_min = lidar_cfg.angle_max;
+			lidar_cfg.angle_max = temp;
+		}
+
+		//以角度为比例  计算输出信息 
+		outscan.stamp = info.startStamp;
+		outscan.config.max_angle = lidar_cfg.angle_max*M_PI / 180.0;			//计算最大角度  				
+		outscan.config.min_angle = lidar_cfg.angle_min*M_PI / 180.0;			//计算最小角度  
+		outscan.config.angle_increment = 2.0 * M_PI/(double)(all_nodes_counts - 1);	//计算2点之间的角度增量 
+			
+		outscan.config.scan_time = static_cast<float>(1.0 * scan_time / 1e9);  	//扫描时间信息  
+		outscan.config.time_increment = outscan.config.scan_time / (double)(all_nodes_counts - 1); 	//2点之间的时间 
+		outscan.config.min_range = lidar_cfg.range_min;
+		outscan.config.max_range = lidar_cfg.range_max;
+
+		//gap info 
+		outscan.info.zero_lost = info.zeroLost;
+		outscan.info.gap_count = info.gapCount;
+		outscan.info.missing_packages = info.missingPackages;
+		outscan.info.missing_points = info.missingPoints;
+
+		//初始化变量  
+		float dist = 0.0;
+		float angle = 0.0;
+		float intensity = 0.0;
+		unsigned int i = 0;
+		const uint16_t *ori_distance = info.lidarCirclePoints.distance.data();
+		const uint16_t *ori_quality = info.lidarCirclePoints.quality.data();
+		const uint16_t *ori_angle = info.lidarCirclePoints.angle.data();
+		outscan.points.clear();		//clear vector 
+		outscan.points.reserve(lidar_ori_count);
+
+		//从雷达原始数据中  提取数据  
+		for (; i < lidar_ori_count; i++)
+		{
+			dist = static_cast<float>(ori_distance[i] / 1000.f);
+			intensity = static_cast<float>(ori_quality[i]);
+			angle = static_cast<float>(ori_angle[i]) / (float)(NVILIDAR_ANGULDAR_RESOLUTION);
+			angle = angle * M_PI / 180.0;
+
+			//Rotate 180 degrees or not
+			if (lidar_cfg.reversion)
+			{
+				angle = angle + M_PI;
+			}
+			//Is it counter clockwise
+			if (!lidar_cfg.inverted)
+			{
+				angle = 2 * M_PI - angle;
+			}
+
+			//忽略点（事先配置好哪个角度的范围）
+			if (lidar_cfg.ignore_array.size() != 0)
+			{
+				for (uint16_t j = 0; j < lidar_cfg.ignore_array.size(); j = j + 2)
+				{
+					double angle_start = lidar_cfg.ignore_array[j] * M_PI / 180.0;
+					double angle_end = lidar_cfg.ignore_array[j + 1] * M_PI / 180.0;
+
+					if ((angle_start <= angle) && (angle <= angle_end))
+					{
+						dist = 0.0;
+						intensity = 0.0; 
+
+						break;
+					}
+				}
+			}
+
+			//-pi ~ pi
+			angle = fmod(fmod(angle, 2.0 * M_PI) + 2.0 * M_PI, 2.0 * M_PI);
+			if (angle > M_PI)
+			{
+				angle -= 2.0 * M_PI;
+			}
+
+			//距离是否在有效范围内 
+			if (dist > lidar_cfg.range_max || dist < lidar_cfg.range_min)
+			{
+				dist = 0.0;
+				intensity = 0.0;
+			}
+
+			//角度是否在有效范围内 
+			if ((angle >= outscan.config.min_angle) &&
+				(angle <= outscan.config.max_angle)){
+				NviLidarPoint point;
+				point.angle = angle;
+				point.range = dist;
+				point.intensity = intensity;
+
+				outscan.points.push_back(point);
+			}
+		}
+		//fill 
+		if (lidar_cfg.resolution_fixed)
+		{
+			int output_count = all_nodes_counts * ((outscan.config.max_angle - outscan.config.min_angle) / M_PI / 2);
+			outscan.points.resize(output_count);
+		}	
+	}
+
+	//等待一圈点云 事件 解锁 
+	void LidarDriverUDP::setCircleResponseUnlock()
+	{
+		NVILIDAR_TRACE_INSTANT("circle_ready");
+		#if	defined(_WIN32)
+			{
+				std::lock_guard<std::mutex> lock(_mutex_circle);
+				LidarPutCircle();
+			}
+			SetEvent(_event_circle);			// 重置事件，让其他线程继续等待（相当于获取锁）
+		#else 
+			pthread_mutex_lock(&_mutex_point);
+			LidarPutCircle();
+    		pthread_cond_signal(&_cond_point);
+    		pthread_mutex_unlock(&_mutex_point);
+		#endif 
+
+		if (io_hub != NULL)
+		{
+			io_hub->Notify(io_hub_id);
+		}
+	}
+
+	//the closed circle to the ready buffer,called with the circle lock 
+	void LidarDriverUDP::LidarPutCircle()
+	{
+		m_circle_ready_us = getUS();
+		std::swap(circle_ready, circleDataInfo);		//no copy of the points 
+		circleDataInfo.startStamp = circle_ready.startStamp;	//the stamps go on in the next circle 
+		circleDataInfo.stopStamp = circle_ready.stopStamp;
+		if (m_circle_pending.exchange(true))
+		{
+			metrics.Add(NVILIDAR_METRIC_SCANS_DROPPED);		//the last circle is not taken yet,it is overwritten 
+		}
+	}
+
+	//the ready circle to the buffer of LidarSamplingProcess,called with the circle lock 
+	void LidarDriverUDP::LidarTakeCircle()
+	{
+		std::swap(circle_taken, circle_ready);
+		circle_taken_us = m_circle_ready_us;
+		m_circle_pending = false;
+	}
+
+	//read the socket once and unpack,in the own thread or the hub thread 
+	bool LidarDriverUDP::LidarReadData()
+	{
+		size_t recv_len = 0;
+
+		if (!lidar_state.m_CommOpen)
+		{
+			return false;
+		}
+
+		{
+			NVILIDAR_TRACE_SCOPE("read");
+			recv_len = socket_udp.udpReadData(m_recv_data, sizeof(m_recv_data));
+		}
+		if ((recv_len > 0) && (recv_len <= sizeof(m_recv_data)))
+		{
+			LidarFeedData(m_recv_data, recv_len);
+			return true;
+		}
+
+		return false;
+	}
+
+	//read until stop,busy poll:no syscall to sleep while the data comes,the packages go to the circle in this thread 
+	void LidarDriverUDP::LidarReaderLoop()
+	{
+		bool busy = (NVILIDAR_READ_BUSY_POLL == thread_para.read_mode);
+		uint64_t data_us = getUS();			//last read with data 
+		uint64_t tick_ms = 0;
+		uint32_t backoff_us = NVILIDAR_RT_BACKOFF_MIN_US;
+
+		while ((!m_thread_stop) && lidar_state.m_CommOpen)
+		{	
+			bool got = LidarReadData();
+
+			if (!busy)
+			{
+				LidarPollTimer();
+				delayMS(1);		//必须要加sleep 不然会超高占用cpu	
+				continue;
+			}
+
+			//command timeout and stall check once a ms,not in every spin 
+			uint64_t now_us = getUS();
+			if (now_us / 1000 != tick_ms)
+			{
+				tick_ms = now_us / 1000;
+				LidarPollTimer();
+			}
+
+			if (got)
+			{
+				data_us = now_us;
+				backoff_us = NVILIDAR_RT_BACKOFF_MIN_US;
+			}
+			else if ((thread_para.backoff_us > 0) && (now_us - data_us > thread_para.backoff_us))
+			{
+				delayUS(backoff_us);		//idle(lidar stopped),sleep longer and longer 
+				backoff_us = (backoff_us * 2 > NVILIDAR_RT_BACKOFF_MAX_US) ? NVILIDAR_RT_BACKOFF_MAX_US : backoff_us * 2;
+			}
+			else
+			{
+				LidarCpuRelax();
+			}
+		}
+	}
+
+	//unpack the received bytes,from a read or an io_uring buffer of the hub 
+	void LidarDriverUDP::LidarFeedData(const uint8_t *buf, size_t len)
+	{
+		metrics.Add(NVILIDAR_METRIC_BYTES_READ, len);
+
+		//解包处理 === 正常解包 
+		if (!lidar_state.m_Scanning)
+		{
+			NormalDataUnpack(buf, len);
+		}
+		//解包处理 ==== 点云解包 
+		else
+		{
+			m_read_us = getUS();
+			link_supervisor.Feed(getMS());
+			PointDataUnpack(buf, len);
+			//the valid packages of this read in one datagram 
+			if (!relay_buf.empty())
+			{
+				relay.Publish(relay_buf.data(), relay_buf.size());
+				relay_buf.clear();
+			}
+		}
+	}
+
+	//command timeout,stall check and reopen 
+	void LidarDriverUDP::LidarPollTimer()
+	{
+		if (!lidar_state.m_CommOpen)
+		{
+			return;
+		}
+
+		//command timeout and resend 
+		command_engine.Poll();
+
+		//no data for N circles,stall event and reopen the port 
+		if (link_supervisor.NeedReopen(getMS()) && lidar_cfg.auto_reconnect)
+		{
+			LidarReopen();
+		}
+	}
+
+	//线程进程 分win32和linux等   
+	#if	defined(_WIN32)
+		DWORD WINAPI  LidarDriverUDP::periodThread(LPVOID lpParameter)
+		{
+			//在线程中要做的事情
+			LidarDriverUDP *pObj = (LidarDriverUDP *)lpParameter;   //传入的参数转化为类对象指针
+			NVILIDAR_TRACE_THREAD_NAME("nvilidar_reader");
+			LidarApplyThreadPara(pObj->thread_para);
+
+			pObj->LidarReaderLoop();
+
+			return 0;
+		}
+	#else 
+		/* 定义线程pthread */
+	   	void * LidarDriverUDP::periodThread(void *lpParameter)
+		{
+			//在线程中要做的事情
+			LidarDriverUDP *pObj = (LidarDriverUDP *)lpParameter;   //传入的参数转化为类对象指针
+			NVILIDAR_TRACE_THREAD_NAME("nvilidar_reader");
+			LidarApplyThreadPara(pObj->thread_para);
+
+			pObj->LidarReaderLoop();
+
+			return 0;
+		}
+	#endif 
+
+	
+}
+
+
+
+
+
@@ -0,0 +1,374 @@
+#include "nvilidar_fusion.h"
+#include "nvilidar_process.h"
+#include "nvilidar_trace.h"
+#include "mytimer.h"
+#include <math.h>
+#include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define NVILIDAR_FUSION_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define NVILIDAR_FUSION_NEON
+#endif
+
+#ifndef M_PI
+	#define M_PI		3.14159265358979323846
+#endif
+
+namespace nvilidar
+{
+	//polar points to the vehicle frame at the reference time,4 points in one step
+	//c/s:cos/sin of the angle + yaw,dt:reference time - point time
+	//x = tx + r*c - vx*dt + wz*dt*y , y = ty + r*s - vy*dt - wz*dt*x (small rotation in dt)
+	static void FusionTransform(const float *range, const float *c, const float *s, const float *dt, uint32_t count,
+								float tx, float ty, float vx, float vy, float wz, float *out_x, float *out_y)
+	{
+		uint32_t i = 0;
+
+	#if defined(NVILIDAR_FUSION_SSE2)
+		__m128 v_tx = _mm_set1_ps(tx);
+		__m128 v_ty = _mm_set1_ps(ty);
+		__m128 v_vx = _mm_set1_ps(vx);
+		__m128 v_vy = _mm_set1_ps(vy);
+		__m128 v_wz = _mm_set1_ps(wz);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 r = _mm_loadu_ps(range + i);
+			__m128 t = _mm_loadu_ps(dt + i);
+			__m128 x = _mm_add_ps(v_tx, _mm_mul_ps(r, _mm_loadu_ps(c + i)));
+			__m128 y = _mm_add_ps(v_ty, _mm_mul_ps(r, _mm_loadu_ps(s + i)));
+			__m128 w = _mm_mul_ps(v_wz, t);
+			__m128 dx = _mm_sub_ps(_mm_mul_ps(w, y), _mm_mul_ps(v_vx, t));
+			__m128 dy = _mm_add_ps(_mm_mul_ps(w, x), _mm_mul_ps(v_vy, t));
+			_mm_storeu_ps(out_x + i, _mm_add_ps(x, dx));
+			_mm_storeu_ps(out_y + i, _mm_sub_ps(y, dy));
+		}
+	#elif defined(NVILIDAR_FUSION_NEON)
+		float32x4_t v_tx = vdupq_n_f32(tx);
+		float32x4_t v_ty = vdupq_n_f32(ty);
+		float32x4_t v_vx = vdupq_n_f32(vx);
+		float32x4_t v_vy = vdupq_n_f32(vy);
+		float32x4_t v_wz = vdupq_n_f32(wz);
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t r = vld1q_f32(range + i);
+			float32x4_t t = vld1q_f32(dt + i);
+			float32x4_t x = vmlaq_f32(v_tx, r, vld1q_f32(c + i));
+			float32x4_t y = vmlaq_f32(v_ty, r, vld1q_f32(s + i));
+			float32x4_t w = vmulq_f32(v_wz, t);
+			float32x4_t dx = vmlsq_f32(vmulq_f32(w, y), v_vx, t);
+			float32x4_t dy = vmlaq_f32(vmulq_f32(w, x), v_vy, t);
+			vst1q_f32(out_x + i, vaddq_f32(x, dx));
+			vst1q_f32(out_y + i, vsubq_f32(y, dy));
+		}
+	#endif
+
+		for (; i < count; i++)
+		{
+			float x = tx + range[i] * c[i];
+			float y = ty + range[i] * s[i];
+			float w = wz * dt[i];
+			out_x[i] = x + w * y - vx * dt[i];
+			out_y[i] = y - w * x - vy * dt[i];
+		}
+	}
+
+	LidarFusion::LidarFusion()
+	{
+		fusion_bins = 0;
+		fusion_max_points = 0;
+		fusion_max_age_ns = (uint64_t)NVILIDAR_FUSION_MAX_AGE_MS * 1000000ULL;
+		motion_vx = 0.0f;
+		motion_vy = 0.0f;
+		motion_wz = 0.0f;
+		fusion_cloud.stamp = 0;
+		fusion_cloud.count = 0;
+		memset(&fusion_stats, 0, sizeof(fusion_stats));
+
+		Init();
+	}
+
+	LidarFusion::~LidarFusion()
+	{
+	}
+
+	//all the buffers are allocated here,no allocation in Merge
+	bool LidarFusion::Init(uint32_t bins, uint32_t max_points)
+	{
+		if ((bins == 0) || (max_points == 0))
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		fusion_bins = bins;
+		fusion_max_points = max_points;
+		fusion_sources.clear();
+		fusion_sources.reserve(NVILIDAR_FUSION_MAX_SOURCES);
+
+		fusion_cloud.stamp = 0;
+		fusion_cloud.count = 0;
+		fusion_cloud.x.resize(max_points);
+		fusion_cloud.y.resize(max_points);
+		fusion_cloud.intensity.resize(max_points);
+		fusion_cloud.source.resize(max_points);
+		point_range.resize(max_points);
+		point_cos.resize(max_points);
+		point_sin.resize(max_points);
+		point_dt.resize(max_points);
+		fetch_scan.points.reserve(max_points);
+
+		return true;
+	}
+
+	int LidarFusion::AddSource(LidarProcess *lidar, LidarExtrinsic extrinsic)
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		if (fusion_sources.size() >= NVILIDAR_FUSION_MAX_SOURCES)
+		{
+			return -1;
+		}
+
+		LidarFusionSource source = LidarFusionSource();		//scan config/info/latency zero 
+		source.lidar = lidar;
+		source.extrinsic = extrinsic;
+		source.valid = false;
+		source.scan.stamp = 0;
+		fusion_sources.push_back(source);
+		fusion_sources.back().scan.points.reserve(fusion_max_points);
+
+		return (int)fusion_sources.size() - 1;
+	}
+
+	bool LidarFusion::SetExtrinsic(int source, LidarExtrinsic extrinsic)
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		if ((source < 0) || (source >= (int)fusion_sources.size()))
+		{
+			return false;
+		}
+		fusion_sources[source].extrinsic = extrinsic;
+
+		return true;
+	}
+
+	void LidarFusion::SetMotion(float vx, float vy, float wz)
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		motion_vx = vx;
+		motion_vy = vy;
+		motion_wz = wz;
+	}
+
+	void LidarFusion::SetMaxAge(uint32_t ms)
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		fusion_max_age_ns = (uint64_t)ms * 1000000ULL;
+	}
+
+	bool LidarFusion::Update(int source, const LidarScan &scan)
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		if ((source < 0) || (source >= (int)fusion_sources.size()) || scan.points.empty())
+		{
+			return false;
+		}
+
+		LidarFusionSource &item = fusion_sources[source];
+		item.scan.stamp = scan.stamp;
+		item.scan.config = scan.config;
+		item.scan.info = scan.info;
+		item.scan.latency = scan.latency;
+		item.scan.points.assign(scan.points.begin(), scan.points.end());
+		item.valid = true;
+
+		return true;
+	}
+
+	//new scans of the lidars(no wait),then every point is moved to the time of the newest point
+	bool LidarFusion::Merge(LidarScan &scan)
+	{
+		NVILIDAR_TRACE_SCOPE("LidarFusion::Merge");
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+
+		for (size_t i = 0; i < fusion_sources.size(); i++)
+		{
+			LidarFusionSource &source = fusion_sources[i];
+			if (source.lidar == NULL)
+			{
+				continue;
+			}
+			//true without points if auto reconnect is on
+			if (source.lidar->LidarSamplingProcess(fetch_scan, NVILIDAR_POINT_TIMEOUT_NONE) && (!fetch_scan.points.empty()))
+			{
+				std::swap(source.scan, fetch_scan);
+				source.valid = true;
+			}
+		}
+
+		//reference time
+		uint64_t start_us = getUS();
+		uint64_t stamp = 0;
+		for (size_t i = 0; i < fusion_sources.size(); i++)
+		{
+			const LidarFusionSource &source = fusion_sources[i];
+			if (source.valid)
+			{
+				uint64_t last = source.scan.stamp + (uint64_t)((double)source.scan.config.time_increment * 1e9 * (source.scan.points.size() - 1));
+				stamp = (last > stamp) ? last : stamp;
+			}
+		}
+
+		memset(&fusion_stats, 0, sizeof(fusion_stats));
+		fusion_cloud.count = 0;
+		fusion_cloud.stamp = stamp;
+		for (size_t i = 0; i < fusion_sources.size(); i++)
+		{
+			if (fusion_sources[i].valid)
+			{
+				MergeSource((uint8_t)i, fusion_sources[i], stamp);
+			}
+		}
+		fusion_stats.points = fusion_cloud.count;
+		uint64_t merge_us = getUS();
+
+		FillScan(scan, stamp);
+		scan.latency.decode_us = start_us;
+		scan.latency.filter_us = merge_us;
+		scan.latency.handoff_us = getUS();
+		fusion_stats.merge_us = scan.latency.handoff_us - start_us;
+
+		return (fusion_cloud.count > 0);
+	}
+
+	const LidarFusionCloud &LidarFusion::GetCloud()
+	{
+		return fusion_cloud;
+	}
+
+	LidarFusionStats LidarFusion::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(fusion_mutex);
+		return fusion_stats;
+	}
+
+	//points of one lidar to the cloud
+	void LidarFusion::MergeSource(uint8_t index, LidarFusionSource &source, uint64_t stamp)
+	{
+		const std::vector<NviLidarPoint> &points = source.scan.points;
+		double time_increment = (double)source.scan.config.time_increment * 1e9;
+		float yaw = source.extrinsic.yaw;
+		uint32_t base = fusion_cloud.count;
+		uint32_t count = 0;
+		bool used = false;
+
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			if (points[i].range <= 0.0f)
+			{
+				continue;			//no echo,out of range or ignored
+			}
+
+			uint64_t point_stamp = source.scan.stamp + (uint64_t)(time_increment * i);
+			uint64_t age = (stamp > point_stamp) ? (stamp - point_stamp) : 0;
+			if (age > fusion_max_age_ns)
+			{
+				fusion_stats.points_old++;
+				continue;
+			}
+			if (base + count >= fusion_max_points)
+			{
+				fusion_stats.points_full++;
+				continue;
+			}
+
+			float angle = points[i].angle + yaw;
+			point_range[count] = points[i].range;
+			point_cos[count] = cosf(angle);
+			point_sin[count] = sinf(angle);
+			point_dt[count] = (float)(age / 1e9);
+			fusion_cloud.intensity[base + count] = points[i].intensity;
+			fusion_cloud.source[base + count] = index;
+			count++;
+			used = true;
+		}
+
+		FusionTransform(point_range.data(), point_cos.data(), point_sin.data(), point_dt.data(), count,
+						source.extrinsic.x, source.extrinsic.y, motion_vx, motion_vy, motion_wz,
+						fusion_cloud.x.data() + base, fusion_cloud.y.data() + base);
+
+		fusion_cloud.count = base + count;
+		if (used)
+		{
+			fusion_stats.sources++;
+		}
+	}
+
+	//cloud to a scan around the vehicle origin,the nearest point of a bin
+	void LidarFusion::FillScan(LidarScan &scan, uint64_t stamp)
+	{
+		float increment = (float)(2.0 * M_PI / fusion_bins);
+		float inv_increment = 1.0f / increment;
+
+		scan.stamp = stamp;
+		scan.points.resize(fusion_bins);
+		for (uint32_t i = 0; i < fusion_bins; i++)
+		{
+			scan.points[i].angle = (float)(-M_PI + (i + 0.5) * increment);
+			scan.points[i].range = 0.0f;
+			scan.points[i].intensity = 0.0f;
+		}
+
+		const float *x = fusion_cloud.x.data();
+		const float *y = fusion_cloud.y.data();
+		for (uint32_t i = 0; i < fusion_cloud.count; i++)
+		{
+			float range = sqrtf(x[i] * x[i] + y[i] * y[i]);
+			if (range <= 0.0f)
+			{
+				continue;
+			}
+
+			int bin = (int)((atan2f(y[i], x[i]) + (float)M_PI) * inv_increment);
+			bin = (bin < 0) ? 0 : ((bin >= (int)fusion_bins) ? (int)fusion_bins - 1 : bin);
+			NviLidarPoint &point = scan.points[bin];
+			if ((point.range == 0.0f) || (range < point.range))
+			{
+				point.range = range;
+				point.intensity = fusion_cloud.intensity[i];
+			}
+		}
+
+		//config and info of the lidars in the merge
+		memset(&scan.config, 0, sizeof(scan.config));
+		memset(&scan.info, 0, sizeof(scan.info));
+		memset(&scan.latency, 0, sizeof(scan.latency));
+		scan.config.min_angle = scan.points[0].angle;
+		scan.config.max_angle = scan.points[fusion_bins - 1].angle;
+		scan.config.angle_increment = increment;
+		scan.config.time_increment = 0.0f;			//all points are at the reference time
+		bool first = true;
+		for (size_t i = 0; i < fusion_sources.size(); i++)
+		{
+			const LidarFusionSource &source = fusion_sources[i];
+			if (!source.valid)
+			{
+				continue;
+			}
+			float offset = sqrtf(source.extrinsic.x * source.extrinsic.x + source.extrinsic.y * source.extrinsic.y);
+			scan.config.scan_time = (source.scan.config.scan_time > scan.config.scan_time) ? source.scan.config.scan_time : scan.config.scan_time;
+			scan.config.max_range = (source.scan.config.max_range + offset > scan.config.max_range) ? source.scan.config.max_range + offset : scan.config.max_range;
+			scan.config.min_range = (first || (source.scan.config.min_range < scan.config.min_range)) ? source.scan.config.min_range : scan.config.min_range;
+			if (first || (source.scan.latency.first_byte_us < scan.latency.first_byte_us))
+			{
+				scan.latency.first_byte_us = source.scan.latency.first_byte_us;
+			}
+			scan.info.zero_lost = scan.info.zero_lost || source.scan.info.zero_lost;
+			scan.info.gap_count += source.scan.info.gap_count;
+			scan.info.missing_packages += source.scan.info.missing_packages;
+			scan.info.missing_points += source.scan.info.missing_points;
+			first = false;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_FUSION_API __declspec(dllexport)
+#else
+	#define NVILIDAR_FUSION_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_FUSION_MAX_SOURCES		8			//lidars of one fusion
+#define NVILIDAR_FUSION_BINS			1440		//bins of the merged scan(0.25°)
+#define NVILIDAR_FUSION_MAX_POINTS		32768		//points of the merged cloud,more points are dropped
+#define NVILIDAR_FUSION_MAX_AGE_MS		200			//points older than the newest point are dropped
+
+namespace nvilidar
+{
+	class LidarProcess;
+
+	//pose of a lidar in the vehicle frame(x forward,y left)
+	typedef struct
+	{
+		float	x;			//m
+		float	y;			//m
+		float	yaw;		//rad,counter-clockwise
+	}LidarExtrinsic;
+
+	//merged points in the vehicle frame,all moved to the reference time
+	typedef struct
+	{
+		uint64_t				stamp;			//reference time(newest point),ns
+		uint32_t				count;			//valid points,the vectors are preallocated
+		std::vector<float>		x;				//m
+		std::vector<float>		y;				//m
+		std::vector<float>		intensity;
+		std::vector<uint8_t>	source;			//index of the lidar
+	}LidarFusionCloud;
+
+	//last merge
+	typedef struct
+	{
+		uint32_t	sources;		//lidars with points in the merge
+		uint32_t	points;
+		uint32_t	points_old;		//older than the max age
+		uint32_t	points_full;	//cloud is full
+		uint64_t	merge_us;		//time of the merge,the scans are taken before
+	}LidarFusionStats;
+
+	//merge the scans of some lidars into one 360° scan around the vehicle
+	class NVILIDAR_FUSION_API LidarFusion
+	{
+		public:
+			LidarFusion();
+			~LidarFusion();
+
+			bool Init(uint32_t bins = NVILIDAR_FUSION_BINS, uint32_t max_points = NVILIDAR_FUSION_MAX_POINTS);	//allocate the buffers,sources are removed
+			int AddSource(LidarProcess *lidar, LidarExtrinsic extrinsic);	//index of the source,-1:full.lidar NULL:scans given by Update
+			bool SetExtrinsic(int source, LidarExtrinsic extrinsic);
+			void SetMotion(float vx, float vy, float wz);	//vehicle speed(m/s,rad/s),the points are moved to the reference time
+			void SetMaxAge(uint32_t ms);
+			bool Update(int source, const LidarScan &scan);	//scan of a source without LidarProcess
+
+			bool Merge(LidarScan &scan);			//take the new scans of the lidars and merge,false:no points
+			const LidarFusionCloud &GetCloud();		//cloud of the last merge,valid until the next one
+			LidarFusionStats GetStats();
+
+		private:
+			typedef struct
+			{
+				LidarProcess	*lidar;
+				LidarExtrinsic	extrinsic;
+				LidarScan		scan;			//newest scan
+				bool			valid;
+			}LidarFusionSource;
+
+			void MergeSource(uint8_t index, LidarFusionSource &source, uint64_t stamp);
+			void FillScan(LidarScan &scan, uint64_t stamp);
+
+			std::mutex						fusion_mutex;
+			std::vector<LidarFusionSource>	fusion_sources;
+			LidarScan						fetch_scan;		//scan taken from a lidar
+			uint32_t						fusion_bins;
+			uint32_t						fusion_max_points;
+			uint64_t						fusion_max_age_ns;
+			float							motion_vx;
+			float							motion_vy;
+			float							motion_wz;
+
+			LidarFusionCloud				fusion_cloud;
+			std::vector<float>				point_range;	//points of one source,input of the transform
+			std::vector<float>				point_cos;
+			std::vector<float>				point_sin;
+			std::vector<float>				point_dt;		//reference time - point time,s
+			LidarFusionStats				fusion_stats;
+	};
+}
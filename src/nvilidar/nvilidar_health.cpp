@@ -0,0 +1,126 @@
+#include "nvilidar_health.h"
+#include <string.h>
+#include <math.h>
+
+namespace nvilidar
+{
+	LidarHealthMonitor::LidarHealthMonitor()
+	{
+		health_circles = NVILIDAR_HEALTH_CIRCLES;
+		health_valid = false;
+		memset(&health_last, 0x00, sizeof(health_last));
+
+		curr_circles = 0;
+		curr_speed_count = 0;
+		curr_speed_min = 0.0f;
+		curr_speed_max = 0.0f;
+		curr_speed_sum = 0.0;
+		curr_speed_square = 0.0;
+		curr_has_temp = false;
+		curr_temp = 0.0f;
+		curr_packages = 0;
+		curr_errors = 0;
+	}
+
+	//record event
+	void LidarHealthMonitor::SetCallback(LidarHealthCallback callback, uint32_t circles)
+	{
+		std::lock_guard<std::mutex> lock(health_mutex);
+		health_callback = callback;
+		health_circles = (circles > 0) ? circles : NVILIDAR_HEALTH_CIRCLES;
+	}
+
+	//speed of 0 angle package
+	void LidarHealthMonitor::Speed(float speed)
+	{
+		if (curr_speed_count == 0)
+		{
+			curr_speed_min = speed;
+			curr_speed_max = speed;
+		}
+		else
+		{
+			curr_speed_min = (speed < curr_speed_min) ? speed : curr_speed_min;
+			curr_speed_max = (speed > curr_speed_max) ? speed : curr_speed_max;
+		}
+		curr_speed_sum += speed;
+		curr_speed_square += (double)speed * speed;
+		curr_speed_count++;
+	}
+
+	//temperature package
+	void LidarHealthMonitor::Temperature(float temperature)
+	{
+		curr_has_temp = true;
+		curr_temp = temperature;
+	}
+
+	//circle finish,make a record every N circles
+	void LidarHealthMonitor::Circle(uint64_t stamp, uint64_t packages, uint64_t errors)
+	{
+		NviLidarHealth health;
+		LidarHealthCallback callback;
+
+		curr_circles++;
+		{
+			std::lock_guard<std::mutex> lock(health_mutex);
+			if (curr_circles < health_circles)
+			{
+				return;
+			}
+			callback = health_callback;
+		}
+
+		memset(&health, 0x00, sizeof(health));
+		health.stamp = stamp;
+		health.circles = curr_circles;
+		if (curr_speed_count > 0)
+		{
+			double mean = curr_speed_sum / curr_speed_count;
+			double variance = curr_speed_square / curr_speed_count - mean * mean;
+
+			health.speed_min = curr_speed_min;
+			health.speed_mean = (float)mean;
+			health.speed_max = curr_speed_max;
+			health.speed_jitter = (variance > 0.0) ? (float)sqrt(variance) : 0.0f;
+		}
+		health.has_temperature = curr_has_temp;
+		health.temperature = curr_temp;
+		if (packages > curr_packages)
+		{
+			health.checksum_error_rate = (float)(errors - curr_errors) / (float)(packages - curr_packages);
+		}
+
+		//next record
+		curr_circles = 0;
+		curr_speed_count = 0;
+		curr_speed_sum = 0.0;
+		curr_speed_square = 0.0;
+		curr_has_temp = false;
+		curr_packages = packages;
+		curr_errors = errors;
+
+		{
+			std::lock_guard<std::mutex> lock(health_mutex);
+			health_last = health;
+			health_valid = true;
+		}
+		if (callback)
+		{
+			callback(health);
+		}
+	}
+
+	//last record
+	bool LidarHealthMonitor::Get(NviLidarHealth &health)
+	{
+		std::lock_guard<std::mutex> lock(health_mutex);
+		if (!health_valid)
+		{
+			return false;
+		}
+		health = health_last;
+
+		return true;
+	}
+}
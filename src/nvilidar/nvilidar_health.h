@@ -0,0 +1,53 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include <stdint.h>
+#include <mutex>
+#include <functional>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_HEALTH_API __declspec(dllexport)
+#else
+	#define NVILIDAR_HEALTH_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_HEALTH_CIRCLES			10			//circles in one health record(default)
+
+//health record event(called in the driver thread,return quickly)
+typedef std::function<void(const NviLidarHealth &health)> LidarHealthCallback;
+
+namespace nvilidar
+{
+	//collect the speed/temperature from the package header,one record for N circles
+	class NVILIDAR_HEALTH_API LidarHealthMonitor
+	{
+		public:
+			LidarHealthMonitor();
+
+			void SetCallback(LidarHealthCallback callback, uint32_t circles);	//record event
+			void Speed(float speed);					//speed of the 0 angle package(Hz)
+			void Temperature(float temperature);		//temperature package(°C)
+			void Circle(uint64_t stamp, uint64_t packages, uint64_t errors);	//circle finish,total packages/checksum errors from start
+			bool Get(NviLidarHealth &health);			//last record,false if none
+
+		private:
+			std::mutex			health_mutex;
+			LidarHealthCallback	health_callback;
+			uint32_t			health_circles;			//circles in one record
+			bool				health_valid;			//has record
+			NviLidarHealth		health_last;			//last record
+
+			//current record
+			uint32_t	curr_circles;
+			uint32_t	curr_speed_count;
+			float		curr_speed_min;
+			float		curr_speed_max;
+			double		curr_speed_sum;
+			double		curr_speed_square;
+			bool		curr_has_temp;
+			float		curr_temp;
+			uint64_t	curr_packages;				//total count at the record start
+			uint64_t	curr_errors;
+	};
+}
@@ -0,0 +1,491 @@
+#include "nvilidar_hub.h"
+#include "nvilidar_trace.h"
+#include "mytimer.h"
+#include "myconsole.h"
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#if defined(__linux__)
+	#include <unistd.h>
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+	#include <sys/stat.h>
+#endif
+
+#define NVILIDAR_HUB_WAKE_ID		0xFFFFFFFFFFFFFFFFULL		//epoll data / user data of the eventfd
+#define NVILIDAR_HUB_CANCEL_ID		0xFFFFFFFFFFFFFFFEULL		//user data of the cancel requests
+#define NVILIDAR_HUB_URING_DATA(id, generation)		(((uint64_t)(uint32_t)(id) << 32) | (uint32_t)(generation))
+
+namespace nvilidar
+{
+	LidarHub::LidarHub()
+	{
+		hub_running = false;
+		hub_tick_ms = NVILIDAR_HUB_TICK_MS;
+		hub_epoll = -1;
+		hub_wake = -1;
+		hub_backend = NVILIDAR_HUB_EPOLL;
+		hub_next_id = 0;
+		memset(&hub_thread_para, 0, sizeof(hub_thread_para));
+	}
+
+	LidarHub::~LidarHub()
+	{
+		Stop();
+	}
+
+	//start the I/O thread,the lidars can be added before or after
+	bool LidarHub::Start(uint32_t tick_ms, LidarHubBackendEnum backend)
+	{
+		Stop();
+
+		hub_tick_ms = (tick_ms > 0) ? tick_ms : NVILIDAR_HUB_TICK_MS;
+		hub_backend = NVILIDAR_HUB_EPOLL;
+
+	#if defined(__linux__)
+		hub_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (hub_wake < 0)
+		{
+			Stop();
+			return false;
+		}
+
+		//io_uring may be off(old kernel,seccomp of the container),epoll then
+		if (backend == NVILIDAR_HUB_URING)
+		{
+			if (hub_uring.Open())
+			{
+				hub_backend = NVILIDAR_HUB_URING;
+				hub_uring.Poll(hub_wake, NVILIDAR_HUB_WAKE_ID, true);
+			}
+			else
+			{
+				nvilidar::console.warning("io_uring is not supported,use epoll");
+			}
+		}
+
+		if (hub_backend == NVILIDAR_HUB_EPOLL)
+		{
+			hub_epoll = epoll_create1(EPOLL_CLOEXEC);
+			if (hub_epoll < 0)
+			{
+				Stop();
+				return false;
+			}
+
+			struct epoll_event event;
+			event.events = EPOLLIN;
+			event.data.u64 = NVILIDAR_HUB_WAKE_ID;
+			if (epoll_ctl(hub_epoll, EPOLL_CTL_ADD, hub_wake, &event) != 0)
+			{
+				Stop();
+				return false;
+			}
+		}
+	#else
+		(void)backend;
+	#endif
+
+		hub_running = true;
+		if (hub_backend == NVILIDAR_HUB_URING)
+		{
+			hub_thread = std::thread(&LidarHub::HubThreadUring, this);
+		}
+		else
+		{
+			hub_thread = std::thread(&LidarHub::HubThread, this);
+		}
+
+		return true;
+	}
+
+	//stop the thread,the lidars are kept
+	void LidarHub::Stop()
+	{
+		hub_running = false;
+	#if defined(__linux__)
+		if (hub_wake >= 0)
+		{
+			uint64_t value = 1;
+			ssize_t ret = write(hub_wake, &value, sizeof(value));
+			(void)ret;
+		}
+	#endif
+
+		if (hub_thread.joinable())
+		{
+			hub_thread.join();
+		}
+
+		std::lock_guard<std::mutex> lock(hub_mutex);
+		for (std::map<int, LidarHubEntry>::iterator it = hub_sources.begin(); it != hub_sources.end(); ++it)
+		{
+			it->second.fd = -1;
+			it->second.armed = false;
+			it->second.generation++;
+		}
+		hub_cancel.clear();
+		hub_uring.Close();			//cancels the requests in flight
+	#if defined(__linux__)
+		if (hub_wake >= 0)
+		{
+			close(hub_wake);
+			hub_wake = -1;
+		}
+		if (hub_epoll >= 0)
+		{
+			close(hub_epoll);
+			hub_epoll = -1;
+		}
+	#endif
+	}
+
+	bool LidarHub::IsRunning()
+	{
+		return hub_running;
+	}
+
+	LidarHubBackendEnum LidarHub::GetBackend()
+	{
+		return hub_backend;
+	}
+
+	//the reader of all the lidars,pin it and give it a real time priority
+	void LidarHub::SetThreadPara(LidarThreadPara para)
+	{
+		hub_thread_para = para;
+	}
+
+	int LidarHub::Add(LidarHubSource source)
+	{
+		if ((!source.fd) || (!source.read))
+		{
+			return -1;
+		}
+
+		std::lock_guard<std::mutex> lock(hub_mutex);
+		int id = hub_next_id++;
+		LidarHubEntry &entry = hub_sources[id];
+		entry.source = source;
+		entry.fd = -1;
+		entry.open_id = 0;
+		entry.generation = 0;
+		entry.armed = false;
+		entry.socket = false;
+		entry.multishot = true;
+		UpdateFd(id, entry);
+
+		return id;
+	}
+
+	void LidarHub::Remove(int id)
+	{
+		{
+			std::lock_guard<std::mutex> lock(hub_mutex);
+			std::map<int, LidarHubEntry>::iterator it = hub_sources.find(id);
+			if (it == hub_sources.end())
+			{
+				return;
+			}
+			if (it->second.armed)
+			{
+				hub_cancel.push_back(NVILIDAR_HUB_URING_DATA(id, it->second.generation));
+			}
+			RemoveFd(it->second);
+			hub_sources.erase(it);
+		}
+
+		std::lock_guard<std::mutex> lock(ready_mutex);
+		ready_list.erase(std::remove(ready_list.begin(), ready_list.end(), id), ready_list.end());
+	}
+
+	uint32_t LidarHub::GetCount()
+	{
+		std::lock_guard<std::mutex> lock(hub_mutex);
+		return (uint32_t)hub_sources.size();
+	}
+
+	void LidarHub::Notify(int id)
+	{
+		{
+			std::lock_guard<std::mutex> lock(ready_mutex);
+			if (std::find(ready_list.begin(), ready_list.end(), id) == ready_list.end())
+			{
+				ready_list.push_back(id);
+			}
+		}
+		ready_cond.notify_all();
+	}
+
+	//wait for circles of any lidar,take them with LidarSamplingProcess(scan,NVILIDAR_POINT_TIMEOUT_NONE)
+	bool LidarHub::Wait(std::vector<int> &ready, uint32_t timeout_ms)
+	{
+		std::unique_lock<std::mutex> lock(ready_mutex);
+		ready_cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return !ready_list.empty(); });
+
+		ready.swap(ready_list);
+		ready_list.clear();
+
+		return !ready.empty();
+	}
+
+	//fd of the port may change after reopen,a closed fd has left the epoll set
+	void LidarHub::UpdateFd(int id, LidarHubEntry &entry)
+	{
+	#if defined(__linux__)
+		if (hub_epoll < 0)		//no epoll set,io_uring is armed by the hub thread
+		{
+			return;
+		}
+
+		int fd = entry.source.fd();
+		if ((fd != entry.fd) && (entry.fd >= 0))
+		{
+			epoll_ctl(hub_epoll, EPOLL_CTL_DEL, entry.fd, NULL);
+		}
+		if (fd >= 0)
+		{
+			struct epoll_event event;
+			event.events = EPOLLIN;
+			event.data.u64 = (uint64_t)id;
+			if ((fd != entry.fd) || (epoll_ctl(hub_epoll, EPOLL_CTL_MOD, fd, &event) != 0))
+			{
+				if ((epoll_ctl(hub_epoll, EPOLL_CTL_ADD, fd, &event) != 0) && (errno != EEXIST))
+				{
+					fd = -1;		//try again in the next tick
+				}
+			}
+		}
+		entry.fd = fd;
+	#else
+		(void)id;
+		(void)entry;
+	#endif
+	}
+
+	void LidarHub::RemoveFd(LidarHubEntry &entry)
+	{
+	#if defined(__linux__)
+		if ((hub_epoll >= 0) && (entry.fd >= 0))
+		{
+			epoll_ctl(hub_epoll, EPOLL_CTL_DEL, entry.fd, NULL);
+		}
+	#endif
+		entry.fd = -1;
+	}
+
+	//a new fd or a reopen of the port,cancel the old request and arm again
+	void LidarHub::UpdateUring(int id, LidarHubEntry &entry)
+	{
+	#if defined(__linux__)
+		int fd = entry.source.fd();
+		uint32_t open_id = entry.source.open_id ? entry.source.open_id() : 0;
+
+		if ((fd != entry.fd) || (open_id != entry.open_id))
+		{
+			if (entry.armed)
+			{
+				hub_uring.Cancel(NVILIDAR_HUB_URING_DATA(id, entry.generation), NVILIDAR_HUB_CANCEL_ID);
+				entry.armed = false;
+			}
+			entry.generation++;
+			entry.fd = fd;
+			entry.open_id = open_id;
+
+			struct stat st;
+			entry.socket = (fd >= 0) && (fstat(fd, &st) == 0) && S_ISSOCK(st.st_mode) && entry.source.feed;
+			entry.multishot = true;
+		}
+
+		if (!entry.armed)
+		{
+			ArmUring(id, entry);
+		}
+	#else
+		(void)id;
+		(void)entry;
+	#endif
+	}
+
+	//socket:multishot recv into the provided buffers,the bytes are fed to the driver
+	//tty:multishot poll and read by the driver,a tty read returns 0 bytes at once(VMIN=0)
+	void LidarHub::ArmUring(int id, LidarHubEntry &entry)
+	{
+		if (entry.fd < 0)
+		{
+			return;
+		}
+
+		uint64_t user_data = NVILIDAR_HUB_URING_DATA(id, entry.generation);
+		if (entry.socket)
+		{
+			entry.armed = hub_uring.Read(entry.fd, user_data, entry.multishot);
+		}
+		else
+		{
+			entry.armed = hub_uring.Poll(entry.fd, user_data, true);
+		}
+	}
+
+	void LidarHub::HandleUring(const LidarUringEvent &event)
+	{
+		if (event.user_data == NVILIDAR_HUB_WAKE_ID)
+		{
+		#if defined(__linux__)
+			uint64_t value;
+			ssize_t ret = read(hub_wake, &value, sizeof(value));
+			(void)ret;
+		#endif
+			if (!event.more)
+			{
+				hub_uring.Poll(hub_wake, NVILIDAR_HUB_WAKE_ID, true);
+			}
+			return;
+		}
+		if (event.user_data == NVILIDAR_HUB_CANCEL_ID)
+		{
+			return;
+		}
+
+		//removed lidar or an old request
+		std::map<int, LidarHubEntry>::iterator it = hub_sources.find((int)(event.user_data >> 32));
+		if ((it == hub_sources.end()) || (!it->second.armed) || (it->second.generation != (uint32_t)event.user_data))
+		{
+			hub_uring.Release(event);
+			return;
+		}
+
+		LidarHubEntry &entry = it->second;
+		if (entry.socket)
+		{
+			if ((event.res > 0) && (event.data != NULL))
+			{
+				entry.source.feed(event.data, (size_t)event.res);
+			}
+			hub_uring.Release(event);
+		}
+		else if (event.res > 0)
+		{
+			entry.source.read();
+		}
+
+		if (!event.more)
+		{
+			entry.armed = false;
+			if ((event.res == -EINVAL) && entry.socket && entry.multishot)
+			{
+				entry.multishot = false;		//no multishot recv before 6.0
+				ArmUring(it->first, entry);
+			}
+			else if ((event.res > 0) || (event.res == -ENOBUFS))
+			{
+				ArmUring(it->first, entry);
+			}
+			//other errors:arm again in the next tick
+		}
+	}
+
+	//read the ready lidars,tick all of them every hub_tick_ms
+	void LidarHub::HubThread()
+	{
+		NVILIDAR_TRACE_THREAD_NAME("nvilidar_hub");
+		LidarApplyThreadPara(hub_thread_para);
+		uint64_t last_tick = 0;
+	#if defined(__linux__)
+		struct epoll_event events[NVILIDAR_HUB_MAX_EVENTS];
+	#endif
+
+		while (hub_running)
+		{
+			uint64_t passed = getMS() - last_tick;
+
+		#if defined(__linux__)
+			int wait_ms = (passed >= hub_tick_ms) ? 0 : (int)(hub_tick_ms - passed);
+			int count = epoll_wait(hub_epoll, events, NVILIDAR_HUB_MAX_EVENTS, wait_ms);
+
+			std::lock_guard<std::mutex> lock(hub_mutex);
+			for (int i = 0; i < count; i++)
+			{
+				if (events[i].data.u64 == NVILIDAR_HUB_WAKE_ID)
+				{
+					uint64_t value;
+					ssize_t ret = read(hub_wake, &value, sizeof(value));
+					(void)ret;
+					continue;
+				}
+
+				std::map<int, LidarHubEntry>::iterator it = hub_sources.find((int)events[i].data.u64);
+				if (it != hub_sources.end())
+				{
+					it->second.source.read();
+				}
+			}
+		#else
+			(void)passed;
+			delayMS(1);
+
+			std::lock_guard<std::mutex> lock(hub_mutex);
+			for (std::map<int, LidarHubEntry>::iterator it = hub_sources.begin(); it != hub_sources.end(); ++it)
+			{
+				it->second.source.read();
+			}
+		#endif
+
+			uint64_t now = getMS();
+			if (now - last_tick >= hub_tick_ms)
+			{
+				last_tick = now;
+				for (std::map<int, LidarHubEntry>::iterator it = hub_sources.begin(); it != hub_sources.end(); ++it)
+				{
+					if (it->second.source.tick)
+					{
+						it->second.source.tick();
+					}
+					UpdateFd(it->first, it->second);
+				}
+			}
+		}
+	}
+
+	//completions of all the lidars,one io_uring_enter for a wake up and none if some are ready
+	void LidarHub::HubThreadUring()
+	{
+		NVILIDAR_TRACE_THREAD_NAME("nvilidar_hub");
+		LidarApplyThreadPara(hub_thread_para);
+		uint64_t last_tick = 0;
+		LidarUringEvent event;
+
+		while (hub_running)
+		{
+			uint64_t passed = getMS() - last_tick;
+			uint32_t wait_ms = (passed >= hub_tick_ms) ? 0 : (uint32_t)(hub_tick_ms - passed);
+			hub_uring.Wait(wait_ms);
+
+			std::lock_guard<std::mutex> lock(hub_mutex);
+			for (size_t i = 0; i < hub_cancel.size(); i++)
+			{
+				hub_uring.Cancel(hub_cancel[i], NVILIDAR_HUB_CANCEL_ID);
+			}
+			hub_cancel.clear();
+
+			while (hub_uring.Next(event))
+			{
+				HandleUring(event);
+			}
+
+			uint64_t now = getMS();
+			if (now - last_tick >= hub_tick_ms)
+			{
+				last_tick = now;
+				for (std::map<int, LidarHubEntry>::iterator it = hub_sources.begin(); it != hub_sources.end(); ++it)
+				{
+					if (it->second.source.tick)
+					{
+						it->second.source.tick();
+					}
+					UpdateUring(it->first, it->second);
+				}
+			}
+		}
+	}
+}
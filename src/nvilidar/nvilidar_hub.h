@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "nvilidar_uring.h"
+#include "nvilidar_rt.h"
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_HUB_API __declspec(dllexport)
+#else
+	#define NVILIDAR_HUB_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_HUB_TICK_MS		5			//command timeout and stall check period
+#define NVILIDAR_HUB_MAX_EVENTS		32			//events of one epoll_wait
+
+namespace nvilidar
+{
+	//I/O backend of the hub
+	typedef enum
+	{
+		NVILIDAR_HUB_EPOLL = 0,		//epoll on linux,polling loop on the others
+		NVILIDAR_HUB_URING,			//io_uring,epoll if it is not supported
+	}LidarHubBackendEnum;
+
+	//one lidar in the hub,the callbacks are set by the driver
+	typedef struct
+	{
+		std::function<int()>	fd;			//fd to wait for,-1:port closed
+		std::function<void()>	read;		//fd is readable,read and unpack
+		std::function<void()>	tick;		//command timeout,stall check and reopen
+		std::function<void(const uint8_t*, size_t)>	feed;		//unpack received bytes,io_uring socket
+		std::function<uint32_t()>	open_id;	//changed by every open of the port,io_uring
+	}LidarHubSource;
+
+	//one I/O thread for many lidars(epoll or io_uring on linux,polling loop on the others)
+	class NVILIDAR_HUB_API LidarHub
+	{
+		public:
+			LidarHub();
+			~LidarHub();
+
+			bool Start(uint32_t tick_ms = NVILIDAR_HUB_TICK_MS, LidarHubBackendEnum backend = NVILIDAR_HUB_EPOLL);
+			void Stop();
+			bool IsRunning();
+			LidarHubBackendEnum GetBackend();		//backend in use
+			void SetThreadPara(LidarThreadPara para);	//cpu/priority/memory lock of the hub thread,applied by Start
+
+			int Add(LidarHubSource source);		//id of the lidar,-1:fail
+			void Remove(int id);				//no callback of the lidar after return,do not call it in a callback
+			uint32_t GetCount();
+
+			void Notify(int id);				//a circle is ready,called by the driver
+			bool Wait(std::vector<int> &ready, uint32_t timeout_ms);	//ids of the lidars with a circle ready
+
+		private:
+			typedef struct
+			{
+				LidarHubSource	source;
+				int				fd;			//fd in the epoll set or read by the ring
+				uint32_t		open_id;
+				uint32_t		generation;	//low 32 bits of the user data,old completions are dropped
+				bool			armed;		//request in the ring
+				bool			socket;		//recv into the provided buffers,else poll and read
+				bool			multishot;
+			}LidarHubEntry;
+
+			void HubThread();
+			void HubThreadUring();
+			void UpdateFd(int id, LidarHubEntry &entry);
+			void RemoveFd(LidarHubEntry &entry);
+			void UpdateUring(int id, LidarHubEntry &entry);
+			void ArmUring(int id, LidarHubEntry &entry);
+			void HandleUring(const LidarUringEvent &event);
+
+			std::thread					hub_thread;
+			std::mutex					hub_mutex;			//sources,held in the callbacks
+			std::atomic<bool>			hub_running;
+			uint32_t					hub_tick_ms;
+			LidarThreadPara				hub_thread_para;
+			int							hub_epoll;
+			int							hub_wake;			//eventfd,wake up the thread for stop
+			LidarHubBackendEnum			hub_backend;
+			LidarUring					hub_uring;			//used by the hub thread only
+			std::vector<uint64_t>		hub_cancel;			//requests of the removed lidars
+			std::map<int, LidarHubEntry>	hub_sources;
+			int							hub_next_id;
+
+			std::mutex					ready_mutex;
+			std::condition_variable		ready_cond;
+			std::vector<int>			ready_list;
+	};
+}
@@ -0,0 +1,320 @@
+#include "nvilidar_link.h"
+#include <string.h>
+
+namespace nvilidar
+{
+	LidarLinkSupervisor::LidarLinkSupervisor()
+	{
+		memset(&link_stats, 0x00, sizeof(link_stats));
+		link_stats.state = NVILIDAR_LINK_IDLE;
+		last_data_ms = 0;
+		wait_deadline_ms = 0;
+		stall_start_ms = 0;
+		next_retry_ms = 0;
+		backoff_ms = NVILIDAR_LINK_BACKOFF_MIN_MS;
+		in_outage = false;
+		link_speed = 0.0f;
+		stall_circles = NVILIDAR_LINK_STALL_CIRCLES;
+		link_stats.stall_timeout_ms = NVILIDAR_LINK_STALL_MIN_MS;
+	}
+
+	LidarLinkSupervisor::~LidarLinkSupervisor()
+	{
+	}
+
+	//scan start 
+	void LidarLinkSupervisor::Start(float aim_speed, uint64_t now)
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		link_speed = aim_speed;
+		UpdateTimeout();
+		link_stats.state = NVILIDAR_LINK_WAIT_DATA;
+		wait_deadline_ms = now + NVILIDAR_LINK_START_TIMEOUT_MS;
+		backoff_ms = NVILIDAR_LINK_BACKOFF_MIN_MS;
+		in_outage = false;
+	}
+
+	//measured speed 
+	void LidarLinkSupervisor::SetSpeed(float speed)
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		//wrong package 
+		if (speed < 0.1f)
+		{
+			return;
+		}
+		link_speed = speed;
+		UpdateTimeout();
+	}
+
+	//stall circles 
+	void LidarLinkSupervisor::SetStallCircles(double circles)
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		//not set or invalid,use default 
+		if ((circles > 0.0) && (circles <= NVILIDAR_LINK_STALL_CIRCLES_MAX))
+		{
+			stall_circles = circles;
+		}
+		else
+		{
+			stall_circles = NVILIDAR_LINK_STALL_CIRCLES;
+		}
+		UpdateTimeout();
+	}
+
+	//stall event 
+	void LidarLinkSupervisor::SetStallCallback(LidarStallCallback callback)
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		stall_callback = callback;
+	}
+
+	//timeout to wait one circle,longer when the motor speed up 
+	uint32_t LidarLinkSupervisor::GetWaitTimeout()
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		if (link_stats.state == NVILIDAR_LINK_WAIT_DATA)
+		{
+			return NVILIDAR_LINK_START_TIMEOUT_MS;
+		}
+		return link_stats.stall_timeout_ms;
+	}
+
+	//scan stop 
+	void LidarLinkSupervisor::Stop()
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		link_stats.state = NVILIDAR_LINK_IDLE;
+		in_outage = false;
+	}
+
+	//data received 
+	void LidarLinkSupervisor::Feed(uint64_t now)
+	{
+		LidarStallCallback callback;
+		uint64_t latency = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(link_mutex);
+
+			last_data_ms = now;
+			if ((link_stats.state == NVILIDAR_LINK_IDLE) || (link_stats.state == NVILIDAR_LINK_OK))
+			{
+				return;
+			}
+
+			//data is coming again 
+			if (in_outage)
+			{
+				latency = now - stall_start_ms;
+
+				link_stats.reconnect_times++;
+				link_stats.last_latency_ms = latency;
+				link_stats.total_latency_ms += latency;
+				if ((link_stats.min_latency_ms == 0) || (latency < link_stats.min_latency_ms))
+				{
+					link_stats.min_latency_ms = latency;
+				}
+				if (latency > link_stats.max_latency_ms)
+				{
+					link_stats.max_latency_ms = latency;
+				}
+				in_outage = false;
+				callback = stall_callback;
+			}
+			link_stats.state = NVILIDAR_LINK_OK;
+			backoff_ms = NVILIDAR_LINK_BACKOFF_MIN_MS;
+		}
+
+		//recover event(no lock)
+		if (callback)
+		{
+			callback(false, latency);
+		}
+	}
+
+	//need to reopen the port? 
+	bool LidarLinkSupervisor::NeedReopen(uint64_t now)
+	{
+		LidarStallCallback callback;
+		uint64_t silent_ms = 0;			//not 0:stall is detected now 
+		bool ret = false;
+
+		{
+			std::lock_guard<std::mutex> lock(link_mutex);
+
+			if (link_stats.state == NVILIDAR_LINK_OK)
+			{
+				if (now - last_data_ms < link_stats.stall_timeout_ms)
+				{
+					return false;
+				}
+				//stalled,reopen at once 
+				link_stats.stall_times++;
+				link_stats.state = NVILIDAR_LINK_RECONNECT;
+				stall_start_ms = now;
+				in_outage = true;
+				silent_ms = now - last_data_ms;
+				ret = true;
+			}
+			else
+			{
+				ret = CheckRetry(now, silent_ms);
+			}
+			if (silent_ms > 0)
+			{
+				callback = stall_callback;
+			}
+		}
+
+		//stall event(no lock)
+		if (callback)
+		{
+			callback(true, silent_ms);
+		}
+
+		return ret;
+	}
+
+	//wait data timeout or retry time is up(lock must be held) 
+	bool LidarLinkSupervisor::CheckRetry(uint64_t now, uint64_t &silent_ms)
+	{
+		switch (link_stats.state)
+		{
+			case NVILIDAR_LINK_WAIT_DATA:
+			{
+				if (now < wait_deadline_ms)
+				{
+					return false;
+				}
+				//no data after start or reopen 
+				if (in_outage)
+				{
+					link_stats.reopen_fail_times++;
+				}
+				else
+				{
+					link_stats.stall_times++;
+					stall_start_ms = now;
+					in_outage = true;
+					silent_ms = NVILIDAR_LINK_START_TIMEOUT_MS;
+				}
+				Retry(now);
+				return false;
+			}
+			case NVILIDAR_LINK_RECONNECT:
+			{
+				return (now >= next_retry_ms);
+			}
+			default:
+				break;
+		}
+
+		return false;
+	}
+
+	//reopen result 
+	void LidarLinkSupervisor::ReopenResult(bool ok, uint64_t now)
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		if (link_stats.state == NVILIDAR_LINK_IDLE)
+		{
+			return;
+		}
+
+		if (ok)
+		{
+			link_stats.state = NVILIDAR_LINK_WAIT_DATA;
+			wait_deadline_ms = now + NVILIDAR_LINK_START_TIMEOUT_MS;
+		}
+		else
+		{
+			link_stats.reopen_fail_times++;
+			Retry(now);
+		}
+	}
+
+	//port unplugged:stalled now,reopen to release the dead port(the same name is given again) 
+	//port plugged in:the retry does not wait for the backoff 
+	void LidarLinkSupervisor::PortEvent(bool present, uint64_t now)
+	{
+		LidarStallCallback callback;
+		uint64_t silent_ms = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(link_mutex);
+
+			if (link_stats.state == NVILIDAR_LINK_IDLE)
+			{
+				return;
+			}
+			if (present && (link_stats.state != NVILIDAR_LINK_RECONNECT))
+			{
+				return;
+			}
+
+			if ((!present) && (!in_outage))
+			{
+				link_stats.stall_times++;
+				stall_start_ms = now;
+				in_outage = true;
+				silent_ms = (now > last_data_ms) ? (now - last_data_ms) : 1;
+				callback = stall_callback;
+			}
+			link_stats.state = NVILIDAR_LINK_RECONNECT;
+			next_retry_ms = now;
+			backoff_ms = NVILIDAR_LINK_BACKOFF_MIN_MS;
+		}
+
+		//stall event(no lock)
+		if (callback)
+		{
+			callback(true, silent_ms);
+		}
+	}
+
+	//statistics 
+	LidarLinkStats LidarLinkSupervisor::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(link_mutex);
+
+		return link_stats;
+	}
+
+	//stall timeout from speed 
+	void LidarLinkSupervisor::UpdateTimeout()
+	{
+		uint32_t timeout = NVILIDAR_LINK_STALL_MIN_MS;
+
+		//N circles of the speed 
+		if (link_speed > 0.1f)
+		{
+			timeout = (uint32_t)(stall_circles * 1000.0 / link_speed);
+		}
+		if (timeout < NVILIDAR_LINK_STALL_MIN_MS)
+		{
+			timeout = NVILIDAR_LINK_STALL_MIN_MS;
+		}
+		link_stats.stall_timeout_ms = timeout;
+	}
+
+	//exponential backoff 
+	void LidarLinkSupervisor::Retry(uint64_t now)
+	{
+		link_stats.state = NVILIDAR_LINK_RECONNECT;
+		next_retry_ms = now + backoff_ms;
+		backoff_ms *= 2;
+		if (backoff_ms > NVILIDAR_LINK_BACKOFF_MAX_MS)
+		{
+			backoff_ms = NVILIDAR_LINK_BACKOFF_MAX_MS;
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <functional>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_LINK_API __declspec(dllexport)
+#else
+	#define NVILIDAR_LINK_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_LINK_STALL_CIRCLES		2.0			//no data for N circles,the link is stalled(default)
+#define NVILIDAR_LINK_STALL_CIRCLES_MAX	100.0		//max stall circles
+#define NVILIDAR_LINK_STALL_MIN_MS		100			//min stall timeout
+#define NVILIDAR_LINK_START_TIMEOUT_MS	3000		//wait for the first data after start(motor speed up)
+#define NVILIDAR_LINK_BACKOFF_MIN_MS	50			//first retry delay
+#define NVILIDAR_LINK_BACKOFF_MAX_MS	5000		//max retry delay
+
+//link state
+typedef enum
+{
+	NVILIDAR_LINK_IDLE = 0,			//lidar is not scanning
+	NVILIDAR_LINK_WAIT_DATA,		//scan start or reopen,wait for the first data
+	NVILIDAR_LINK_OK,				//data is coming
+	NVILIDAR_LINK_RECONNECT,		//stalled,reopen with backoff
+}LidarLinkStateEnum;
+
+//link statistics
+typedef struct
+{
+	LidarLinkStateEnum	state;			//current state
+	uint32_t	stall_times;			//stall detected times
+	uint32_t	reconnect_times;		//reconnect ok times(data is coming again)
+	uint32_t	reopen_fail_times;		//reopen fail or no data after reopen
+	uint32_t	stall_timeout_ms;		//current stall timeout
+	uint64_t	last_latency_ms;		//stall detected -> data again,last time
+	uint64_t	min_latency_ms;
+	uint64_t	max_latency_ms;
+	uint64_t	total_latency_ms;		//avg = total / reconnect_times
+}LidarLinkStats;
+
+//stall event,stalled: ms is the time without data.recover: ms is the latency(called in the driver thread,return quickly)
+typedef std::function<void(bool stalled, uint64_t ms)> LidarStallCallback;
+
+namespace nvilidar
+{
+	//link supervisor,the reader thread feed data time and check if the port need to be reopened
+	class NVILIDAR_LINK_API LidarLinkSupervisor
+	{
+		public:
+			LidarLinkSupervisor();
+			~LidarLinkSupervisor();
+
+			void Start(float aim_speed, uint64_t now);		//scan start,aim_speed is in Hz
+			void SetSpeed(float speed);						//measured speed(Hz),from the 0 angle package
+			void SetStallCircles(double circles);			//no data for N circles,the link is stalled
+			void SetStallCallback(LidarStallCallback callback);	//stall event
+			uint32_t GetWaitTimeout();						//timeout to wait one circle
+			void Stop();									//scan stop
+			void Feed(uint64_t now);						//data received
+			bool NeedReopen(uint64_t now);					//stalled and retry time is up
+			void ReopenResult(bool ok, uint64_t now);		//reopen result
+			void PortEvent(bool present, uint64_t now);		//port hotplug,reopen at once
+			LidarLinkStats GetStats();						//statistics
+
+		private:
+			void Retry(uint64_t now);						//schedule next retry(lock must be held)
+			void UpdateTimeout();							//stall timeout from speed(lock must be held)
+			bool CheckRetry(uint64_t now, uint64_t &silent_ms);	//wait data timeout or retry time is up(lock must be held)
+
+			std::mutex		link_mutex;
+			LidarLinkStats	link_stats;
+			uint64_t		last_data_ms;			//last data time
+			uint64_t		wait_deadline_ms;		//wait data deadline
+			uint64_t		stall_start_ms;			//stall detected time
+			uint64_t		next_retry_ms;			//next reopen time
+			uint32_t		backoff_ms;				//current retry delay
+			bool			in_outage;				//stalled,data is not coming again
+			float			link_speed;				//measured or aim speed(Hz)
+			double			stall_circles;			//stall timeout = N circles
+			LidarStallCallback	stall_callback;		//stall event
+	};
+}
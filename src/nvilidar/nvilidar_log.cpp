@@ -0,0 +1,227 @@
+#include "nvilidar_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "myconsole.h"
+
+namespace nvilidar
+{
+	LidarLogger &LidarLogger::instance()
+	{
+		static LidarLogger logger;
+		return logger;
+	}
+
+	LidarLogger::LidarLogger()
+	{
+		for (uint64_t i = 0; i < NVILIDAR_LOG_QUEUE_SIZE; i++)
+		{
+			log_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		log_enqueue_pos.store(0, std::memory_order_relaxed);
+		log_dequeue_pos.store(0, std::memory_order_relaxed);
+		log_dropped.store(0, std::memory_order_relaxed);
+		log_dropped_reported = 0;
+		log_level.store(NVILIDAR_LOG_MIN_LEVEL, std::memory_order_relaxed);
+		log_running = true;
+
+		log_thread = std::thread(&LidarLogger::FlushThread, this);
+	}
+
+	LidarLogger::~LidarLogger()
+	{
+		{
+			std::lock_guard<std::mutex> lock(log_mutex);
+			log_running = false;
+		}
+		log_cond.notify_all();
+		if (log_thread.joinable())
+		{
+			log_thread.join();
+		}
+
+		//write the rest
+		std::lock_guard<std::mutex> lock(log_mutex);
+		while (Pop())
+		{
+		}
+		fflush(stdout);
+	}
+
+	//format into a free slot,the message is dropped when the ring is full
+	void LidarLogger::LogV(int level, const char *prefix, const char *format, va_list args)
+	{
+		if (!IsEnabled(level))
+		{
+			return;
+		}
+
+		uint64_t pos = log_enqueue_pos.load(std::memory_order_relaxed);
+		LogSlot *slot = NULL;
+
+		//bounded MPMC queue,a slot is free when sequence == pos
+		while (true)
+		{
+			slot = &log_slots[pos & (NVILIDAR_LOG_QUEUE_SIZE - 1)];
+			uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+			int64_t differ = (int64_t)(seq - pos);
+
+			if (differ == 0)
+			{
+				if (log_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (differ < 0)
+			{
+				log_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				pos = log_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		size_t len = 0;
+		if (prefix != NULL)
+		{
+			len = strlen(prefix);
+			if (len >= NVILIDAR_LOG_MSG_SIZE)
+			{
+				len = NVILIDAR_LOG_MSG_SIZE - 1;
+			}
+			memcpy(slot->text, prefix, len);
+		}
+		vsnprintf(slot->text + len, NVILIDAR_LOG_MSG_SIZE - len, format, args);
+		slot->text[NVILIDAR_LOG_MSG_SIZE - 1] = '\0';
+		slot->level = level;
+		slot->sequence.store(pos + 1, std::memory_order_release);
+
+		log_cond.notify_one();
+	}
+
+	//change output
+	void LidarLogger::SetSink(LidarLogSink sink)
+	{
+		std::lock_guard<std::mutex> lock(log_mutex);
+		log_sink = sink;
+	}
+
+	//runtime level
+	void LidarLogger::SetLevel(int level)
+	{
+		log_level.store((level > NVILIDAR_LOG_MIN_LEVEL) ? level : NVILIDAR_LOG_MIN_LEVEL, std::memory_order_relaxed);
+	}
+
+	//wait for the flush thread,eg. before read from stdin
+	void LidarLogger::Flush()
+	{
+		uint64_t target = log_enqueue_pos.load(std::memory_order_acquire);
+
+		log_cond.notify_one();
+		while (log_dequeue_pos.load(std::memory_order_acquire) < target)
+		{
+			{
+				std::lock_guard<std::mutex> lock(log_mutex);
+				if (!log_running)
+				{
+					break;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	uint64_t LidarLogger::GetDropped()
+	{
+		return log_dropped.load(std::memory_order_relaxed);
+	}
+
+	//write one message,log_mutex must be held
+	bool LidarLogger::Pop()
+	{
+		uint64_t pos = log_dequeue_pos.load(std::memory_order_relaxed);
+		LogSlot &slot = log_slots[pos & (NVILIDAR_LOG_QUEUE_SIZE - 1)];
+
+		if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+		{
+			return false;
+		}
+
+		if (log_sink)
+		{
+			log_sink(slot.level, slot.text);
+		}
+		else
+		{
+			ConsoleSink(slot.level, slot.text);
+		}
+
+		//free the slot
+		slot.sequence.store(pos + NVILIDAR_LOG_QUEUE_SIZE, std::memory_order_release);
+		log_dequeue_pos.store(pos + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	//flush thread
+	void LidarLogger::FlushThread()
+	{
+		std::unique_lock<std::mutex> lock(log_mutex);
+
+		while (log_running)
+		{
+			bool written = false;
+			while (Pop())
+			{
+				written = true;
+			}
+
+			//report dropped messages
+			uint64_t dropped = log_dropped.load(std::memory_order_relaxed);
+			if (dropped != log_dropped_reported)
+			{
+				char text[64];
+				snprintf(text, sizeof(text), "%llu log messages dropped", (unsigned long long)(dropped - log_dropped_reported));
+				log_dropped_reported = dropped;
+				if (log_sink)
+				{
+					log_sink(NVILIDAR_LOG_LEVEL_WARNING, text);
+				}
+				else
+				{
+					ConsoleSink(NVILIDAR_LOG_LEVEL_WARNING, text);
+				}
+				written = true;
+			}
+			if (written)
+			{
+				fflush(stdout);
+			}
+
+			log_cond.wait_for(lock, std::chrono::milliseconds(NVILIDAR_LOG_FLUSH_PERIOD));
+		}
+	}
+
+	//colored console output
+	void LidarLogger::ConsoleSink(int level, const char *text)
+	{
+	#if defined (_WIN32)
+		static const WORD color[4] = { 0x03, 0x02, 0x06, 0x04 };
+		static const char *prefix[4] = { "Debug: ", "", "Warning: ", "Error: " };
+		int index = ((level >= NVILIDAR_LOG_LEVEL_DEBUG) && (level <= NVILIDAR_LOG_LEVEL_ERROR)) ? level : NVILIDAR_LOG_LEVEL_INFO;
+
+		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color[index]);
+		printf("%s%s\r\n", prefix[index], text);
+		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 0x07);
+	#else
+		static const char *color[4] = { COLOR_CYAN, COLOR_GREEN, COLOR_YELLOW, COLOR_RED };
+		static const char *prefix[4] = { "Debug: ", "", "Warning: ", "Error: " };
+		int index = ((level >= NVILIDAR_LOG_LEVEL_DEBUG) && (level <= NVILIDAR_LOG_LEVEL_ERROR)) ? level : NVILIDAR_LOG_LEVEL_INFO;
+
+		printf("%s%s%s\n" COLOR_NONE, color[index], prefix[index], text);
+	#endif
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_LOG_API __declspec(dllexport)
+#else
+	#define NVILIDAR_LOG_API
+#endif // ifdef WIN32
+
+//log level
+#define NVILIDAR_LOG_LEVEL_DEBUG		0
+#define NVILIDAR_LOG_LEVEL_INFO			1
+#define NVILIDAR_LOG_LEVEL_WARNING		2
+#define NVILIDAR_LOG_LEVEL_ERROR		3
+#define NVILIDAR_LOG_LEVEL_OFF			4
+
+//the lower level is compiled away,eg. -DNVILIDAR_LOG_MIN_LEVEL=2 keep warning and error only
+#ifndef NVILIDAR_LOG_MIN_LEVEL
+	#define NVILIDAR_LOG_MIN_LEVEL		NVILIDAR_LOG_LEVEL_INFO
+#endif
+
+#define NVILIDAR_LOG_QUEUE_SIZE			256			//messages in the ring(power of 2)
+#define NVILIDAR_LOG_MSG_SIZE			1024		//max length of one message
+#define NVILIDAR_LOG_FLUSH_PERIOD		20			//flush thread wake up period(ms)
+
+typedef std::function<void(int level, const char *text)> LidarLogSink;		//log output,called in the flush thread
+
+namespace nvilidar
+{
+	//async logger,messages are formatted in the caller and written by the flush thread
+	class NVILIDAR_LOG_API LidarLogger
+	{
+		public:
+			static LidarLogger &instance();		//one logger for the whole library
+
+			void LogV(int level, const char *prefix, const char *format, va_list args);	//format and push,never block
+			void SetSink(LidarLogSink sink);		//null: default console output
+			void SetLevel(int level);				//runtime level,above the compile time level
+			bool IsEnabled(int level)
+			{
+				return level >= log_level.load(std::memory_order_relaxed);
+			}
+			void Flush();							//wait until all messages are written
+			uint64_t GetDropped();					//messages dropped because the ring is full
+
+			static void ConsoleSink(int level, const char *text);	//default output,colored console
+
+		private:
+			LidarLogger();
+			~LidarLogger();
+			LidarLogger(const LidarLogger &);
+			LidarLogger &operator=(const LidarLogger &);
+
+			bool Pop();								//write one message,false if empty
+			void FlushThread();
+
+			//one message in the ring
+			struct LogSlot
+			{
+				std::atomic<uint64_t>	sequence;
+				int						level;
+				char					text[NVILIDAR_LOG_MSG_SIZE];
+			};
+
+			LogSlot					log_slots[NVILIDAR_LOG_QUEUE_SIZE];
+			std::atomic<uint64_t>	log_enqueue_pos;
+			std::atomic<uint64_t>	log_dequeue_pos;
+			std::atomic<uint64_t>	log_dropped;
+			uint64_t				log_dropped_reported;
+			std::atomic<int>		log_level;
+
+			std::thread				log_thread;
+			std::mutex				log_mutex;		//sink and thread wait,never taken by the caller of LogV
+			std::condition_variable	log_cond;
+			bool					log_running;
+			LidarLogSink			log_sink;
+	};
+}
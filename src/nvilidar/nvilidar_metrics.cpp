@@ -0,0 +1,602 @@
+#include "nvilidar_metrics.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include "mytimer.h"
+#if defined(_WIN32)
+#include <intrin.h>
+#else
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+namespace nvilidar
+{
+	//counter names(same order as LidarMetricCounterEnum)
+	static const char *metric_counter_name[NVILIDAR_METRIC_COUNTER_NUM] =
+	{
+		"bytes_read_total",
+		"packages_valid_total",
+		"header_errors_total",
+		"checksum_errors_total",
+		"packages_recovered_total",
+		"bytes_discarded_total",
+		"circles_total",
+		"zero_lost_total",
+		"missing_packages_total",
+		"scans_output_total",
+		"scans_dropped_total",
+		"sampling_timeouts_total",
+	};
+
+	//gauge names(same order as LidarMetricGaugeEnum)
+	static const char *metric_gauge_name[NVILIDAR_METRIC_GAUGE_NUM] =
+	{
+		"points_per_circle",
+		"packages_per_circle",
+		"circle_period_us",
+	};
+
+	//histogram names(same order as LidarMetricHistEnum)
+	static const char *metric_hist_name[NVILIDAR_METRIC_HIST_NUM] =
+	{
+		"package_interval_us",
+		"circle_period_hist_us",
+		"points_per_circle_hist",
+		"process_us",
+		"delivery_us",
+	};
+
+	//index of the highest bit
+	static inline uint32_t HighestBit(uint64_t value)
+	{
+	#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanReverse64(&index, value);
+		return (uint32_t)index;
+	#else
+		return 63 - (uint32_t)__builtin_clzll(value);
+	#endif
+	}
+
+	//---------------------------------histogram---------------------------------
+	LidarHistogram::LidarHistogram()
+	{
+		Reset();
+	}
+
+	//value to bucket,the first 2*SUB_COUNT values is exact
+	uint32_t LidarHistogram::BucketIndex(uint64_t value)
+	{
+		if (value < 2 * NVILIDAR_HIST_SUB_COUNT)
+		{
+			return (uint32_t)value;
+		}
+
+		uint32_t shift = HighestBit(value) - NVILIDAR_HIST_SUB_BITS;
+		uint32_t index = (shift + 1) * NVILIDAR_HIST_SUB_COUNT + (uint32_t)((value >> shift) - NVILIDAR_HIST_SUB_COUNT);
+
+		return (index < NVILIDAR_HIST_BUCKETS) ? index : (NVILIDAR_HIST_BUCKETS - 1);
+	}
+
+	//bucket to value
+	uint64_t LidarHistogram::BucketValue(uint32_t index)
+	{
+		if (index < 2 * NVILIDAR_HIST_SUB_COUNT)
+		{
+			return index;
+		}
+
+		uint32_t shift = index / NVILIDAR_HIST_SUB_COUNT - 1;
+		uint64_t low = ((uint64_t)(index % NVILIDAR_HIST_SUB_COUNT) + NVILIDAR_HIST_SUB_COUNT) << shift;
+
+		return low + (((uint64_t)1 << shift) >> 1);
+	}
+
+	//add one value
+	void LidarHistogram::Record(uint64_t value)
+	{
+		hist_buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		hist_sum.fetch_add(value, std::memory_order_relaxed);
+
+		uint64_t old = hist_min.load(std::memory_order_relaxed);
+		while ((value < old) && (!hist_min.compare_exchange_weak(old, value, std::memory_order_relaxed)))
+		{
+		}
+		old = hist_max.load(std::memory_order_relaxed);
+		while ((value > old) && (!hist_max.compare_exchange_weak(old, value, std::memory_order_relaxed)))
+		{
+		}
+	}
+
+	//count,mean and percentile
+	void LidarHistogram::Summary(LidarHistogramSummary &summary)
+	{
+		static const double percent[4] = { 0.5, 0.9, 0.99, 0.999 };
+		uint64_t value[4] = { 0 };
+		uint64_t total = 0;
+
+		memset(&summary, 0x00, sizeof(summary));
+
+		//the buckets may change while reading,so count again
+		uint64_t buckets[NVILIDAR_HIST_BUCKETS];
+		for (uint32_t i = 0; i < NVILIDAR_HIST_BUCKETS; i++)
+		{
+			buckets[i] = hist_buckets[i].load(std::memory_order_relaxed);
+			total += buckets[i];
+		}
+		if (total == 0)
+		{
+			return;
+		}
+
+		int p = 0;
+		uint64_t sum = 0;
+		for (uint32_t i = 0; (i < NVILIDAR_HIST_BUCKETS) && (p < 4); i++)
+		{
+			sum += buckets[i];
+			while ((p < 4) && (sum >= (uint64_t)(percent[p] * total + 0.5)) && (sum > 0))
+			{
+				value[p] = BucketValue(i);
+				p++;
+			}
+		}
+
+		summary.count = total;
+		summary.sum = hist_sum.load(std::memory_order_relaxed);
+		summary.min = hist_min.load(std::memory_order_relaxed);
+		summary.max = hist_max.load(std::memory_order_relaxed);
+		summary.mean = (double)summary.sum / (double)total;		//the count of the buckets above,not 0 
+		summary.p50 = value[0];
+		summary.p90 = value[1];
+		summary.p99 = value[2];
+		summary.p999 = value[3];
+
+		//the bucket value is the middle,keep it in the real range
+		uint64_t *limit[4] = { &summary.p50, &summary.p90, &summary.p99, &summary.p999 };
+		for (int i = 0; i < 4; i++)
+		{
+			if (*limit[i] > summary.max)
+			{
+				*limit[i] = summary.max;
+			}
+			if (*limit[i] < summary.min)
+			{
+				*limit[i] = summary.min;
+			}
+		}
+	}
+
+	//clear
+	void LidarHistogram::Reset()
+	{
+		for (uint32_t i = 0; i < NVILIDAR_HIST_BUCKETS; i++)
+		{
+			hist_buckets[i].store(0, std::memory_order_relaxed);
+		}
+		hist_sum.store(0, std::memory_order_relaxed);
+		hist_min.store(UINT64_MAX, std::memory_order_relaxed);
+		hist_max.store(0, std::memory_order_relaxed);
+	}
+
+	//---------------------------------metrics---------------------------------
+	LidarMetrics::LidarMetrics()
+	{
+		Reset();
+	}
+
+	//read all
+	void LidarMetrics::Snapshot(LidarStats &stats)
+	{
+		memset(&stats, 0x00, sizeof(stats));
+
+		stats.uptime_ms = getMS() - metric_start_ms;
+		for (int i = 0; i < NVILIDAR_METRIC_COUNTER_NUM; i++)
+		{
+			stats.counters[i] = metric_counters[i].load(std::memory_order_relaxed);
+		}
+		for (int i = 0; i < NVILIDAR_METRIC_GAUGE_NUM; i++)
+		{
+			stats.gauges[i] = metric_gauges[i].load(std::memory_order_relaxed);
+		}
+		for (int i = 0; i < NVILIDAR_METRIC_HIST_NUM; i++)
+		{
+			metric_hists[i].Summary(stats.histograms[i]);
+		}
+
+		uint64_t period = stats.gauges[NVILIDAR_METRIC_CIRCLE_PERIOD_US];
+		if (period > 0)
+		{
+			stats.circles_per_second = 1000000.0 / period;
+			stats.packages_per_second = stats.gauges[NVILIDAR_METRIC_PACKAGES_PER_CIRCLE] * 1000000.0 / period;
+		}
+	}
+
+	//clear
+	void LidarMetrics::Reset()
+	{
+		for (int i = 0; i < NVILIDAR_METRIC_COUNTER_NUM; i++)
+		{
+			metric_counters[i].store(0, std::memory_order_relaxed);
+		}
+		for (int i = 0; i < NVILIDAR_METRIC_GAUGE_NUM; i++)
+		{
+			metric_gauges[i].store(0, std::memory_order_relaxed);
+		}
+		for (int i = 0; i < NVILIDAR_METRIC_HIST_NUM; i++)
+		{
+			metric_hists[i].Reset();
+		}
+		metric_start_ms = getMS();
+	}
+
+	const char *LidarMetrics::CounterName(int counter)
+	{
+		return ((counter >= 0) && (counter < NVILIDAR_METRIC_COUNTER_NUM)) ? metric_counter_name[counter] : "";
+	}
+
+	const char *LidarMetrics::GaugeName(int gauge)
+	{
+		return ((gauge >= 0) && (gauge < NVILIDAR_METRIC_GAUGE_NUM)) ? metric_gauge_name[gauge] : "";
+	}
+
+	const char *LidarMetrics::HistName(int hist)
+	{
+		return ((hist >= 0) && (hist < NVILIDAR_METRIC_HIST_NUM)) ? metric_hist_name[hist] : "";
+	}
+
+	//prometheus text format
+	std::string LidarMetrics::FormatPrometheus(const LidarStats &stats)
+	{
+		std::string text;
+		char line[256];
+
+		for (int i = 0; i < NVILIDAR_METRIC_COUNTER_NUM; i++)
+		{
+			snprintf(line, sizeof(line), "# TYPE nvilidar_%s counter\nnvilidar_%s %llu\n",
+				metric_counter_name[i], metric_counter_name[i], (unsigned long long)stats.counters[i]);
+			text += line;
+		}
+		for (int i = 0; i < NVILIDAR_METRIC_GAUGE_NUM; i++)
+		{
+			snprintf(line, sizeof(line), "# TYPE nvilidar_%s gauge\nnvilidar_%s %llu\n",
+				metric_gauge_name[i], metric_gauge_name[i], (unsigned long long)stats.gauges[i]);
+			text += line;
+		}
+		snprintf(line, sizeof(line), "# TYPE nvilidar_packages_per_second gauge\nnvilidar_packages_per_second %.3f\n"
+									"# TYPE nvilidar_circles_per_second gauge\nnvilidar_circles_per_second %.3f\n"
+									"# TYPE nvilidar_uptime_ms gauge\nnvilidar_uptime_ms %llu\n",
+			stats.packages_per_second, stats.circles_per_second, (unsigned long long)stats.uptime_ms);
+		text += line;
+
+		for (int i = 0; i < NVILIDAR_METRIC_HIST_NUM; i++)
+		{
+			const LidarHistogramSummary &h = stats.histograms[i];
+			const char *name = metric_hist_name[i];
+
+			snprintf(line, sizeof(line), "# TYPE nvilidar_%s summary\n"
+										"nvilidar_%s{quantile=\"0.5\"} %llu\n"
+										"nvilidar_%s{quantile=\"0.9\"} %llu\n"
+										"nvilidar_%s{quantile=\"0.99\"} %llu\n"
+										"nvilidar_%s{quantile=\"0.999\"} %llu\n",
+				name, name, (unsigned long long)h.p50, name, (unsigned long long)h.p90,
+				name, (unsigned long long)h.p99, name, (unsigned long long)h.p999);
+			text += line;
+			snprintf(line, sizeof(line), "nvilidar_%s_sum %llu\nnvilidar_%s_count %llu\n"
+										"# TYPE nvilidar_%s_max gauge\nnvilidar_%s_max %llu\n",
+				name, (unsigned long long)h.sum, name, (unsigned long long)h.count,
+				name, name, (unsigned long long)h.max);
+			text += line;
+		}
+
+		snprintf(line, sizeof(line), "# TYPE nvilidar_link_state gauge\nnvilidar_link_state %d\n"
+									"# TYPE nvilidar_link_stalls_total counter\nnvilidar_link_stalls_total %u\n"
+									"# TYPE nvilidar_link_reconnects_total counter\nnvilidar_link_reconnects_total %u\n",
+			(int)stats.link.state, stats.link.stall_times, stats.link.reconnect_times);
+		text += line;
+		snprintf(line, sizeof(line), "# TYPE nvilidar_link_reopen_failures_total counter\nnvilidar_link_reopen_failures_total %u\n"
+									"# TYPE nvilidar_link_stall_timeout_ms gauge\nnvilidar_link_stall_timeout_ms %llu\n",
+			stats.link.reopen_fail_times, (unsigned long long)stats.link.stall_timeout_ms);
+		text += line;
+
+		return text;
+	}
+
+	//---------------------------------latency window---------------------------------
+	LidarLatencyWindow::LidarLatencyWindow()
+	{
+		Reset();
+	}
+
+	//add one scan
+	void LidarLatencyWindow::Record(const NviLidarScanLatency &latency)
+	{
+		//time is not in order,eg. the first byte time is unknown
+		if ((latency.first_byte_us == 0) || (latency.decode_us < latency.first_byte_us) ||
+			(latency.filter_us < latency.decode_us) || (latency.handoff_us < latency.filter_us))
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(latency_mutex);
+		latency_values[0][latency_pos] = latency.decode_us - latency.first_byte_us;
+		latency_values[1][latency_pos] = latency.filter_us - latency.decode_us;
+		latency_values[2][latency_pos] = latency.handoff_us - latency.filter_us;
+		latency_values[3][latency_pos] = latency.handoff_us - latency.first_byte_us;
+		latency_pos = (latency_pos + 1) % NVILIDAR_LATENCY_WINDOW;
+		if (latency_count < NVILIDAR_LATENCY_WINDOW)
+		{
+			latency_count++;
+		}
+	}
+
+	//p50/p99/max of the window
+	void LidarLatencyWindow::Get(LidarLatencyStats &stats)
+	{
+		std::vector<uint64_t> values[4];
+
+		{
+			std::lock_guard<std::mutex> lock(latency_mutex);
+			stats.count = latency_count;
+			for (int i = 0; i < 4; i++)
+			{
+				values[i].assign(latency_values[i], latency_values[i] + latency_count);
+			}
+		}
+
+		Summary(values[0], stats.decode);
+		Summary(values[1], stats.filter);
+		Summary(values[2], stats.handoff);
+		Summary(values[3], stats.total);
+	}
+
+	void LidarLatencyWindow::Reset()
+	{
+		std::lock_guard<std::mutex> lock(latency_mutex);
+		latency_pos = 0;
+		latency_count = 0;
+	}
+
+	void LidarLatencyWindow::Summary(std::vector<uint64_t> &values, LidarLatencySummary &summary)
+	{
+		memset(&summary, 0x00, sizeof(summary));
+		if (values.empty())
+		{
+			return;
+		}
+
+		std::sort(values.begin(), values.end());
+		summary.p50 = values[(values.size() - 1) * 50 / 100];
+		summary.p99 = values[(values.size() - 1) * 99 / 100];
+		summary.max = values.back();
+	}
+
+	//---------------------------------exporter---------------------------------
+	LidarMetricsExporter::LidarMetricsExporter()
+	{
+		export_running = false;
+		export_socket = false;
+		export_fd = -1;
+		export_period_ms = NVILIDAR_STATS_EXPORT_PERIOD;
+	}
+
+	LidarMetricsExporter::~LidarMetricsExporter()
+	{
+		Stop();
+	}
+
+	//start export
+	bool LidarMetricsExporter::Start(std::string target, uint32_t period_ms, LidarStatsTextProvider provider)
+	{
+		Stop();
+
+		if (target.empty() || (!provider))
+		{
+			return false;
+		}
+
+		export_target = target;
+		export_period_ms = (period_ms > 0) ? period_ms : NVILIDAR_STATS_EXPORT_PERIOD;
+		export_provider = provider;
+		export_socket = (target.compare(0, 5, "unix:") == 0);
+		if (export_socket)
+		{
+			export_target = target.substr(5);
+			if (!OpenSocket())
+			{
+				return false;
+			}
+		}
+
+		export_running = true;
+		export_thread = std::thread(&LidarMetricsExporter::ExportThread, this);
+
+		return true;
+	}
+
+	//stop export
+	void LidarMetricsExporter::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(export_mutex);
+			export_running = false;
+		}
+		export_cond.notify_all();
+
+		if (export_thread.joinable())
+		{
+			export_thread.join();
+		}
+		CloseSocket();
+	}
+
+	//export thread
+	void LidarMetricsExporter::ExportThread()
+	{
+		while (true)
+		{
+			std::string text = export_provider();
+
+			if (export_socket)
+			{
+				//wait for clients in the period
+				ServeSocket(text, export_period_ms);
+
+				std::lock_guard<std::mutex> lock(export_mutex);
+				if (!export_running)
+				{
+					break;
+				}
+			}
+			else
+			{
+				WriteFile(text);
+
+				std::unique_lock<std::mutex> lock(export_mutex);
+				export_cond.wait_for(lock, std::chrono::milliseconds(export_period_ms), [this] { return !export_running; });
+				if (!export_running)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	//write to a temp file and rename,the reader never see half a file
+	bool LidarMetricsExporter::WriteFile(const std::string &text)
+	{
+		std::string temp = export_target + ".tmp";
+		FILE *fp = fopen(temp.c_str(), "wb");
+		if (fp == NULL)
+		{
+			return false;
+		}
+		size_t len = fwrite(text.data(), 1, text.size(), fp);
+		fclose(fp);
+		if (len != text.size())
+		{
+			return false;
+		}
+
+	#if defined(_WIN32)
+		remove(export_target.c_str());
+	#endif
+		return (rename(temp.c_str(), export_target.c_str()) == 0);
+	}
+
+#if defined(_WIN32)
+	//unix socket is not supported
+	bool LidarMetricsExporter::OpenSocket()
+	{
+		return false;
+	}
+
+	void LidarMetricsExporter::ServeSocket(const std::string &text, uint32_t wait_ms)
+	{
+		(void)text;
+		(void)wait_ms;
+	}
+
+	void LidarMetricsExporter::CloseSocket()
+	{
+	}
+#else
+	//listen on the unix socket
+	bool LidarMetricsExporter::OpenSocket()
+	{
+		struct sockaddr_un addr;
+
+		if (export_target.size() >= sizeof(addr.sun_path))
+		{
+			return false;
+		}
+
+		export_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (export_fd < 0)
+		{
+			return false;
+		}
+		fcntl(export_fd, F_SETFL, fcntl(export_fd, F_GETFL, 0) | O_NONBLOCK);
+		fcntl(export_fd, F_SETFD, FD_CLOEXEC);
+
+		memset(&addr, 0x00, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		strncpy(addr.sun_path, export_target.c_str(), sizeof(addr.sun_path) - 1);
+		unlink(export_target.c_str());
+
+		if ((bind(export_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+			(listen(export_fd, 4) < 0))
+		{
+			CloseSocket();
+			return false;
+		}
+
+		return true;
+	}
+
+	//send the text to every client in the period
+	void LidarMetricsExporter::ServeSocket(const std::string &text, uint32_t wait_ms)
+	{
+		uint64_t deadline = getMS() + wait_ms;
+
+		while (true)
+		{
+			uint64_t now = getMS();
+			if (now >= deadline)
+			{
+				break;
+			}
+			{
+				std::lock_guard<std::mutex> lock(export_mutex);
+				if (!export_running)
+				{
+					break;
+				}
+			}
+
+			//wake up at least every 100ms to check stop
+			struct pollfd pfd;
+			pfd.fd = export_fd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			uint64_t wait = deadline - now;
+			if (poll(&pfd, 1, (int)((wait > 100) ? 100 : wait)) <= 0)
+			{
+				continue;
+			}
+
+			int client = accept(export_fd, NULL, NULL);
+			if (client < 0)
+			{
+				continue;
+			}
+			size_t sent = 0;
+			while (sent < text.size())
+			{
+				ssize_t len = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+				if (len <= 0)
+				{
+					break;
+				}
+				sent += (size_t)len;
+			}
+			close(client);
+		}
+	}
+
+	//close and remove the socket file
+	void LidarMetricsExporter::CloseSocket()
+	{
+		if (export_fd >= 0)
+		{
+			close(export_fd);
+			export_fd = -1;
+			unlink(export_target.c_str());
+		}
+	}
+#endif
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include "nvilidar_link.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_METRICS_API __declspec(dllexport)
+#else
+	#define NVILIDAR_METRICS_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_HIST_SUB_BITS			4			//16 sub buckets for every power of 2(error < 6.25%)
+#define NVILIDAR_HIST_SUB_COUNT			(1 << NVILIDAR_HIST_SUB_BITS)
+#define NVILIDAR_HIST_MAX_BITS			40			//max value 2^40(us,about 12 days)
+#define NVILIDAR_HIST_BUCKETS			((NVILIDAR_HIST_MAX_BITS - NVILIDAR_HIST_SUB_BITS + 1) * NVILIDAR_HIST_SUB_COUNT)
+#define NVILIDAR_STATS_EXPORT_PERIOD	1000		//default export period(ms)
+#define NVILIDAR_LATENCY_WINDOW			512			//scans in the rolling latency window
+
+//counters
+typedef enum
+{
+	NVILIDAR_METRIC_BYTES_READ = 0,			//bytes read from serialport/socket
+	NVILIDAR_METRIC_PACKAGES_VALID,			//checksum ok
+	NVILIDAR_METRIC_HEADER_ERRORS,			//header error(packageErrFlag)
+	NVILIDAR_METRIC_CHECKSUM_ERRORS,		//checksum error
+	NVILIDAR_METRIC_PACKAGES_RECOVERED,		//found by rescan the bytes of a wrong package
+	NVILIDAR_METRIC_BYTES_DISCARDED,		//bytes not in any valid package
+	NVILIDAR_METRIC_CIRCLES,				//circles closed
+	NVILIDAR_METRIC_ZERO_LOST,				//circles closed at angle wrap
+	NVILIDAR_METRIC_MISSING_PACKAGES,		//lost packages(estimated from angle gaps)
+	NVILIDAR_METRIC_SCANS_OUTPUT,			//scans returned by LidarSamplingProcess
+	NVILIDAR_METRIC_SCANS_DROPPED,			//circles overwritten before LidarSamplingProcess took them
+	NVILIDAR_METRIC_SAMPLING_TIMEOUTS,		//LidarSamplingProcess timeout
+	NVILIDAR_METRIC_COUNTER_NUM,
+}LidarMetricCounterEnum;
+
+//gauges
+typedef enum
+{
+	NVILIDAR_METRIC_POINTS_PER_CIRCLE = 0,	//points of the last circle
+	NVILIDAR_METRIC_PACKAGES_PER_CIRCLE,	//packages of the last circle
+	NVILIDAR_METRIC_CIRCLE_PERIOD_US,		//time of the last circle
+	NVILIDAR_METRIC_GAUGE_NUM,
+}LidarMetricGaugeEnum;
+
+//histograms(us or count)
+typedef enum
+{
+	NVILIDAR_METRIC_PACKAGE_INTERVAL_US = 0,	//time between 2 valid packages
+	NVILIDAR_METRIC_CIRCLE_PERIOD_HIST_US,		//time between 2 circles
+	NVILIDAR_METRIC_POINTS_HIST,				//points per circle
+	NVILIDAR_METRIC_PROCESS_US,					//filter and convert one circle
+	NVILIDAR_METRIC_DELIVERY_US,				//circle closed -> scan returned to the caller
+	NVILIDAR_METRIC_HIST_NUM,
+}LidarMetricHistEnum;
+
+//histogram summary
+typedef struct
+{
+	uint64_t	count;
+	uint64_t	sum;
+	uint64_t	min;
+	uint64_t	max;
+	double		mean;
+	uint64_t	p50;
+	uint64_t	p90;
+	uint64_t	p99;
+	uint64_t	p999;
+}LidarHistogramSummary;
+
+//all statistics of one lidar
+typedef struct
+{
+	uint64_t	uptime_ms;									//time from driver create
+	uint64_t	counters[NVILIDAR_METRIC_COUNTER_NUM];		//see LidarMetricCounterEnum
+	uint64_t	gauges[NVILIDAR_METRIC_GAUGE_NUM];			//see LidarMetricGaugeEnum
+	double		packages_per_second;						//of the last circle
+	double		circles_per_second;							//of the last circle
+	LidarHistogramSummary	histograms[NVILIDAR_METRIC_HIST_NUM];	//see LidarMetricHistEnum
+	LidarLinkStats			link;						//stall and reconnect
+}LidarStats;
+
+//rolling latency(us)
+typedef struct
+{
+	uint64_t	p50;
+	uint64_t	p99;
+	uint64_t	max;
+}LidarLatencySummary;
+
+//latency of the last scans,from the scan latency probe
+typedef struct
+{
+	uint32_t	count;						//scans in the window
+	LidarLatencySummary	decode;			//first byte -> decoded(read wait,unpack)
+	LidarLatencySummary	filter;			//decoded -> filter finished(thread wake up,filter)
+	LidarLatencySummary	handoff;		//filter finished -> returned(convert)
+	LidarLatencySummary	total;			//first byte -> returned
+}LidarLatencyStats;
+
+namespace nvilidar
+{
+	//log-linear histogram(HDR style),record is lock free
+	class NVILIDAR_METRICS_API LidarHistogram
+	{
+		public:
+			LidarHistogram();
+
+			void Record(uint64_t value);
+			void Summary(LidarHistogramSummary &summary);
+			void Reset();
+
+		private:
+			static uint32_t BucketIndex(uint64_t value);
+			static uint64_t BucketValue(uint32_t index);	//middle value of the bucket
+
+			std::atomic<uint64_t>	hist_buckets[NVILIDAR_HIST_BUCKETS];
+			std::atomic<uint64_t>	hist_sum;
+			std::atomic<uint64_t>	hist_min;
+			std::atomic<uint64_t>	hist_max;
+	};
+
+	//metrics registry of one driver,all update is lock free
+	class NVILIDAR_METRICS_API LidarMetrics
+	{
+		public:
+			LidarMetrics();
+
+			void Add(LidarMetricCounterEnum counter, uint64_t value = 1)
+			{
+				metric_counters[counter].fetch_add(value, std::memory_order_relaxed);
+			}
+			void Set(LidarMetricGaugeEnum gauge, uint64_t value)
+			{
+				metric_gauges[gauge].store(value, std::memory_order_relaxed);
+			}
+			void Record(LidarMetricHistEnum hist, uint64_t value)
+			{
+				metric_hists[hist].Record(value);
+			}
+			uint64_t Get(LidarMetricCounterEnum counter)
+			{
+				return metric_counters[counter].load(std::memory_order_relaxed);
+			}
+
+			void Snapshot(LidarStats &stats);				//read all(link stats is not filled)
+			void Reset();
+
+			static const char *CounterName(int counter);	//prometheus name
+			static const char *GaugeName(int gauge);
+			static const char *HistName(int hist);
+			static std::string FormatPrometheus(const LidarStats &stats);	//prometheus text format
+
+		private:
+			std::atomic<uint64_t>	metric_counters[NVILIDAR_METRIC_COUNTER_NUM];
+			std::atomic<uint64_t>	metric_gauges[NVILIDAR_METRIC_GAUGE_NUM];
+			LidarHistogram			metric_hists[NVILIDAR_METRIC_HIST_NUM];
+			uint64_t				metric_start_ms;
+	};
+
+	//rolling window of the scan latency,record in the consumer thread(low rate)
+	class NVILIDAR_METRICS_API LidarLatencyWindow
+	{
+		public:
+			LidarLatencyWindow();
+
+			void Record(const NviLidarScanLatency &latency);
+			void Get(LidarLatencyStats &stats);
+			void Reset();
+
+		private:
+			static void Summary(std::vector<uint64_t> &values, LidarLatencySummary &summary);
+
+			std::mutex	latency_mutex;
+			uint64_t	latency_values[4][NVILIDAR_LATENCY_WINDOW];		//decode,filter,handoff,total
+			uint32_t	latency_pos;
+			uint32_t	latency_count;
+	};
+
+	typedef std::function<std::string()> LidarStatsTextProvider;		//make the text to export
+
+	//export the statistics periodically,to a file(write and rename) or "unix:/path"(unix socket,text is sent to every client)
+	class NVILIDAR_METRICS_API LidarMetricsExporter
+	{
+		public:
+			LidarMetricsExporter();
+			~LidarMetricsExporter();
+
+			bool Start(std::string target, uint32_t period_ms, LidarStatsTextProvider provider);
+			void Stop();
+
+		private:
+			void ExportThread();
+			bool WriteFile(const std::string &text);
+			bool OpenSocket();
+			void ServeSocket(const std::string &text, uint32_t wait_ms);
+			void CloseSocket();
+
+			std::thread				export_thread;
+			std::mutex				export_mutex;
+			std::condition_variable	export_cond;
+			bool					export_running;
+			std::string				export_target;
+			bool					export_socket;			//target is unix socket
+			int						export_fd;
+			uint32_t				export_period_ms;
+			LidarStatsTextProvider	export_provider;
+	};
+}
@@ -1,388 +1,645 @@
-#include "nvilidar_process.h"
-#include <list>
-#include <string>
-#include "myconsole.h"
-#include "mytimer.h"
-#include "mystring.h"
-#include <iostream> 
-#include <istream> 
-#include <sstream>
-
-namespace nvilidar
-{
-	LidarProcess::LidarProcess(LidarCommTypeEnum comm, std::string name_ip, uint32_t port_baud)
-	{
-		//communicate type 
-		LidarCommType = comm;
-
-		//lidar para 
-		Nvilidar_UserConfigTypeDef  cfg;
-		//get the default para 
-		LidarDefaultUserConfig(cfg);
-
-		if (USE_SERIALPORT == comm)
-		{
-			cfg.serialport_name = name_ip;		//serialport name 
-			cfg.serialport_baud = port_baud;	//serialport baud  
-
-			lidar_serial.LidarLoadConfig(cfg);	//serialport  
-		}
-		else if (USE_SOCKET == comm)
-		{
-			cfg.ip_addr = name_ip;
-			cfg.lidar_udp_port = port_baud;
-			
-			lidar_udp.LidarLoadConfig(cfg);		//network para  
-			lidar_net_cfg.LidarLoadConfig(cfg);	//network config para   
-		}
-	}
-	LidarProcess::~LidarProcess()
-	{
-
-	}
-
-	//lidar init,for sync para ,get communicate state 
-	bool LidarProcess::LidarInitialialize()
-	{
-		if (USE_SERIALPORT == LidarCommType)
-		{
-			return lidar_serial.LidarInitialialize();
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{
-			return lidar_udp.LidarInitialialize();
-		}
-		return false;
-	}
-
-	//turn on the lidar  
-	bool LidarProcess::LidarTurnOn()
-	{
-		if (USE_SERIALPORT == LidarCommType)
-		{
-			return lidar_serial.LidarTurnOn();
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{
-			return lidar_udp.LidarTurnOn();
-		}
-		return false;
-	}
-
-	//ture off the lidar 
-	bool LidarProcess::LidarTurnOff()
-	{
-		if (USE_SERIALPORT == LidarCommType)
-		{
-			return lidar_serial.LidarTurnOff();
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{
-			return lidar_udp.LidarTurnOff();
-		}
-		return false;
-	}
-
-	//get lidar one circle data   
-	bool LidarProcess::LidarSamplingProcess(LidarScan &scan, uint32_t timeout)
-	{
-		bool ret_state = false;							//return states 
-		bool get_point_state = false;					//get point states 
-		static uint32_t  no_response_times = 0;			//cannot receive data times 
-		static uint32_t  auto_reconnect_times = 0;		//auto reconnect times 
-
-		//get point from serialport or socket 
-		if (USE_SERIALPORT == LidarCommType)
-		{	
-			get_point_state = lidar_serial.LidarSamplingProcess(scan, timeout);
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{	
-			get_point_state = lidar_udp.LidarSamplingProcess(scan, timeout);
-		}
-
-		//get no res times 
-		if(auto_reconnect_flag)			//auto reconnect 
-		{
-			ret_state = true;
-
-			if(get_point_state)
-			{
-				no_response_times = 0;  	
-			}
-			else 
-			{
-				scan.points.clear();		  //clear points
-
-				no_response_times++;
-				if (no_response_times >= 10)  //max 20 seconds 
-				{
-					no_response_times = 0;
-
-					//auto reconnect 
-					bool reconnect = LidarAutoReconnect();
-					if(true == reconnect)
-					{
-						auto_reconnect_times = 0;
-					}
-					else 
-					{
-						auto_reconnect_times ++;
-						nvilidar::console.warning("Auto Reconnect %d......",auto_reconnect_times);
-					}
-				}	
-			}
-		}
-		else 
-		{
-			ret_state = true;	
-
-			if(get_point_state)
-			{
-				no_response_times = 0; 			 
-			}
-			else 
-			{
-				scan.points.clear();		  //clear points 
-
-				no_response_times++;
-				if (no_response_times >= 10)  //max 20 seconds 
-				{
-					ret_state = false;			  //no connect,return false,quit the point state 
-					no_response_times = 0;
-				}		
-			}
-		}
-
-		return ret_state;
-	}
-
-	//quit  
-	void LidarProcess::LidarCloseHandle()
-	{
-		if (USE_SERIALPORT == LidarCommType)
-		{
-			lidar_serial.LidarCloseHandle();
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{
-			lidar_udp.LidarCloseHandle();
-		}
-	}
-
-	//auto reconnect 
-	bool LidarProcess::LidarAutoReconnect()
-	{
-		LidarCloseHandle();			//first,close the connect 
-		delayMS(500);				//delay for thread close 
-		if(false == LidarInitialialize())		//thread init 
-		{
-			return false;
-		}
-		if(false == LidarTurnOn())			//open lidar output point 
-		{
-			return false;
-		}
-		return true;
-	}
-	
-
-	//=========================parameter sync=================================
-
-	//lidar data  sync 
-	void  LidarProcess::LidarParaSync(Nvilidar_UserConfigTypeDef &cfg)
-	{
-		cfg.storePara.samplingRate = (uint32_t)(cfg.sampling_rate * 1000);			// * 1000
-		cfg.storePara.angleOffset = (uint16_t)(cfg.angle_offset * 64 + 0.5);		//角度偏移 	实际与雷达的  64倍 U16 	
-		cfg.storePara.qualityFilterThreshold = (uint16_t)(cfg.quality_threshold);	//quality threshold 
-		cfg.storePara.isHasSensitive = cfg.sensitive;								//是否带有信号质量 
-		cfg.storePara.aimSpeed = (uint16_t)(cfg.aim_speed * 100 + 0.5);				//N Hz 实际与雷达的  100倍 U16 
-		cfg.storePara.tailingLevel = cfg.tailing_level;								//拖尾等级 
-		cfg.storePara.apdValue = cfg.apd_value;										//apd value 
-
-		//ingnore array apart 
-		std::vector<float> elems;
-		std::stringstream ss(cfg.ignore_array_string);
-		std::string number;
-		while (std::getline(ss, number, ',')) {
-			elems.push_back(atof(number.c_str()));
-		}
-		cfg.ignore_array = elems;
-
-		//data to filter 
-		if (cfg.ignore_array.size() % 2)
-		{
-			nvilidar::console.error("ignore array is odd need be even");
-		}
-		for (uint16_t i = 0; i < cfg.ignore_array.size(); i++)
-		{
-			if (cfg.ignore_array[i] < -180.0 && cfg.ignore_array[i] > 180.0)
-			{
-				nvilidar::console.error("ignore array should be between 0 and 360");
-			}
-		}
-
-		//get auto connect state 
-		auto_reconnect_flag = cfg.auto_reconnect;
-	}
-
-	//origin data 
-	void  LidarProcess::LidarDefaultUserConfig(Nvilidar_UserConfigTypeDef &cfg)
-	{
-		//lidar model 
-		cfg.lidar_model_name = NVILIDAR_ROC300;
-		//para to config 
-		cfg.serialport_baud = 921600;
-		cfg.serialport_name = "/dev/nvilidar";
-		cfg.ip_addr = "192.168.1.200";		//192.168.1.200 lidar default ip 
-		cfg.lidar_udp_port = 8100;			//8100 is lidar default port,use udp  
-		cfg.config_tcp_port = 8200;			//8200 is lidar default config para port,use tcp  
-		cfg.frame_id = "laser_frame";
-		cfg.resolution_fixed = false;		//one circle same points  
-		cfg.auto_reconnect = true;			//auto connect  
-		cfg.reversion = false;				//add 180.0 state 
-		cfg.inverted = false;				//mirror 
-		cfg.angle_max = 180.0;
-		cfg.angle_min = -180.0;
-		cfg.range_max = 64.0;
-		cfg.range_min = 0;
-		cfg.aim_speed = 10.0;				//10Hz
-		cfg.sampling_rate = 10;			//10k
-		cfg.sensitive = false;				//default dont't use sensitive 
-		cfg.tailing_level = 20;			//tailing level 
-		cfg.angle_offset_change_flag = false;	//change angle offset flag
-		cfg.angle_offset = 0.0;				//angle offset 
-		cfg.apd_change_flag = false;		//can change apd value,default false
-		cfg.apd_value = 500;				//change apd value 
-		cfg.ignore_array_string = "";		//filter some angle 
-		//filter para 
-		cfg.filter_para.sliding_filter.enable = true;	//lidar filter para --- sliding
-		cfg.filter_para.sliding_filter.jump_threshold = 50;
-		cfg.filter_para.sliding_filter.max_range_flag = false;
-		cfg.filter_para.sliding_filter.max_range = 8000;
-		cfg.filter_para.sliding_filter.window = 3;
-		cfg.filter_para.tail_filter.enable = true;
-		cfg.filter_para.tail_filter.distance_limit_flag = false;
-		cfg.filter_para.tail_filter.distance_limit_value = 8000;
-		cfg.filter_para.tail_filter.level = 8;
-		cfg.filter_para.tail_filter.neighbors = 0;
-
-		//filter(lidar inner)
-		cfg.quality_threshold = 800;
-		cfg.quality_threshold_change_flag = false;
-
-		LidarParaSync(cfg);
-	}
-
-	//==========================get serialport list=======================================
-	std::string LidarProcess::LidarGetSerialList()
-	{
-		std::string port;       
-		std::vector<NvilidarSerialPortInfo> ports = nvilidar::LidarDriverSerialport::getPortList();      
-		std::vector<NvilidarSerialPortInfo>::iterator it;
-
-		//列表信息
-		if (ports.empty())
-		{
-			nvilidar::console.show("Not Lidar was detected.");
-			return port;
-		}
-		else if (1 == ports.size())
-		{
-			it = ports.begin();
-			port = (*it).portName;
-		}
-		else
-		{
-			int id = 0;
-			for (it = ports.begin(); it != ports.end(); it++)
-			{
-				nvilidar::console.show("%d. %s  %s\n", id, it->portName.c_str(), it->description.c_str());
-				id++;
-			}
-			while (1)
-			{
-				nvilidar::console.show("Please select the lidar port:");
-				std::string number;
-				std::cin >> number;
-
-				//参数不合法 
-				if ((size_t)atoi(number.c_str()) >= ports.size())
-				{
-					continue;
-				}
-				//参数配置 
-				it = ports.begin();
-				id = atoi(number.c_str());
-
-				//查找  
-				port = ports.at(id).portName;
-
-				break;
-			}
-		}
-
-		return port;
-	}
-
-	//================================other interface for network=============================================
-	bool LidarProcess::LidarSetNetConfig(std::string ip, std::string gateway, std::string mask)
-	{
-		//建立连接  
-		bool state = lidar_net_cfg.LidarNetConfigConnect();
-		if (false == state)
-		{
-			nvilidar::console.warning("connect to config port error!");
-			return 0;
-		}
-
-		//set ip  
-		//ip = "192.168.1.201";
-		//gateway = "192.168.1.1";
-		//mask = "255.255.255.0";
-		state = lidar_net_cfg.LidarNetConfigWrite(ip, gateway, mask);
-		if (false == state)
-		{
-			nvilidar::console.warning("set ip error!");
-			return false;
-		}
-		delayMS(1000);
-		//read ip address 
-		state = lidar_net_cfg.LidarNetConfigRead(ip, gateway, mask);
-		if (false == state)
-		{
-			nvilidar::console.warning("read ip error!");
-			return false;
-		}
-		nvilidar::console.message("read net para:");
-		nvilidar::console.message("ip:%s, gate:%s, mask:%s", ip.c_str(), gateway.c_str(), mask.c_str());
-
-		//disconnect  
-		lidar_net_cfg.LidarNetConfigDisConnect();
-
-		return true;
-	}
-
-
-
-	//=============================ROS interface,for reload the parameter ===========================================
-	void LidarProcess::LidarReloadPara(Nvilidar_UserConfigTypeDef cfg)
-	{
-		LidarParaSync(cfg);
-
-		if (USE_SERIALPORT == LidarCommType)
-		{
-			lidar_serial.LidarLoadConfig(cfg);	//serialport  
-		}
-		else if (USE_SOCKET == LidarCommType)
-		{		
-			lidar_udp.LidarLoadConfig(cfg);	//network socket  
-			lidar_net_cfg.LidarLoadConfig(cfg);	//config para 
-		}
-	}
-}
-
-
-
-
-
+#include "nvilidar_process.h"
+#include <list>
+#include <string>
+#include "myconsole.h"
+#include "mytimer.h"
+#include "mystring.h"
+#include <iostream> 
+#include <istream> 
+#include <sstream>
+#include <algorithm>
+
+namespace nvilidar
+{
+	LidarProcess::LidarProcess(LidarCommTypeEnum comm, std::string name_ip, uint32_t port_baud)
+	{
+		//communicate type 
+		LidarCommType = comm;
+
+		//lidar para 
+		Nvilidar_UserConfigTypeDef  cfg;
+		//get the default para 
+		LidarDefaultUserConfig(cfg);
+
+		if (USE_SERIALPORT == comm)
+		{
+			cfg.serialport_name = name_ip;		//serialport name 
+			cfg.serialport_baud = port_baud;	//serialport baud  
+
+			lidar_serial.LidarLoadConfig(cfg);	//serialport  
+		}
+		else if (USE_SOCKET == comm)
+		{
+			cfg.ip_addr = name_ip;
+			cfg.lidar_udp_port = port_baud;
+			
+			lidar_udp.LidarLoadConfig(cfg);		//network para  
+			lidar_net_cfg.LidarLoadConfig(cfg);	//network config para   
+		}
+	}
+	LidarProcess::~LidarProcess()
+	{
+
+	}
+
+	//lidar init,for sync para ,get communicate state 
+	bool LidarProcess::LidarInitialialize()
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			return lidar_serial.LidarInitialialize();
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarInitialialize();
+		}
+		return false;
+	}
+
+	//turn on the lidar  
+	bool LidarProcess::LidarTurnOn()
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			return lidar_serial.LidarTurnOn();
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarTurnOn();
+		}
+		return false;
+	}
+
+	//ture off the lidar 
+	bool LidarProcess::LidarTurnOff()
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			return lidar_serial.LidarTurnOff();
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarTurnOff();
+		}
+		return false;
+	}
+
+	//get lidar one circle data   
+	bool LidarProcess::LidarSamplingProcess(LidarScan &scan, uint32_t timeout)
+	{
+		NVILIDAR_TRACE_SCOPE("LidarSamplingProcess");
+		bool ret_state = false;							//return states 
+		bool get_point_state = false;					//get point states 
+
+		//get point from serialport or socket 
+		if (USE_SERIALPORT == LidarCommType)
+		{	
+			get_point_state = lidar_serial.LidarSamplingProcess(scan, timeout);
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{	
+			get_point_state = lidar_udp.LidarSamplingProcess(scan, timeout);
+		}
+
+		//publish to the other processes 
+		if (get_point_state)
+		{
+			shm_publisher.Publish(scan);
+		}
+
+		//get no res times 
+		if(auto_reconnect_flag)			//auto reconnect 
+		{
+			ret_state = true;
+
+			if(get_point_state)
+			{
+				no_response_times = 0;  	
+			}
+			else 
+			{
+				scan.points.clear();		  //clear points
+
+				//the port is open,reconnect is done by the link supervisor in the driver thread 
+				if (LidarIsConnected())
+				{
+					no_response_times = 0;
+					return ret_state;
+				}
+
+				no_response_times++;
+				if (no_response_times >= 10)  //10 circles timeout 
+				{
+					no_response_times = 0;
+
+					//auto reconnect 
+					bool reconnect = LidarAutoReconnect();
+					if(true == reconnect)
+					{
+						auto_reconnect_times = 0;
+					}
+					else 
+					{
+						auto_reconnect_times ++;
+						nvilidar::console.warning("Auto Reconnect %d......",auto_reconnect_times);
+					}
+				}	
+			}
+		}
+		else 
+		{
+			ret_state = true;	
+
+			if(get_point_state)
+			{
+				no_response_times = 0; 			 
+			}
+			else 
+			{
+				scan.points.clear();		  //clear points 
+
+				no_response_times++;
+				if (no_response_times >= 10)  //10 circles timeout 
+				{
+					ret_state = false;			  //no connect,return false,quit the point state 
+					no_response_times = 0;
+				}		
+			}
+		}
+
+		return ret_state;
+	}
+
+	//quit  
+	void LidarProcess::LidarCloseHandle()
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			lidar_serial.LidarCloseHandle();
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			lidar_udp.LidarCloseHandle();
+		}
+	}
+
+	//auto reconnect 
+	bool LidarProcess::LidarAutoReconnect()
+	{
+		LidarCloseHandle();			//first,close the connect 
+		delayMS(500);				//delay for thread close 
+		if(false == LidarInitialialize())		//thread init 
+		{
+			return false;
+		}
+		if(false == LidarTurnOn())			//open lidar output point 
+		{
+			return false;
+		}
+		return true;
+	}
+	
+
+	//=========================parameter sync=================================
+
+	//lidar data  sync 
+	void  LidarProcess::LidarParaSync(Nvilidar_UserConfigTypeDef &cfg)
+	{
+		cfg.storePara.samplingRate = (uint32_t)(cfg.sampling_rate * 1000);			// * 1000
+		cfg.storePara.angleOffset = (uint16_t)(cfg.angle_offset * 64 + 0.5);		//角度偏移 	实际与雷达的  64倍 U16 	
+		cfg.storePara.qualityFilterThreshold = (uint16_t)(cfg.quality_threshold);	//quality threshold 
+		cfg.storePara.isHasSensitive = cfg.sensitive;								//是否带有信号质量 
+		cfg.storePara.aimSpeed = (uint16_t)(cfg.aim_speed * 100 + 0.5);				//N Hz 实际与雷达的  100倍 U16 
+		cfg.storePara.tailingLevel = cfg.tailing_level;								//拖尾等级 
+		cfg.storePara.apdValue = cfg.apd_value;										//apd value 
+
+		//ingnore array apart 
+		std::vector<float> elems;
+		std::stringstream ss(cfg.ignore_array_string);
+		std::string number;
+		while (std::getline(ss, number, ',')) {
+			elems.push_back(atof(number.c_str()));
+		}
+		cfg.ignore_array = elems;
+
+		//data to filter 
+		if (cfg.ignore_array.size() % 2)
+		{
+			nvilidar::console.error("ignore array is odd need be even");
+		}
+		for (uint16_t i = 0; i < cfg.ignore_array.size(); i++)
+		{
+			if (cfg.ignore_array[i] < -180.0 && cfg.ignore_array[i] > 180.0)
+			{
+				nvilidar::console.error("ignore array should be between 0 and 360");
+			}
+		}
+
+		//get auto connect state 
+		auto_reconnect_flag = cfg.auto_reconnect;
+	}
+
+	//origin data 
+	void  LidarProcess::LidarDefaultUserConfig(Nvilidar_UserConfigTypeDef &cfg)
+	{
+		//lidar model 
+		cfg.lidar_model_name = NVILIDAR_ROC300;
+		//para to config 
+		cfg.serialport_baud = 921600;
+		cfg.serialport_name = "/dev/nvilidar";
+		cfg.ip_addr = "192.168.1.200";		//192.168.1.200 lidar default ip 
+		cfg.lidar_udp_port = 8100;			//8100 is lidar default port,use udp  
+		cfg.config_tcp_port = 8200;			//8200 is lidar default config para port,use tcp  
+		cfg.frame_id = "laser_frame";
+		cfg.resolution_fixed = false;		//one circle same points  
+		cfg.auto_reconnect = true;			//auto connect  
+		cfg.stall_circles = 2.0;			//no data for 2 circles,stall event  
+		cfg.reversion = false;				//add 180.0 state 
+		cfg.inverted = false;				//mirror 
+		cfg.angle_max = 180.0;
+		cfg.angle_min = -180.0;
+		cfg.range_max = 64.0;
+		cfg.range_min = 0;
+		cfg.aim_speed = 10.0;				//10Hz
+		cfg.sampling_rate = 10;			//10k
+		cfg.sensitive = false;				//default dont't use sensitive 
+		cfg.tailing_level = 20;			//tailing level 
+		cfg.angle_offset_change_flag = false;	//change angle offset flag
+		cfg.angle_offset = 0.0;				//angle offset 
+		cfg.apd_change_flag = false;		//can change apd value,default false
+		cfg.apd_value = 500;				//change apd value 
+		cfg.ignore_array_string = "";		//filter some angle 
+		//filter para 
+		cfg.filter_para.sliding_filter.enable = true;	//lidar filter para --- sliding
+		cfg.filter_para.sliding_filter.jump_threshold = 50;
+		cfg.filter_para.sliding_filter.max_range_flag = false;
+		cfg.filter_para.sliding_filter.max_range = 8000;
+		cfg.filter_para.sliding_filter.window = 3;
+		cfg.filter_para.tail_filter.enable = true;
+		cfg.filter_para.tail_filter.distance_limit_flag = false;
+		cfg.filter_para.tail_filter.distance_limit_value = 8000;
+		cfg.filter_para.tail_filter.level = 8;
+		cfg.filter_para.tail_filter.neighbors = 0;
+
+		//filter(lidar inner)
+		cfg.quality_threshold = 800;
+		cfg.quality_threshold_change_flag = false;
+
+		LidarParaSync(cfg);
+	}
+
+	//==========================get serialport list=======================================
+	std::string LidarProcess::LidarGetSerialList(std::string match)
+	{
+		std::string port;       
+		std::vector<NvilidarSerialPortInfo> ports;
+		std::vector<NvilidarSerialPortInfo>::iterator it;
+
+		//hardware id filter,not case sensitive 
+		std::vector<NvilidarSerialPortInfo> all_ports = nvilidar::LidarDriverSerialport::getPortList();
+		std::transform(match.begin(), match.end(), match.begin(), ::tolower);
+		for (it = all_ports.begin(); it != all_ports.end(); it++)
+		{
+			std::string hardware_id = it->hardware_id;
+			std::transform(hardware_id.begin(), hardware_id.end(), hardware_id.begin(), ::tolower);
+			if (match.empty() || (hardware_id.find(match) != std::string::npos))
+			{
+				ports.push_back(*it);
+			}
+		}
+
+		//列表信息
+		if (ports.empty())
+		{
+			nvilidar::console.show("Not Lidar was detected.");
+			return port;
+		}
+		else if (1 == ports.size())
+		{
+			it = ports.begin();
+			port = (*it).portName;
+		}
+		else
+		{
+			//no wait for the input,a service may have no stdin 
+			int id = 0;
+			for (it = ports.begin(); it != ports.end(); it++)
+			{
+				nvilidar::console.show("%d. %s  %s  %s\n", id, it->portName.c_str(), it->description.c_str(), it->hardware_id.c_str());
+				id++;
+			}
+			port = ports.front().portName;
+			nvilidar::console.warning("%d serialports,use %s,select one by the hardware id", (int)ports.size(), port.c_str());
+		}
+
+		return port;
+	}
+
+	//==========================reconnect statistics=======================================
+	LidarLinkStats LidarProcess::LidarGetLinkStats()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetLinkStats();
+		}
+		return lidar_serial.LidarGetLinkStats();
+	}
+
+	//stall event 
+	void LidarProcess::LidarSetStallCallback(LidarStallCallback callback)
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			lidar_serial.LidarSetStallCallback(callback);
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			lidar_udp.LidarSetStallCallback(callback);
+		}
+	}
+
+	//package parse statistics 
+	LidarParseStats LidarProcess::LidarGetParseStats()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetParseStats();
+		}
+		return lidar_serial.LidarGetParseStats();
+	}
+
+	//runtime statistics 
+	LidarStats LidarProcess::LidarGetStats()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetStats();
+		}
+		return lidar_serial.LidarGetStats();
+	}
+
+	//rolling latency of the last scans 
+	LidarLatencyStats LidarProcess::LidarGetLatencyStats()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetLatencyStats();
+		}
+		return lidar_serial.LidarGetLatencyStats();
+	}
+
+	//health record event,one record for N circles 
+	void LidarProcess::LidarSetHealthCallback(LidarHealthCallback callback, uint32_t circles)
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			lidar_serial.LidarSetHealthCallback(callback, circles);
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			lidar_udp.LidarSetHealthCallback(callback, circles);
+		}
+	}
+
+	//last health record 
+	bool LidarProcess::LidarGetHealth(NviLidarHealth &health)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetHealth(health);
+		}
+		return lidar_serial.LidarGetHealth(health);
+	}
+
+	//read by a hub thread shared with the other lidars 
+	bool LidarProcess::LidarSetHub(LidarHub *hub)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarSetHub(hub);
+		}
+		return lidar_serial.LidarSetHub(hub);
+	}
+
+	int LidarProcess::LidarGetHubId()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarGetHubId();
+		}
+		return lidar_serial.LidarGetHubId();
+	}
+
+	//cpu/priority/memory lock of the reader thread 
+	bool LidarProcess::LidarSetThreadPara(LidarThreadPara para)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarSetThreadPara(para);
+		}
+		return lidar_serial.LidarSetThreadPara(para);
+	}
+
+	//low latency tuning of the serialport 
+	bool LidarProcess::LidarSetSerialTuning(nvilidar_serial::SerialTuning tuning)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return false;
+		}
+		return lidar_serial.LidarSetSerialTuning(tuning);
+	}
+
+	bool LidarProcess::LidarGetSerialTuning(nvilidar_serial::SerialTuning &tuning)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return false;
+		}
+		tuning = lidar_serial.LidarGetSerialTuning();
+		return true;
+	}
+
+	//hotplug events of the serialport 
+	bool LidarProcess::LidarSetPortDiscovery(LidarPortDiscovery *discovery)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return false;
+		}
+		return lidar_serial.LidarSetPortDiscovery(discovery);
+	}
+
+	//network lidars on one shared udp socket 
+	bool LidarProcess::LidarSetUdpMux(LidarUdpMux *mux)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarSetUdpMux(mux);
+		}
+		return false;
+	}
+
+	//relay the udp stream to the other processes on this host 
+	bool LidarProcess::LidarStartRelay(std::string group, uint16_t port, LidarRelayModeEnum mode, std::string iface, uint8_t ttl)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarStartRelay(group, port, mode, iface, ttl);
+		}
+		return false;
+	}
+
+	void LidarProcess::LidarStopRelay()
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			lidar_udp.LidarStopRelay();
+		}
+	}
+
+	LidarRelayStats LidarProcess::LidarGetRelayStats()
+	{
+		LidarRelayStats stats = {};
+		if (USE_SOCKET == LidarCommType)
+		{
+			stats = lidar_udp.LidarGetRelayStats();
+		}
+		return stats;
+	}
+
+	//export statistics in prometheus text format,to a file or "unix:/path" 
+	bool LidarProcess::LidarStartStatsExport(std::string target, uint32_t period_ms)
+	{
+		bool ret = stats_exporter.Start(target, period_ms, [this]() {
+			return LidarMetrics::FormatPrometheus(LidarGetStats());
+		});
+		if (!ret)
+		{
+			nvilidar::console.warning("stats export to %s failed!", target.c_str());
+		}
+
+		return ret;
+	}
+
+	//stop export 
+	void LidarProcess::LidarStopStatsExport()
+	{
+		stats_exporter.Stop();
+	}
+
+	//publish every scan to the shared memory ring 
+	bool LidarProcess::LidarStartShmPublish(std::string name, uint32_t slots, uint32_t max_points, uint32_t mode)
+	{
+		bool ret = shm_publisher.Create(name, slots, max_points, mode);
+		if (!ret)
+		{
+			nvilidar::console.warning("shared memory %s create failed!", name.c_str());
+		}
+
+		return ret;
+	}
+
+	//stop publish 
+	void LidarProcess::LidarStopShmPublish()
+	{
+		shm_publisher.Close();
+	}
+
+	//is the port open 
+	bool LidarProcess::LidarIsConnected()
+	{
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			return lidar_serial.LidarIsConnected();
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarIsConnected();
+		}
+		return false;
+	}
+
+	//==========================async command=======================================
+	std::shared_future<LidarCommandResult> LidarProcess::LidarCommandAsync(uint8_t cmd, const uint8_t *payload, uint16_t size,
+							LidarCommandCallback callback, uint32_t timeout, uint8_t retries)
+	{
+		if (USE_SOCKET == LidarCommType)
+		{
+			return lidar_udp.LidarCommandAsync(cmd, payload, size, callback, timeout, retries);
+		}
+		return lidar_serial.LidarCommandAsync(cmd, payload, size, callback, timeout, retries);
+	}
+
+	//================================other interface for network=============================================
+	bool LidarProcess::LidarSetNetConfig(std::string ip, std::string gateway, std::string mask)
+	{
+		//建立连接  
+		bool state = lidar_net_cfg.LidarNetConfigConnect();
+		if (false == state)
+		{
+			nvilidar::console.warning("connect to config port error!");
+			return 0;
+		}
+
+		//set ip  
+		//ip = "192.168.1.201";
+		//gateway = "192.168.1.1";
+		//mask = "255.255.255.0";
+		state = lidar_net_cfg.LidarNetConfigWrite(ip, gateway, mask);
+		if (false == state)
+		{
+			nvilidar::console.warning("set ip error!");
+			return false;
+		}
+		delayMS(1000);
+		//read ip address 
+		state = lidar_net_cfg.LidarNetConfigRead(ip, gateway, mask);
+		if (false == state)
+		{
+			nvilidar::console.warning("read ip error!");
+			return false;
+		}
+		nvilidar::console.message("read net para:");
+		nvilidar::console.message("ip:%s, gate:%s, mask:%s", ip.c_str(), gateway.c_str(), mask.c_str());
+
+		//disconnect  
+		lidar_net_cfg.LidarNetConfigDisConnect();
+
+		return true;
+	}
+
+
+
+	//=============================ROS interface,for reload the parameter ===========================================
+	//lidar is running:lidar para is set in one stop/set/save/start cycle,sdk para take effect at next circle 
+	bool LidarProcess::LidarReloadPara(Nvilidar_UserConfigTypeDef cfg)
+	{
+		LidarParaSync(cfg);
+
+		if (USE_SERIALPORT == LidarCommType)
+		{
+			if (lidar_serial.LidarIsConnected())
+			{
+				return lidar_serial.LidarReconfigure(cfg);	//serialport  
+			}
+			lidar_serial.LidarLoadConfig(cfg);	//serialport  
+		}
+		else if (USE_SOCKET == LidarCommType)
+		{		
+			lidar_net_cfg.LidarLoadConfig(cfg);	//config para 
+			if (lidar_udp.LidarIsConnected())
+			{
+				return lidar_udp.LidarReconfigure(cfg);	//network socket  
+			}
+			lidar_udp.LidarLoadConfig(cfg);	//network socket  
+		}
+
+		return true;
+	}
+}
+
+
+
+
+
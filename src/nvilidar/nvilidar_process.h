@@ -1,65 +1,100 @@
-#pragma once
-
-#include "nvilidar_def.h"
-#include "nvilidar_protocol.h"
-#include "serial/nvilidar_serial.h"
-#include <string>
-#include <vector>
-#include <stdint.h>
-#include "myconsole.h"
-#include "mytimer.h"
-
-//serial port 
-#include "serial/nvilidar_serial.h"
-#include "nvilidar_driver_serialport.h"
-#include "socket/nvilidar_socket_udp_win.h"
-#include "nvilidar_driver_udp.h"
-#include "nvilidar_driver_net_config.h"
-
-//---定义库信息 VS系列的生成库文件  
-#ifdef WIN32
-	#define NVILIDAR_API __declspec(dllexport)
-#else
-	#define NVILIDAR_API
-#endif // ifdef WIN32
-
-//communicate type 
-typedef enum
-{
-	USE_SERIALPORT = 1,
-	USE_SOCKET,
-}LidarCommTypeEnum;
-
-namespace nvilidar
-{
-    //lidar driver 
-	class  NVILIDAR_API LidarProcess
-    {
-		public:
-			LidarProcess(LidarCommTypeEnum comm,std::string name_ip,uint32_t port_baud);		//第二个参数，如果为串口则为串口名，网络则为IP地址。第二个参数，如果为串口则为波特率，如果为网络则为端口号 
-			~LidarProcess();
-
-			bool LidarInitialialize();			//雷达初始化 包括读及写参数等等功能 
-			bool LidarSamplingProcess(LidarScan &scan, uint32_t timeout = NVILIDAR_POINT_TIMEOUT);
-			bool LidarTurnOn();					//雷达启动扫描 
-			bool LidarTurnOff();				//雷达停止扫描 
-			void LidarCloseHandle();			//关掉串口及网络  并退出雷达 
-			bool LidarAutoReconnect();			//自动重连 
-
-			//其它接口 有需要可以调用 
-			std::string LidarGetSerialList();	
-			bool LidarSetNetConfig(std::string ip,std::string gateway,std::string mask);			//网络转接板或者带网络雷达参数配置 
-			void LidarReloadPara(Nvilidar_UserConfigTypeDef cfg);
-
-		private:
-			LidarCommTypeEnum		LidarCommType;	//comm type
-			LidarDriverUDP			lidar_udp;		//UDP
-			LidarDriverNetConfig	lidar_net_cfg;	//NET 
-			LidarDriverSerialport	lidar_serial;	//SERIALPORT
-			bool  auto_reconnect_flag = false;		//auto reconnect 
-
-			void LidarParaSync(Nvilidar_UserConfigTypeDef &cfg);		//同步参数信息  主要用于ros 
-			void LidarDefaultUserConfig(Nvilidar_UserConfigTypeDef &cfg);		//获取默认参数  可以在此修改
-
-    };
-}
+#pragma once
+
+#include "nvilidar_def.h"
+#include "nvilidar_protocol.h"
+#include "serial/nvilidar_serial.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#include "myconsole.h"
+#include "mytimer.h"
+
+//serial port 
+#include "serial/nvilidar_serial.h"
+#include "nvilidar_driver_serialport.h"
+#include "nvilidar_discovery.h"
+#include "socket/nvilidar_socket_udp_win.h"
+#include "nvilidar_driver_udp.h"
+#include "nvilidar_driver_net_config.h"
+#include "nvilidar_shm.h"
+
+//---定义库信息 VS系列的生成库文件  
+#ifdef WIN32
+	#define NVILIDAR_API __declspec(dllexport)
+#else
+	#define NVILIDAR_API
+#endif // ifdef WIN32
+
+//communicate type 
+typedef enum
+{
+	USE_SERIALPORT = 1,
+	USE_SOCKET,
+}LidarCommTypeEnum;
+
+namespace nvilidar
+{
+    //lidar driver 
+	class  NVILIDAR_API LidarProcess
+    {
+		public:
+			LidarProcess(LidarCommTypeEnum comm,std::string name_ip,uint32_t port_baud);		//第二个参数，如果为串口则为串口名，网络则为IP地址。第二个参数，如果为串口则为波特率，如果为网络则为端口号 
+			~LidarProcess();
+
+			bool LidarInitialialize();			//雷达初始化 包括读及写参数等等功能 
+			bool LidarSamplingProcess(LidarScan &scan, uint32_t timeout = NVILIDAR_POINT_TIMEOUT);
+			bool LidarTurnOn();					//雷达启动扫描 
+			bool LidarTurnOff();				//雷达停止扫描 
+			void LidarCloseHandle();			//关掉串口及网络  并退出雷达 
+			bool LidarAutoReconnect();			//自动重连 
+
+			//其它接口 有需要可以调用 
+			std::string LidarGetSerialList(std::string match = "");	//usb串口 match:hardware_id的一部分 如"VID:PID=10c4:ea60" 多个时返回第一个 不等待输入	
+			bool LidarSetNetConfig(std::string ip,std::string gateway,std::string mask);			//网络转接板或者带网络雷达参数配置 
+			bool LidarReloadPara(Nvilidar_UserConfigTypeDef cfg);			//重载参数 运行中也可以调用 
+			std::shared_future<LidarCommandResult> LidarCommandAsync(uint8_t cmd, const uint8_t *payload = NULL, uint16_t size = 0,	//async command,for config tools 
+												LidarCommandCallback callback = nullptr,
+												uint32_t timeout = NVILIDAR_DEFAULT_TIMEOUT,
+												uint8_t retries = NVILIDAR_DEFAULT_RETRY);
+			LidarLinkStats LidarGetLinkStats();		//自动重连统计 重连次数及耗时 
+			void LidarSetStallCallback(LidarStallCallback callback);	//数据中断事件 N圈无数据时在驱动线程中回调 
+			LidarParseStats LidarGetParseStats();	//解包统计 丢弃字节数及重新同步找回的包数 
+			LidarStats LidarGetStats();				//运行统计 计数/每圈点数/各阶段耗时分布 
+			LidarLatencyStats LidarGetLatencyStats();	//最近若干圈的延时统计 p50/p99/max 
+			void LidarSetHealthCallback(LidarHealthCallback callback, uint32_t circles = NVILIDAR_HEALTH_CIRCLES);	//健康记录事件 每N圈一条 转速/温度/校验错误率 
+			bool LidarGetHealth(NviLidarHealth &health);	//最近一条健康记录 
+			bool LidarStartStatsExport(std::string target, uint32_t period_ms = NVILIDAR_STATS_EXPORT_PERIOD);	//定时输出统计(prometheus格式) 到文件或"unix:/path" 
+			void LidarStopStatsExport();			//停止输出统计 
+			bool LidarStartShmPublish(std::string name = NVILIDAR_SHM_NAME, uint32_t slots = NVILIDAR_SHM_SLOTS,	//每圈点云写入共享内存 供其它进程读取(LidarShmReader) 
+									uint32_t max_points = NVILIDAR_SHM_MAX_POINTS, uint32_t mode = NVILIDAR_SHM_MODE);
+			void LidarStopShmPublish();				//停止共享内存发布 
+			bool LidarSetHub(LidarHub *hub);		//多雷达共用一个读线程(LidarHub) 在LidarInitialialize之前调用 NULL:使用自己的线程 
+			int LidarGetHubId();					//在hub中的id LidarHub::Wait返回的id -1:未加入 
+			bool LidarSetThreadPara(LidarThreadPara para);	//读线程的cpu绑定/实时优先级/内存锁定 在LidarInitialialize之前调用 hub模式用LidarHub::SetThreadPara 
+			bool LidarSetSerialTuning(nvilidar_serial::SerialTuning tuning);	//串口低延时设置 low_latency/VMIN/VTIME/接收缓冲 在LidarInitialialize之前调用 网络雷达返回false 
+			bool LidarGetSerialTuning(nvilidar_serial::SerialTuning &tuning);	//串口实际生效的设置 含usb串口latency_timer 
+			bool LidarSetPortDiscovery(LidarPortDiscovery *discovery);	//串口热插拔事件 拔出/插入后立即重连 在LidarInitialialize之前调用 网络雷达返回false 
+			bool LidarSetUdpMux(LidarUdpMux *mux);	//多个网络雷达共用一个udp端口 在LidarInitialialize之前调用 雷达加入mux的LidarHub NULL:使用自己的socket 串口雷达返回false 
+			bool LidarStartRelay(std::string group, uint16_t port, LidarRelayModeEnum mode,	//组播转发原始包或一圈点云 给本机其它进程 串口雷达返回false 
+								std::string iface = NVILIDAR_RELAY_IFACE, uint8_t ttl = 0);
+			void LidarStopRelay();
+			LidarRelayStats LidarGetRelayStats();
+
+		private:
+			LidarCommTypeEnum		LidarCommType;	//comm type
+			LidarDriverUDP			lidar_udp;		//UDP
+			LidarDriverNetConfig	lidar_net_cfg;	//NET 
+			LidarDriverSerialport	lidar_serial;	//SERIALPORT
+			std::atomic<bool>  auto_reconnect_flag{false};		//auto reconnect,changed by LidarReloadPara 
+			uint32_t  no_response_times = 0;		//cannot receive data times 
+			uint32_t  auto_reconnect_times = 0;		//auto reconnect times 
+			LidarMetricsExporter	stats_exporter;	//statistics export,destroy before the drivers 
+			LidarShmPublisher		shm_publisher;	//scans to the shared memory 
+
+			bool LidarIsConnected();			//串口或网络是否打开 
+			void LidarParaSync(Nvilidar_UserConfigTypeDef &cfg);		//同步参数信息  主要用于ros 
+			void LidarDefaultUserConfig(Nvilidar_UserConfigTypeDef &cfg);		//获取默认参数  可以在此修改
+
+    };
+}
@@ -0,0 +1,873 @@
+#include "nvilidar_record.h"
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#ifndef M_PI
+	#define M_PI 3.14159265358979323846
+#endif
+
+#define NVILIDAR_LZ_HASH_BITS		12
+#define NVILIDAR_LZ_MIN_MATCH		4
+#define NVILIDAR_LZ_MAX_OFFSET		65535
+
+namespace nvilidar
+{
+	//==========================varint=======================================
+	static void PutVarint(std::vector<uint8_t> &out, uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((uint8_t)value);
+	}
+
+	static void PutZigzag(std::vector<uint8_t> &out, int32_t value)
+	{
+		PutVarint(out, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+	}
+
+	static bool GetVarint(const uint8_t *&pos, const uint8_t *end, uint32_t &value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 35; shift += 7)
+		{
+			if (pos >= end)
+			{
+				return false;
+			}
+			uint8_t byte = *pos++;
+			value |= (uint32_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool GetZigzag(const uint8_t *&pos, const uint8_t *end, int32_t &value)
+	{
+		uint32_t raw = 0;
+		if (!GetVarint(pos, end, raw))
+		{
+			return false;
+		}
+		value = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+		return true;
+	}
+
+	//==========================lz(lz4 like block)=======================================
+	//sequence: token(literal length<<4 | match length-4),literals,offset(2 bytes),length over 15 in more bytes
+	static void LzPutLength(std::vector<uint8_t> &out, size_t length)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back((uint8_t)length);
+	}
+
+	static void LzPutSequence(std::vector<uint8_t> &out, const uint8_t *literal, size_t literal_len, size_t offset, size_t match_len)
+	{
+		size_t match_code = (match_len >= NVILIDAR_LZ_MIN_MATCH) ? (match_len - NVILIDAR_LZ_MIN_MATCH) : 0;
+
+		out.push_back((uint8_t)(((literal_len < 15) ? literal_len : 15) << 4 | ((match_code < 15) ? match_code : 15)));
+		if (literal_len >= 15)
+		{
+			LzPutLength(out, literal_len - 15);
+		}
+		out.insert(out.end(), literal, literal + literal_len);
+		if (match_len == 0)
+		{
+			return;			//last sequence
+		}
+		out.push_back((uint8_t)(offset & 0xFF));
+		out.push_back((uint8_t)(offset >> 8));
+		if (match_code >= 15)
+		{
+			LzPutLength(out, match_code - 15);
+		}
+	}
+
+	static uint32_t LzRead32(const uint8_t *ptr)
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+
+	//compress src,append to out
+	static void LzCompress(const uint8_t *src, size_t len, std::vector<uint8_t> &out)
+	{
+		uint32_t table[1 << NVILIDAR_LZ_HASH_BITS];		//position + 1,0:empty
+		size_t ip = 0;
+		size_t anchor = 0;
+
+		memset(table, 0x00, sizeof(table));
+		while (ip + NVILIDAR_LZ_MIN_MATCH <= len)
+		{
+			uint32_t sequence = LzRead32(src + ip);
+			uint32_t hash = (sequence * 2654435761U) >> (32 - NVILIDAR_LZ_HASH_BITS);
+			size_t ref = table[hash];
+
+			table[hash] = (uint32_t)(ip + 1);
+			if ((ref == 0) || (ip - (ref - 1) > NVILIDAR_LZ_MAX_OFFSET) || (LzRead32(src + ref - 1) != sequence))
+			{
+				ip++;
+				continue;
+			}
+			ref -= 1;
+
+			size_t match_len = NVILIDAR_LZ_MIN_MATCH;
+			while ((ip + match_len < len) && (src[ref + match_len] == src[ip + match_len]))
+			{
+				match_len++;
+			}
+			LzPutSequence(out, src + anchor, ip - anchor, ip - ref, match_len);
+			ip += match_len;
+			anchor = ip;
+		}
+		LzPutSequence(out, src + anchor, len - anchor, 0, 0);
+	}
+
+	static bool LzGetLength(const uint8_t *&pos, const uint8_t *end, size_t &length)
+	{
+		uint8_t byte = 255;
+		while (byte == 255)
+		{
+			if (pos >= end)
+			{
+				return false;
+			}
+			byte = *pos++;
+			length += byte;
+		}
+		return true;
+	}
+
+	//decompress to dst,the size must be dst_len
+	static bool LzDecompress(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len)
+	{
+		const uint8_t *pos = src;
+		const uint8_t *end = src + len;
+		size_t op = 0;
+
+		while (pos < end)
+		{
+			uint8_t token = *pos++;
+			size_t literal_len = token >> 4;
+			if ((literal_len == 15) && (!LzGetLength(pos, end, literal_len)))
+			{
+				return false;
+			}
+			if ((literal_len > (size_t)(end - pos)) || (literal_len > dst_len - op))
+			{
+				return false;
+			}
+			memcpy(dst + op, pos, literal_len);
+			pos += literal_len;
+			op += literal_len;
+			if (pos == end)
+			{
+				break;			//last sequence
+			}
+
+			if (end - pos < 2)
+			{
+				return false;
+			}
+			size_t offset = pos[0] | ((size_t)pos[1] << 8);
+			pos += 2;
+			size_t match_len = token & 0x0F;
+			if ((match_len == 15) && (!LzGetLength(pos, end, match_len)))
+			{
+				return false;
+			}
+			match_len += NVILIDAR_LZ_MIN_MATCH;
+			if ((offset == 0) || (offset > op) || (match_len > dst_len - op))
+			{
+				return false;
+			}
+			//overlap copy,byte by byte
+			for (size_t i = 0; i < match_len; i++)
+			{
+				dst[op + i] = dst[op - offset + i];
+			}
+			op += match_len;
+		}
+
+		return (op == dst_len);
+	}
+
+	//==========================codec=======================================
+	bool LidarRecordCodec::Encode(const LidarScan &scan, const uint32_t *point_time_us, uint32_t flags, std::vector<uint8_t> &out)
+	{
+		static thread_local std::vector<uint8_t> payload;		//raw payload,kept for the next scan
+		uint32_t count = (uint32_t)scan.points.size();
+
+		if (count > NVILIDAR_RECORD_MAX_POINTS)
+		{
+			return false;
+		}
+		if (point_time_us == NULL)
+		{
+			flags &= ~NVILIDAR_RECORD_FLAG_TIME;
+		}
+		payload.clear();
+		payload.reserve(sizeof(NviLidarConfig) + 16 + count * 5);
+
+		//config and gap info
+		const uint8_t *config = (const uint8_t *)&scan.config;
+		payload.insert(payload.end(), config, config + sizeof(NviLidarConfig));
+		payload.push_back(scan.info.zero_lost ? 1 : 0);
+		PutVarint(payload, scan.info.gap_count);
+		PutVarint(payload, scan.info.missing_packages);
+		PutVarint(payload, scan.info.missing_points);
+
+		//angle x64 degree(raw resolution of the lidar)
+		int32_t last = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			int32_t angle = (int32_t)floor(scan.points[i].angle * 180.0 / M_PI * NVILIDAR_ANGULDAR_RESOLUTION + 0.5);
+			PutZigzag(payload, angle - last);
+			last = angle;
+		}
+		//distance mm
+		last = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			int32_t distance = (int32_t)(scan.points[i].range * 1000.0f + 0.5f);
+			PutZigzag(payload, distance - last);
+			last = distance;
+		}
+		//intensity
+		if (flags & NVILIDAR_RECORD_FLAG_INTENSITY)
+		{
+			last = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				int32_t intensity = (int32_t)(scan.points[i].intensity + 0.5f);
+				PutZigzag(payload, intensity - last);
+				last = intensity;
+			}
+		}
+		//point time
+		if (flags & NVILIDAR_RECORD_FLAG_TIME)
+		{
+			uint32_t last_time = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				PutZigzag(payload, (int32_t)(point_time_us[i] - last_time));
+				last_time = point_time_us[i];
+			}
+		}
+
+		//header,then the payload(compressed if it is smaller)
+		LidarRecordHeader header;
+		size_t header_pos = out.size();
+
+		header.magic = NVILIDAR_RECORD_MAGIC;
+		header.flags = flags & ~NVILIDAR_RECORD_FLAG_COMPRESS;
+		header.raw_size = (uint32_t)payload.size();
+		header.point_count = count;
+		header.reserved = 0;
+		header.stamp = scan.stamp;
+		out.resize(header_pos + sizeof(LidarRecordHeader));
+		if (flags & NVILIDAR_RECORD_FLAG_COMPRESS)
+		{
+			LzCompress(payload.data(), payload.size(), out);
+			if (out.size() - header_pos - sizeof(LidarRecordHeader) < payload.size())
+			{
+				header.flags |= NVILIDAR_RECORD_FLAG_COMPRESS;
+			}
+			else
+			{
+				out.resize(header_pos + sizeof(LidarRecordHeader));
+			}
+		}
+		if ((header.flags & NVILIDAR_RECORD_FLAG_COMPRESS) == 0)
+		{
+			out.insert(out.end(), payload.begin(), payload.end());
+		}
+		header.payload_size = (uint32_t)(out.size() - header_pos - sizeof(LidarRecordHeader));
+		memcpy(out.data() + header_pos, &header, sizeof(header));
+
+		return true;
+	}
+
+	size_t LidarRecordCodec::RecordSize(const uint8_t *data, size_t avail)
+	{
+		LidarRecordHeader header;
+
+		if (avail < sizeof(LidarRecordHeader))
+		{
+			return 0;
+		}
+		memcpy(&header, data, sizeof(header));
+		if ((header.magic != NVILIDAR_RECORD_MAGIC) || (header.point_count > NVILIDAR_RECORD_MAX_POINTS))
+		{
+			return 0;
+		}
+		if (header.payload_size > avail - sizeof(LidarRecordHeader))
+		{
+			return 0;
+		}
+		return sizeof(LidarRecordHeader) + header.payload_size;
+	}
+
+	bool LidarRecordCodec::Decode(const uint8_t *data, size_t size, LidarScan &scan, std::vector<uint32_t> *point_time_us)
+	{
+		LidarRecordHeader header;
+		static thread_local std::vector<uint8_t> raw;		//decompress buffer,kept for the next record
+
+		if (RecordSize(data, size) == 0)
+		{
+			return false;
+		}
+		memcpy(&header, data, sizeof(header));
+
+		const uint8_t *pos = data + sizeof(LidarRecordHeader);
+		const uint8_t *end = pos + header.payload_size;
+		if (header.flags & NVILIDAR_RECORD_FLAG_COMPRESS)
+		{
+			//the payload is not more than 5 bytes a varint for 4 columns
+			if (header.raw_size > sizeof(NviLidarConfig) + 16 + (size_t)header.point_count * 20)
+			{
+				return false;
+			}
+			raw.resize(header.raw_size);
+			if (!LzDecompress(pos, header.payload_size, raw.data(), raw.size()))
+			{
+				return false;
+			}
+			pos = raw.data();
+			end = pos + raw.size();
+		}
+
+		//config and gap info
+		if ((size_t)(end - pos) < sizeof(NviLidarConfig) + 1)
+		{
+			return false;
+		}
+		memcpy(&scan.config, pos, sizeof(NviLidarConfig));
+		pos += sizeof(NviLidarConfig);
+		scan.info.zero_lost = (*pos++ != 0);
+		if (!GetVarint(pos, end, scan.info.gap_count) ||
+			!GetVarint(pos, end, scan.info.missing_packages) ||
+			!GetVarint(pos, end, scan.info.missing_points))
+		{
+			return false;
+		}
+		scan.stamp = header.stamp;
+		memset(&scan.latency, 0x00, sizeof(scan.latency));
+		scan.points.resize(header.point_count);
+
+		//columns
+		int32_t last = 0;
+		int32_t delta = 0;
+		for (uint32_t i = 0; i < header.point_count; i++)
+		{
+			if (!GetZigzag(pos, end, delta))
+			{
+				return false;
+			}
+			last += delta;
+			scan.points[i].angle = (float)(last * M_PI / 180.0 / NVILIDAR_ANGULDAR_RESOLUTION);
+		}
+		last = 0;
+		for (uint32_t i = 0; i < header.point_count; i++)
+		{
+			if (!GetZigzag(pos, end, delta))
+			{
+				return false;
+			}
+			last += delta;
+			scan.points[i].range = last / 1000.0f;
+		}
+		last = 0;
+		for (uint32_t i = 0; i < header.point_count; i++)
+		{
+			if (header.flags & NVILIDAR_RECORD_FLAG_INTENSITY)
+			{
+				if (!GetZigzag(pos, end, delta))
+				{
+					return false;
+				}
+				last += delta;
+			}
+			scan.points[i].intensity = (float)last;
+		}
+		if (point_time_us != NULL)
+		{
+			point_time_us->clear();
+		}
+		if (header.flags & NVILIDAR_RECORD_FLAG_TIME)
+		{
+			uint32_t time = 0;
+			for (uint32_t i = 0; i < header.point_count; i++)
+			{
+				if (!GetZigzag(pos, end, delta))
+				{
+					return false;
+				}
+				time += (uint32_t)delta;
+				if (point_time_us != NULL)
+				{
+					point_time_us->push_back(time);
+				}
+			}
+		}
+		return true;
+	}
+
+	//==========================writer=======================================
+	LidarRecordWriter::LidarRecordWriter()
+	{
+		record_file = NULL;
+		record_flags = 0;
+		record_bytes = 0;
+	}
+
+	LidarRecordWriter::~LidarRecordWriter()
+	{
+		Close();
+	}
+
+	bool LidarRecordWriter::Open(std::string path, uint32_t flags)
+	{
+		LidarRecordFileHeader header;
+
+		Close();
+		record_file = fopen(path.c_str(), "wb");
+		if (record_file == NULL)
+		{
+			return false;
+		}
+
+		header.magic = NVILIDAR_RECORD_FILE_MAGIC;
+		header.version = NVILIDAR_RECORD_VERSION;
+		header.header_size = sizeof(LidarRecordFileHeader);
+		header.flags = flags;
+		header.reserved = 0;
+		if (fwrite(&header, sizeof(header), 1, record_file) != 1)
+		{
+			Close();
+			return false;
+		}
+		record_flags = flags;
+		record_bytes = sizeof(header);
+
+		return true;
+	}
+
+	//encode to the buffer and write,the buffer keeps the size of the largest scan
+	bool LidarRecordWriter::Write(const LidarScan &scan, const uint32_t *point_time_us)
+	{
+		if (record_file == NULL)
+		{
+			return false;
+		}
+
+		record_buffer.clear();
+		if (!LidarRecordCodec::Encode(scan, point_time_us, record_flags, record_buffer))
+		{
+			return false;
+		}
+		if (fwrite(record_buffer.data(), 1, record_buffer.size(), record_file) != record_buffer.size())
+		{
+			return false;
+		}
+		record_bytes += record_buffer.size();
+
+		return true;
+	}
+
+	void LidarRecordWriter::Flush()
+	{
+		if (record_file != NULL)
+		{
+			fflush(record_file);
+		}
+	}
+
+	void LidarRecordWriter::Close()
+	{
+		if (record_file != NULL)
+		{
+			fclose(record_file);
+			record_file = NULL;
+		}
+	}
+
+	bool LidarRecordWriter::IsOpen()
+	{
+		return (record_file != NULL);
+	}
+
+	uint64_t LidarRecordWriter::GetBytes()
+	{
+		return record_bytes;
+	}
+
+	//==========================reader=======================================
+	LidarRecordReader::LidarRecordReader()
+	{
+		record_file = NULL;
+		record_flags = 0;
+	}
+
+	LidarRecordReader::~LidarRecordReader()
+	{
+		Close();
+	}
+
+	bool LidarRecordReader::Open(std::string path)
+	{
+		LidarRecordFileHeader header;
+
+		Close();
+		record_file = fopen(path.c_str(), "rb");
+		if (record_file == NULL)
+		{
+			return false;
+		}
+		if ((fread(&header, sizeof(header), 1, record_file) != 1) ||
+			(header.magic != NVILIDAR_RECORD_FILE_MAGIC) ||
+			(header.version != NVILIDAR_RECORD_VERSION) ||
+			(header.header_size < sizeof(LidarRecordFileHeader)))
+		{
+			Close();
+			return false;
+		}
+		fseek(record_file, header.header_size, SEEK_SET);
+		record_flags = header.flags;
+
+		return true;
+	}
+
+	//next record
+	bool LidarRecordReader::Read(LidarScan &scan, std::vector<uint32_t> *point_time_us)
+	{
+		LidarRecordHeader header;
+
+		if (record_file == NULL)
+		{
+			return false;
+		}
+		if (fread(&header, sizeof(header), 1, record_file) != 1)
+		{
+			return false;
+		}
+		if ((header.magic != NVILIDAR_RECORD_MAGIC) || (header.point_count > NVILIDAR_RECORD_MAX_POINTS) ||
+			(header.payload_size > sizeof(NviLidarConfig) + 16 + (size_t)header.point_count * 20))
+		{
+			return false;
+		}
+
+		record_buffer.resize(sizeof(header) + header.payload_size);
+		memcpy(record_buffer.data(), &header, sizeof(header));
+		if (fread(record_buffer.data() + sizeof(header), 1, header.payload_size, record_file) != header.payload_size)
+		{
+			return false;
+		}
+
+		return LidarRecordCodec::Decode(record_buffer.data(), record_buffer.size(), scan, point_time_us);
+	}
+
+	void LidarRecordReader::Close()
+	{
+		if (record_file != NULL)
+		{
+			fclose(record_file);
+			record_file = NULL;
+		}
+	}
+
+	uint32_t LidarRecordReader::GetFlags()
+	{
+		return record_flags;
+	}
+
+	//==========================mapped file=======================================
+	static bool IndexLess(const LidarRecordIndexEntry &a, const LidarRecordIndexEntry &b)
+	{
+		return (a.stamp < b.stamp) || ((a.stamp == b.stamp) && (a.offset < b.offset));
+	}
+
+	LidarRecordFile::LidarRecordFile()
+	{
+		file_base = NULL;
+		file_size = 0;
+	#if defined(_WIN32)
+		file_handle = INVALID_HANDLE_VALUE;
+		file_mapping = NULL;
+	#endif
+	}
+
+	LidarRecordFile::~LidarRecordFile()
+	{
+		Close();
+	}
+
+	bool LidarRecordFile::Open(std::string path, bool save_index)
+	{
+		Close();
+
+	#if defined(_WIN32)
+		file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file_handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER size;
+		if ((!GetFileSizeEx(file_handle, &size)) || (size.QuadPart < (LONGLONG)sizeof(LidarRecordFileHeader)))
+		{
+			Close();
+			return false;
+		}
+		file_mapping = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (file_mapping == NULL)
+		{
+			Close();
+			return false;
+		}
+		file_base = (const uint8_t *)MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (file_base == NULL)
+		{
+			Close();
+			return false;
+		}
+		file_size = (size_t)size.QuadPart;
+	#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat st;
+		if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(LidarRecordFileHeader)))
+		{
+			close(fd);
+			return false;
+		}
+		void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (base == MAP_FAILED)
+		{
+			return false;
+		}
+		madvise(base, st.st_size, MADV_SEQUENTIAL);
+		file_base = (const uint8_t *)base;
+		file_size = st.st_size;
+	#endif
+
+		//file header
+		LidarRecordFileHeader header;
+		memcpy(&header, file_base, sizeof(header));
+		if ((header.magic != NVILIDAR_RECORD_FILE_MAGIC) || (header.version != NVILIDAR_RECORD_VERSION) ||
+			(header.header_size < sizeof(LidarRecordFileHeader)) || (header.header_size > file_size))
+		{
+			Close();
+			return false;
+		}
+
+		//index
+		std::string index_path = path + NVILIDAR_RECORD_INDEX_SUFFIX;
+		if (!LoadIndex(index_path))
+		{
+			BuildIndex();
+			if (save_index)
+			{
+				SaveIndex(index_path);
+			}
+		}
+
+		return true;
+	}
+
+	void LidarRecordFile::Close()
+	{
+	#if defined(_WIN32)
+		if (file_base != NULL)
+		{
+			UnmapViewOfFile(file_base);
+		}
+		if (file_mapping != NULL)
+		{
+			CloseHandle(file_mapping);
+			file_mapping = NULL;
+		}
+		if (file_handle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file_handle);
+			file_handle = INVALID_HANDLE_VALUE;
+		}
+	#else
+		if (file_base != NULL)
+		{
+			munmap((void *)file_base, file_size);
+		}
+	#endif
+		file_base = NULL;
+		file_size = 0;
+		file_index.clear();
+	}
+
+	//load the sidecar index,false if it is not for this file
+	bool LidarRecordFile::LoadIndex(std::string path)
+	{
+		FILE *fp = fopen(path.c_str(), "rb");
+		LidarRecordIndexHeader header;
+
+		if (fp == NULL)
+		{
+			return false;
+		}
+		if ((fread(&header, sizeof(header), 1, fp) != 1) ||
+			(header.magic != NVILIDAR_RECORD_INDEX_MAGIC) ||
+			(header.version != NVILIDAR_RECORD_VERSION) ||
+			(header.entry_size != sizeof(LidarRecordIndexEntry)) ||
+			(header.file_size != file_size) ||
+			(header.count > file_size / sizeof(LidarRecordHeader)))
+		{
+			fclose(fp);
+			return false;
+		}
+		file_index.resize((size_t)header.count);
+		bool ret = (header.count == 0) ||
+					(fread(file_index.data(), sizeof(LidarRecordIndexEntry), file_index.size(), fp) == file_index.size());
+		fclose(fp);
+
+		//entries must point to a record
+		for (size_t i = 0; ret && (i < file_index.size()); i++)
+		{
+			if ((file_index[i].offset >= file_size) ||
+				(LidarRecordCodec::RecordSize(file_base + file_index[i].offset, file_size - file_index[i].offset) == 0))
+			{
+				ret = false;
+			}
+		}
+		if (!ret)
+		{
+			file_index.clear();
+		}
+		return ret;
+	}
+
+	//walk the record headers,stop at a bad or half written record
+	void LidarRecordFile::BuildIndex()
+	{
+		LidarRecordFileHeader header;
+		memcpy(&header, file_base, sizeof(header));
+
+		size_t offset = header.header_size;
+		file_index.clear();
+		while (offset < file_size)
+		{
+			size_t size = LidarRecordCodec::RecordSize(file_base + offset, file_size - offset);
+			if (size == 0)
+			{
+				break;
+			}
+
+			LidarRecordIndexEntry entry;
+			memcpy(&entry.stamp, file_base + offset + offsetof(LidarRecordHeader, stamp), sizeof(entry.stamp));
+			entry.offset = offset;
+			file_index.push_back(entry);
+			offset += size;
+		}
+		std::stable_sort(file_index.begin(), file_index.end(), IndexLess);
+	}
+
+	//write to a temp file and rename
+	bool LidarRecordFile::SaveIndex(std::string path)
+	{
+		std::string temp = path + ".tmp";
+		FILE *fp = fopen(temp.c_str(), "wb");
+		LidarRecordIndexHeader header;
+
+		if (fp == NULL)
+		{
+			return false;
+		}
+		header.magic = NVILIDAR_RECORD_INDEX_MAGIC;
+		header.version = NVILIDAR_RECORD_VERSION;
+		header.entry_size = sizeof(LidarRecordIndexEntry);
+		header.file_size = file_size;
+		header.count = file_index.size();
+
+		bool ret = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+					((file_index.size() == 0) ||
+					(fwrite(file_index.data(), sizeof(LidarRecordIndexEntry), file_index.size(), fp) == file_index.size()));
+		fclose(fp);
+		if (!ret)
+		{
+			remove(temp.c_str());
+			return false;
+		}
+
+	#if defined(_WIN32)
+		remove(path.c_str());
+	#endif
+		return (rename(temp.c_str(), path.c_str()) == 0);
+	}
+
+	size_t LidarRecordFile::Count()
+	{
+		return file_index.size();
+	}
+
+	bool LidarRecordFile::Get(size_t index, LidarRecordView &view)
+	{
+		if (index >= file_index.size())
+		{
+			return false;
+		}
+
+		uint64_t offset = file_index[index].offset;
+		view.data = file_base + offset;
+		view.size = LidarRecordCodec::RecordSize(view.data, file_size - offset);
+		view.header = (const LidarRecordHeader *)view.data;
+		view.offset = offset;
+
+		return (view.size != 0);
+	}
+
+	//binary search in the index
+	size_t LidarRecordFile::Seek(uint64_t stamp)
+	{
+		LidarRecordIndexEntry key;
+		key.stamp = stamp;
+		key.offset = 0;
+
+		return std::lower_bound(file_index.begin(), file_index.end(), key, IndexLess) - file_index.begin();
+	}
+
+	uint64_t LidarRecordFile::GetFirstStamp()
+	{
+		return file_index.empty() ? 0 : file_index.front().stamp;
+	}
+
+	uint64_t LidarRecordFile::GetLastStamp()
+	{
+		return file_index.empty() ? 0 : file_index.back().stamp;
+	}
+
+	//decode the points,the vectors of scan are reused
+	bool LidarRecordFile::Decode(const LidarRecordView &view, LidarScan &scan, std::vector<uint32_t> *point_time_us)
+	{
+		return LidarRecordCodec::Decode(view.data, view.size, scan, point_time_us);
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_RECORD_API __declspec(dllexport)
+#else
+	#define NVILIDAR_RECORD_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_RECORD_FILE_MAGIC		0x4653564E		//'NVSF'
+#define NVILIDAR_RECORD_MAGIC			0x5253564E		//'NVSR'
+#define NVILIDAR_RECORD_VERSION			1
+#define NVILIDAR_RECORD_MAX_POINTS		65536			//points of one scan,a bad record is not decoded
+#define NVILIDAR_RECORD_INDEX_MAGIC		0x4953564E		//'NVSI'
+#define NVILIDAR_RECORD_INDEX_SUFFIX	".idx"			//sidecar index file
+
+//columns and compression
+#define NVILIDAR_RECORD_FLAG_INTENSITY	0x01			//intensity column
+#define NVILIDAR_RECORD_FLAG_TIME		0x02			//per point time column(us from the scan stamp)
+#define NVILIDAR_RECORD_FLAG_COMPRESS	0x04			//lz compressed payload
+
+#pragma pack(push)
+#pragma pack(1)
+
+//file header
+struct LidarRecordFileHeader
+{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	header_size;		//sizeof(LidarRecordFileHeader)
+	uint32_t	flags;				//flags of the writer
+	uint32_t	reserved;
+};
+
+//scan record header,payload follows
+struct LidarRecordHeader
+{
+	uint32_t	magic;
+	uint32_t	flags;				//flags of this record
+	uint32_t	payload_size;		//bytes in the file
+	uint32_t	raw_size;			//bytes after decompress
+	uint32_t	point_count;
+	uint32_t	reserved;
+	uint64_t	stamp;				//scan stamp(ns),read without decode
+};
+
+//sidecar index header,entries follow
+struct LidarRecordIndexHeader
+{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	entry_size;			//sizeof(LidarRecordIndexEntry)
+	uint64_t	file_size;			//size of the record file when the index is built
+	uint64_t	count;				//entries
+};
+
+//index entry,sorted by stamp
+struct LidarRecordIndexEntry
+{
+	uint64_t	stamp;
+	uint64_t	offset;				//record offset in the file
+};
+
+#pragma pack(pop)
+
+namespace nvilidar
+{
+	//encode/decode one scan record
+	//angle x64 degree and distance mm as zigzag varint delta,intensity as integer
+	class NVILIDAR_RECORD_API LidarRecordCodec
+	{
+		public:
+			//append one record(header + payload) to out
+			static bool Encode(const LidarScan &scan, const uint32_t *point_time_us, uint32_t flags, std::vector<uint8_t> &out);
+			//decode the record at data,size is all bytes of the record
+			static bool Decode(const uint8_t *data, size_t size, LidarScan &scan, std::vector<uint32_t> *point_time_us = NULL);
+			//check the header,size of the whole record,0 if it is wrong or not complete
+			static size_t RecordSize(const uint8_t *data, size_t avail);
+	};
+
+	//write scans to a file,one record buffer
+	class NVILIDAR_RECORD_API LidarRecordWriter
+	{
+		public:
+			LidarRecordWriter();
+			~LidarRecordWriter();
+
+			bool Open(std::string path, uint32_t flags = NVILIDAR_RECORD_FLAG_INTENSITY | NVILIDAR_RECORD_FLAG_COMPRESS);
+			bool Write(const LidarScan &scan, const uint32_t *point_time_us = NULL);	//point_time_us:point_count values if TIME flag
+			void Flush();
+			void Close();
+			bool IsOpen();
+			uint64_t GetBytes();			//bytes written
+
+		private:
+			FILE					*record_file;
+			uint32_t				record_flags;
+			uint64_t				record_bytes;
+			std::vector<uint8_t>	record_buffer;
+	};
+
+	//record in the mapping,no copy
+	typedef struct
+	{
+		const LidarRecordHeader	*header;		//stamp,point count,flags
+		const uint8_t			*data;			//whole record(header + payload)
+		size_t					size;
+		uint64_t				offset;			//in the file
+	}LidarRecordView;
+
+	//memory mapped record file with a timestamp index,random access
+	class NVILIDAR_RECORD_API LidarRecordFile
+	{
+		public:
+			LidarRecordFile();
+			~LidarRecordFile();
+
+			//map the file,load "<path>.idx" or build it from the record headers(and save it if save_index)
+			bool Open(std::string path, bool save_index = true);
+			void Close();
+
+			size_t Count();									//records
+			bool Get(size_t index, LidarRecordView &view);	//index in time order
+			size_t Seek(uint64_t stamp);					//first record not before stamp,Count() if none
+			uint64_t GetFirstStamp();
+			uint64_t GetLastStamp();
+			static bool Decode(const LidarRecordView &view, LidarScan &scan, std::vector<uint32_t> *point_time_us = NULL);
+
+		private:
+			bool LoadIndex(std::string path);
+			void BuildIndex();
+			bool SaveIndex(std::string path);
+
+			const uint8_t						*file_base;
+			size_t								file_size;
+		#if defined(_WIN32)
+			void								*file_handle;
+			void								*file_mapping;
+		#endif
+			std::vector<LidarRecordIndexEntry>	file_index;
+	};
+
+	//read scans from a file in order,one record buffer
+	class NVILIDAR_RECORD_API LidarRecordReader
+	{
+		public:
+			LidarRecordReader();
+			~LidarRecordReader();
+
+			bool Open(std::string path);
+			bool Read(LidarScan &scan, std::vector<uint32_t> *point_time_us = NULL);	//false at the end or a bad record
+			void Close();
+			uint32_t GetFlags();			//flags of the writer
+
+		private:
+			FILE					*record_file;
+			uint32_t				record_flags;
+			std::vector<uint8_t>	record_buffer;
+	};
+}
@@ -0,0 +1,291 @@
+#include "nvilidar_relay.h"
+#include "nvilidar_record.h"
+#include "nvilidar_trace.h"
+#include <string.h>
+#if defined(_WIN32)
+	#include <winsock2.h>
+	#include <Ws2tcpip.h>
+#else
+	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <sys/select.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+#endif
+
+namespace nvilidar
+{
+	static void RelayCloseSocket(intptr_t fd)
+	{
+	#if defined(_WIN32)
+		closesocket((SOCKET)fd);
+		WSACleanup();
+	#else
+		close((int)fd);
+	#endif
+	}
+
+	//udp socket,WSAStartup on windows
+	static intptr_t RelayOpenSocket()
+	{
+	#if defined(_WIN32)
+		WSADATA wsa_data;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+		{
+			return -1;
+		}
+		SOCKET fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (fd == INVALID_SOCKET)
+		{
+			WSACleanup();
+			return -1;
+		}
+		return (intptr_t)fd;
+	#else
+		return (intptr_t)socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+	#endif
+	}
+
+	//---------------------------publisher---------------------------
+	LidarRelay::LidarRelay()
+	{
+		relay_socket = -1;
+		relay_mode = NVILIDAR_RELAY_RAW;
+		memset(relay_addr, 0, sizeof(relay_addr));
+		memset(&relay_stats, 0, sizeof(relay_stats));
+	}
+
+	LidarRelay::~LidarRelay()
+	{
+		Close();
+	}
+
+	bool LidarRelay::Open(std::string group, uint16_t port, LidarRelayModeEnum mode, std::string iface, uint8_t ttl)
+	{
+		Close();
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(port);
+		addr.sin_addr.s_addr = inet_addr(group.c_str());
+		if (!IN_MULTICAST(ntohl(addr.sin_addr.s_addr)))
+		{
+			return false;
+		}
+
+		intptr_t fd = RelayOpenSocket();
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct in_addr local;
+		local.s_addr = inet_addr(iface.c_str());
+		int ttl_value = ttl;
+		int loop = 1;		//subscribers on this host
+		int sndbuf = NVILIDAR_RELAY_MAX_DATAGRAM * 4;
+		if ((setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, (const char*)&local, sizeof(local)) != 0) ||
+			(setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&ttl_value, sizeof(ttl_value)) != 0) ||
+			(setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, (const char*)&loop, sizeof(loop)) != 0))
+		{
+			RelayCloseSocket(fd);
+			return false;
+		}
+		setsockopt(fd, SOL_SOCKET, SO_SNDBUF, (const char*)&sndbuf, sizeof(sndbuf));
+
+		std::lock_guard<std::mutex> lock(relay_mutex);
+		memcpy(relay_addr, &addr, sizeof(addr));
+		relay_mode = mode;
+		relay_socket = fd;
+
+		return true;
+	}
+
+	void LidarRelay::Close()
+	{
+		std::lock_guard<std::mutex> lock(relay_mutex);
+		if (relay_socket >= 0)
+		{
+			RelayCloseSocket(relay_socket);
+			relay_socket = -1;
+		}
+	}
+
+	bool LidarRelay::IsOpen()
+	{
+		return (relay_socket >= 0);
+	}
+
+	LidarRelayModeEnum LidarRelay::GetMode()
+	{
+		return relay_mode;
+	}
+
+	bool LidarRelay::Send(const uint8_t *data, size_t len)
+	{
+		if (relay_socket < 0)
+		{
+			return false;
+		}
+		if (len > NVILIDAR_RELAY_MAX_DATAGRAM)
+		{
+			relay_stats.oversize++;
+			return false;
+		}
+
+	#if defined(_WIN32)
+		int ret = sendto((SOCKET)relay_socket, (const char *)data, (int)len, 0, (const sockaddr*)relay_addr, sizeof(sockaddr_in));
+	#else
+		int ret = (int)sendto((int)relay_socket, (const char *)data, len, MSG_DONTWAIT, (const sockaddr*)relay_addr, sizeof(sockaddr_in));
+	#endif
+		if (ret != (int)len)
+		{
+			relay_stats.errors++;		//never block the reader,a full buffer drops it
+			return false;
+		}
+		relay_stats.datagrams++;
+		relay_stats.bytes += len;
+
+		return true;
+	}
+
+	bool LidarRelay::Publish(const uint8_t *data, size_t len)
+	{
+		NVILIDAR_TRACE_SCOPE("LidarRelay::Publish");
+		std::lock_guard<std::mutex> lock(relay_mutex);
+		return Send(data, len);
+	}
+
+	bool LidarRelay::PublishScan(const LidarScan &scan)
+	{
+		NVILIDAR_TRACE_SCOPE("LidarRelay::PublishScan");
+		std::lock_guard<std::mutex> lock(relay_mutex);
+		if (relay_socket < 0)
+		{
+			return false;
+		}
+
+		encode_buf.clear();
+		if (!LidarRecordCodec::Encode(scan, NULL, NVILIDAR_RECORD_FLAG_INTENSITY, encode_buf))
+		{
+			return false;
+		}
+		return Send(encode_buf.data(), encode_buf.size());
+	}
+
+	LidarRelayStats LidarRelay::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(relay_mutex);
+		return relay_stats;
+	}
+
+	//---------------------------subscriber---------------------------
+	LidarRelayReceiver::LidarRelayReceiver()
+	{
+		recv_socket = -1;
+	}
+
+	LidarRelayReceiver::~LidarRelayReceiver()
+	{
+		Close();
+	}
+
+	//many receivers on one host,the port is shared
+	bool LidarRelayReceiver::Open(std::string group, uint16_t port, std::string iface)
+	{
+		Close();
+
+		struct ip_mreq mreq;
+		mreq.imr_multiaddr.s_addr = inet_addr(group.c_str());
+		mreq.imr_interface.s_addr = inet_addr(iface.c_str());
+		if (!IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr)))
+		{
+			return false;
+		}
+
+		intptr_t fd = RelayOpenSocket();
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		int opt_state = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt_state, sizeof(opt_state));
+
+		struct sockaddr_in local;
+		memset(&local, 0, sizeof(local));
+		local.sin_family = AF_INET;
+		local.sin_port = htons(port);
+	#if defined(_WIN32)
+		local.sin_addr.s_addr = htonl(INADDR_ANY);
+	#else
+		local.sin_addr.s_addr = mreq.imr_multiaddr.s_addr;		//only this group
+	#endif
+		if ((bind(fd, (sockaddr*)&local, sizeof(local)) != 0) ||
+			(setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&mreq, sizeof(mreq)) != 0))
+		{
+			RelayCloseSocket(fd);
+			return false;
+		}
+
+		recv_buf.resize(NVILIDAR_RELAY_MAX_DATAGRAM);
+		recv_socket = fd;
+
+		return true;
+	}
+
+	void LidarRelayReceiver::Close()
+	{
+		if (recv_socket >= 0)
+		{
+			RelayCloseSocket(recv_socket);		//leave the group
+			recv_socket = -1;
+		}
+	}
+
+	bool LidarRelayReceiver::IsOpen()
+	{
+		return (recv_socket >= 0);
+	}
+
+	int LidarRelayReceiver::Read(uint8_t *buf, size_t len, uint32_t timeout_ms)
+	{
+		if (recv_socket < 0)
+		{
+			return -1;
+		}
+
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(recv_socket, &fds);
+		struct timeval tv;
+		tv.tv_sec = timeout_ms / 1000;
+		tv.tv_usec = (timeout_ms % 1000) * 1000;
+		int ret = select((int)recv_socket + 1, &fds, NULL, NULL, &tv);
+		if (ret <= 0)
+		{
+			return ret;
+		}
+
+	#if defined(_WIN32)
+		return recv((SOCKET)recv_socket, (char *)buf, (int)len, 0);
+	#else
+		return (int)recv((int)recv_socket, (char *)buf, len, 0);
+	#endif
+	}
+
+	bool LidarRelayReceiver::ReadScan(LidarScan &scan, uint32_t timeout_ms)
+	{
+		int len = Read(recv_buf.data(), recv_buf.size(), timeout_ms);
+		if (len <= 0)
+		{
+			return false;
+		}
+		if (LidarRecordCodec::RecordSize(recv_buf.data(), (size_t)len) != (size_t)len)
+		{
+			return false;		//not a whole record
+		}
+		return LidarRecordCodec::Decode(recv_buf.data(), (size_t)len, scan);
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_RELAY_API __declspec(dllexport)
+#else
+	#define NVILIDAR_RELAY_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_RELAY_GROUP			"239.255.76.1"		//default multicast group
+#define NVILIDAR_RELAY_IFACE			"127.0.0.1"			//default interface,this host only
+#define NVILIDAR_RELAY_MAX_DATAGRAM		65507				//max udp payload,a bigger scan is dropped
+
+namespace nvilidar
+{
+	//what is relayed
+	typedef enum
+	{
+		NVILIDAR_RELAY_RAW = 0,		//point packages with a good checksum,the lidar protocol bytes
+		NVILIDAR_RELAY_SCAN,		//scans given by LidarSamplingProcess,one LidarRecordCodec record per datagram
+	}LidarRelayModeEnum;
+
+	//statistics of the relay
+	typedef struct
+	{
+		uint64_t	datagrams;		//sent
+		uint64_t	bytes;
+		uint64_t	errors;			//sendto failed
+		uint64_t	oversize;		//more than NVILIDAR_RELAY_MAX_DATAGRAM,dropped
+	}LidarRelayStats;
+
+	//publish to a multicast group,every subscriber gets it from the kernel
+	class NVILIDAR_RELAY_API LidarRelay
+	{
+		public:
+			LidarRelay();
+			~LidarRelay();
+
+			//ttl 0:not out of this host
+			bool Open(std::string group, uint16_t port, LidarRelayModeEnum mode,
+						std::string iface = NVILIDAR_RELAY_IFACE, uint8_t ttl = 0);
+			void Close();
+			bool IsOpen();
+			LidarRelayModeEnum GetMode();
+
+			bool Publish(const uint8_t *data, size_t len);		//one datagram
+			bool PublishScan(const LidarScan &scan);			//encode and publish,for NVILIDAR_RELAY_SCAN
+			LidarRelayStats GetStats();
+
+		private:
+			bool Send(const uint8_t *data, size_t len);			//locked by the caller
+
+			std::mutex				relay_mutex;		//socket,the raw and scan are published in different threads
+			std::atomic<intptr_t>	relay_socket;		//-1:closed,written under the lock,IsOpen without it
+			uint8_t					relay_addr[16];		//sockaddr_in of the group
+			std::atomic<LidarRelayModeEnum>	relay_mode;
+			LidarRelayStats			relay_stats;
+			std::vector<uint8_t>	encode_buf;			//record of one scan
+	};
+
+	//join a multicast group and read the relayed datagrams,in another process
+	class NVILIDAR_RELAY_API LidarRelayReceiver
+	{
+		public:
+			LidarRelayReceiver();
+			~LidarRelayReceiver();
+
+			bool Open(std::string group, uint16_t port, std::string iface = NVILIDAR_RELAY_IFACE);
+			void Close();
+			bool IsOpen();
+
+			int Read(uint8_t *buf, size_t len, uint32_t timeout_ms);	//bytes of one datagram,0:timeout,-1:fail
+			bool ReadScan(LidarScan &scan, uint32_t timeout_ms);		//next scan record,false:timeout or a bad record
+
+		private:
+			intptr_t				recv_socket;		//-1:closed
+			std::vector<uint8_t>	recv_buf;			//one datagram
+	};
+}
@@ -0,0 +1,105 @@
+#include "nvilidar_rt.h"
+#include "myconsole.h"
+#include <string.h>
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+	#include <errno.h>
+	#include <sys/mman.h>
+#endif
+
+namespace nvilidar
+{
+	//touch the stack pages once,they are locked by MCL_FUTURE
+	static void LidarPrefaultStack()
+	{
+		volatile uint8_t stack[NVILIDAR_RT_STACK_PREFAULT];
+		for (size_t i = 0; i < sizeof(stack); i += 4096)
+		{
+			stack[i] = 0;
+		}
+	}
+
+	bool LidarApplyThreadPara(const LidarThreadPara &para)
+	{
+		bool ret = true;
+
+	#if defined(_WIN32)
+		if (para.cpu_mask != 0)
+		{
+			if (0 == SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)para.cpu_mask))
+			{
+				nvilidar::console.warning("set thread cpu mask 0x%llx failed", (unsigned long long)para.cpu_mask);
+				ret = false;
+			}
+		}
+		//no real time policy on windows,the highest priorities instead
+		if (para.policy != NVILIDAR_SCHED_OTHER)
+		{
+			int priority = (para.policy == NVILIDAR_SCHED_FIFO) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+			if (!SetThreadPriority(GetCurrentThread(), priority))
+			{
+				nvilidar::console.warning("set thread priority failed");
+				ret = false;
+			}
+		}
+		if (para.lock_memory)
+		{
+			LidarPrefaultStack();		//working set is not locked
+		}
+	#else
+		#if defined(__linux__)
+			if (para.cpu_mask != 0)
+			{
+				cpu_set_t cpus;
+				CPU_ZERO(&cpus);
+				for (int i = 0; (i < 64) && (i < CPU_SETSIZE); i++)
+				{
+					if (para.cpu_mask & (1ULL << i))
+					{
+						CPU_SET(i, &cpus);
+					}
+				}
+				int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+				if (err != 0)
+				{
+					nvilidar::console.warning("set thread cpu mask 0x%llx failed:%s", (unsigned long long)para.cpu_mask, strerror(err));
+					ret = false;
+				}
+			}
+		#endif
+
+		if (para.policy != NVILIDAR_SCHED_OTHER)
+		{
+			int policy = (para.policy == NVILIDAR_SCHED_FIFO) ? SCHED_FIFO : SCHED_RR;
+			int min = sched_get_priority_min(policy);
+			int max = sched_get_priority_max(policy);
+			struct sched_param sched;
+			memset(&sched, 0, sizeof(sched));
+			sched.sched_priority = (para.priority < min) ? min : ((para.priority > max) ? max : para.priority);
+			int err = pthread_setschedparam(pthread_self(), policy, &sched);
+			if (err != 0)
+			{
+				nvilidar::console.warning("set thread %s priority %d failed:%s", (policy == SCHED_FIFO) ? "SCHED_FIFO" : "SCHED_RR",
+											sched.sched_priority, strerror(err));
+				ret = false;
+			}
+		}
+
+		//the mapped buffers(circle buffer,read buffer) are faulted in by MCL_CURRENT
+		if (para.lock_memory)
+		{
+			if (0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+			{
+				nvilidar::console.warning("mlockall failed:%s", strerror(errno));
+				ret = false;
+			}
+			LidarPrefaultStack();
+		}
+	#endif
+
+		return ret;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#include <immintrin.h>
+#endif
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_RT_API __declspec(dllexport)
+#else
+	#define NVILIDAR_RT_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_RT_STACK_PREFAULT		(64 * 1024)		//stack bytes touched when the memory is locked
+#define NVILIDAR_RT_BUSY_POLL_US		50				//SO_BUSY_POLL of the udp socket in busy poll
+#define NVILIDAR_RT_BACKOFF_MIN_US		20				//first sleep of the backoff,doubled up to the max
+#define NVILIDAR_RT_BACKOFF_MAX_US		1000
+
+namespace nvilidar
+{
+	//scheduling policy of a thread
+	typedef enum
+	{
+		NVILIDAR_SCHED_OTHER = 0,		//default time sharing
+		NVILIDAR_SCHED_FIFO,			//real time,run until it blocks
+		NVILIDAR_SCHED_RR,				//real time,round robin with the same priority
+	}LidarSchedPolicyEnum;
+
+	//how the own reader thread waits for data
+	typedef enum
+	{
+		NVILIDAR_READ_BLOCKING = 0,		//read with timeout,1ms sleep after a read
+		NVILIDAR_READ_BUSY_POLL,		//non-blocking read in a spin loop,one core per lidar
+	}LidarReadModeEnum;
+
+	//reader/pipeline thread para,all 0:default thread
+	typedef struct
+	{
+		uint64_t				cpu_mask;		//bit n:may run on cpu n,0:any cpu
+		LidarSchedPolicyEnum	policy;
+		int						priority;		//1~99 for FIFO/RR,cut to the range of the system
+		bool					lock_memory;	//mlockall(current and future) and prefault the stack,no page fault in the loop
+		LidarReadModeEnum		read_mode;		//own reader thread only,the hub waits in epoll/io_uring
+		uint32_t				backoff_us;		//busy poll:sleep(20us~1ms) after no data for this time,0:spin always
+	}LidarThreadPara;
+
+	//pause in a spin loop,the core runs the other hyper thread and saves power
+	inline void LidarCpuRelax()
+	{
+	#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+		_mm_pause();
+	#elif defined(__aarch64__) || defined(__arm__)
+		__asm__ __volatile__("yield");
+	#endif
+	}
+
+	//apply to the calling thread,in the thread function before the loop
+	//false if one of them fails(no CAP_SYS_NICE/rtprio limit,no such cpu),the others are still set
+	NVILIDAR_RT_API bool LidarApplyThreadPara(const LidarThreadPara &para);
+}
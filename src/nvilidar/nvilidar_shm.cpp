@@ -0,0 +1,445 @@
+#include "nvilidar_shm.h"
+#include <string.h>
+#include <limits.h>
+#include <new>
+#include "mytimer.h"
+#if !defined(_WIN32)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/types.h>
+	#include <signal.h>
+	#include <errno.h>
+	#if defined(__linux__)
+		#include <sys/syscall.h>
+		#include <linux/futex.h>
+	#endif
+#endif
+
+namespace nvilidar
+{
+	static size_t ShmAlign(size_t size)
+	{
+		return (size + NVILIDAR_SHM_ALIGN - 1) / NVILIDAR_SHM_ALIGN * NVILIDAR_SHM_ALIGN;
+	}
+
+#if defined(__linux__)
+	//shared futex,the word is in the shared memory
+	static void ShmFutexWait(std::atomic<uint32_t> *word, uint32_t value, uint32_t timeout_ms)
+	{
+		struct timespec timeout;
+		timeout.tv_sec = timeout_ms / 1000;
+		timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+		syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, &timeout, NULL, 0);
+	}
+
+	static void ShmFutexWake(std::atomic<uint32_t> *word)
+	{
+		syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+	}
+#endif
+
+#if !defined(_WIN32)
+	//writer of the ring with the name is running,no ring or a crashed writer:false
+	static bool ShmWriterAlive(const std::string &name)
+	{
+		int fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+		{
+			return (errno != ENOENT);		//no permission,not ours to remove
+		}
+		struct stat st;
+		if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(LidarShmHeader)))
+		{
+			close(fd);
+			return false;
+		}
+		void *base = mmap(NULL, sizeof(LidarShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (base == MAP_FAILED)
+		{
+			return false;
+		}
+		pid_t pid = (pid_t)((const LidarShmHeader *)base)->writer_pid;
+		munmap(base, sizeof(LidarShmHeader));
+
+		//EPERM:alive,another user
+		return (pid > 0) && ((kill(pid, 0) == 0) || (errno == EPERM));
+	}
+#endif
+
+	//==========================publisher=======================================
+	LidarShmPublisher::LidarShmPublisher()
+	{
+		shm_base = NULL;
+		shm_size = 0;
+		shm_header = NULL;
+		shm_ready = false;
+	}
+
+	LidarShmPublisher::~LidarShmPublisher()
+	{
+		Close();
+	}
+
+#if defined(_WIN32)
+	//posix shared memory is not supported
+	bool LidarShmPublisher::Create(std::string name, uint32_t slots, uint32_t max_points, uint32_t mode)
+	{
+		return false;
+	}
+
+	void LidarShmPublisher::Close()
+	{
+	}
+#else
+	//create the ring
+	bool LidarShmPublisher::Create(std::string name, uint32_t slots, uint32_t max_points, uint32_t mode)
+	{
+		Close();
+
+		std::lock_guard<std::mutex> lock(shm_mutex);
+
+		if ((slots == 0) || (max_points == 0) || (name.empty()))
+		{
+			return false;
+		}
+
+		size_t slot_size = ShmAlign(ShmAlign(sizeof(LidarShmSlot)) + (size_t)max_points * sizeof(NviLidarPoint));
+		size_t slot_offset = ShmAlign(sizeof(LidarShmHeader));
+		size_t size = slot_offset + slot_size * slots;
+
+		//the old one of a crashed process,a running writer keeps it
+		if (ShmWriterAlive(name))
+		{
+			return false;
+		}
+		shm_unlink(name.c_str());
+
+		int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, (mode_t)mode);
+		if (fd < 0)
+		{
+			return false;
+		}
+		fchmod(fd, (mode_t)mode);		//not limited by umask
+		if (ftruncate(fd, size) != 0)
+		{
+			close(fd);
+			shm_unlink(name.c_str());
+			return false;
+		}
+		void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (base == MAP_FAILED)
+		{
+			shm_unlink(name.c_str());
+			return false;
+		}
+
+		//the memory is zero after ftruncate
+		shm_base = (uint8_t *)base;
+		shm_size = size;
+		shm_name = name;
+		shm_header = new (shm_base) LidarShmHeader;
+		shm_header->version = NVILIDAR_SHM_VERSION;
+		shm_header->slot_count = slots;
+		shm_header->slot_points = max_points;
+		shm_header->slot_size = slot_size;
+		shm_header->slot_offset = slot_offset;
+		shm_header->point_size = sizeof(NviLidarPoint);
+		shm_header->writer_pid = (uint32_t)getpid();
+		shm_header->published.store(0, std::memory_order_relaxed);
+		shm_header->notify.store(0, std::memory_order_relaxed);
+		shm_header->waiters.store(0, std::memory_order_relaxed);
+		for (uint32_t i = 0; i < slots; i++)
+		{
+			LidarShmSlot *slot = new (shm_base + slot_offset + slot_size * i) LidarShmSlot;
+			slot->sequence.store(0, std::memory_order_relaxed);
+		}
+		shm_header->magic.store(NVILIDAR_SHM_MAGIC, std::memory_order_release);
+		shm_ready = true;
+
+		return true;
+	}
+
+	//unmap and remove,the readers keep the old memory until they close
+	void LidarShmPublisher::Close()
+	{
+		std::lock_guard<std::mutex> lock(shm_mutex);
+
+		if (shm_base == NULL)
+		{
+			return;
+		}
+		shm_ready = false;
+		munmap(shm_base, shm_size);
+		shm_unlink(shm_name.c_str());
+		shm_base = NULL;
+		shm_size = 0;
+		shm_header = NULL;
+	}
+#endif
+
+	bool LidarShmPublisher::IsOpen()
+	{
+		return shm_ready;
+	}
+
+	//write to the next slot,seqlock:odd sequence while writing
+	void LidarShmPublisher::Publish(const LidarScan &scan)
+	{
+		if (!shm_ready)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(shm_mutex);
+		if (shm_header == NULL)
+		{
+			return;
+		}
+
+		uint64_t index = shm_header->published.load(std::memory_order_relaxed) + 1;
+		LidarShmSlot *slot = (LidarShmSlot *)(shm_base + shm_header->slot_offset +
+								shm_header->slot_size * ((index - 1) % shm_header->slot_count));
+		NviLidarPoint *points = (NviLidarPoint *)((uint8_t *)slot + ShmAlign(sizeof(LidarShmSlot)));
+		uint32_t count = (scan.points.size() > shm_header->slot_points) ? shm_header->slot_points : (uint32_t)scan.points.size();
+		uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+
+		slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot->index = index;
+		slot->stamp = scan.stamp;
+		slot->config = scan.config;
+		slot->info = scan.info;
+		slot->latency = scan.latency;
+		slot->point_count = count;
+		slot->point_cut = (uint32_t)(scan.points.size() - count);
+		if (count > 0)
+		{
+			memcpy(points, scan.points.data(), count * sizeof(NviLidarPoint));
+		}
+
+		slot->sequence.store(sequence + 2, std::memory_order_release);
+		shm_header->published.store(index, std::memory_order_release);
+
+		//wake up the readers,no syscall if nobody waits 
+		//seq_cst:notify then waiters here,waiters then notify in Wait,one side always sees the other 
+		shm_header->notify.fetch_add(1, std::memory_order_seq_cst);
+	#if defined(__linux__)
+		if (shm_header->waiters.load(std::memory_order_seq_cst) > 0)
+		{
+			ShmFutexWake(&shm_header->notify);
+		}
+	#endif
+	}
+
+	//==========================reader=======================================
+	LidarShmReader::LidarShmReader()
+	{
+		shm_base = NULL;
+		shm_size = 0;
+		shm_header = NULL;
+	}
+
+	LidarShmReader::~LidarShmReader()
+	{
+		Close();
+	}
+
+#if defined(_WIN32)
+	bool LidarShmReader::Open(std::string name)
+	{
+		return false;
+	}
+
+	void LidarShmReader::Close()
+	{
+	}
+#else
+	//map the ring of the publisher
+	bool LidarShmReader::Open(std::string name)
+	{
+		Close();
+
+		int fd = shm_open(name.c_str(), O_RDWR, 0);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat st;
+		if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(LidarShmHeader)))
+		{
+			close(fd);
+			return false;
+		}
+		void *base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (base == MAP_FAILED)
+		{
+			return false;
+		}
+
+		//check the layout
+		LidarShmHeader *header = (LidarShmHeader *)base;
+		if ((header->magic.load(std::memory_order_acquire) != NVILIDAR_SHM_MAGIC) ||
+			(header->version != NVILIDAR_SHM_VERSION) ||
+			(header->point_size != sizeof(NviLidarPoint)) ||
+			(header->slot_count == 0) ||
+			(header->slot_offset + header->slot_size * header->slot_count > (uint64_t)st.st_size))
+		{
+			munmap(base, st.st_size);
+			return false;
+		}
+
+		shm_base = (uint8_t *)base;
+		shm_size = st.st_size;
+		shm_header = header;
+
+		return true;
+	}
+
+	void LidarShmReader::Close()
+	{
+		if (shm_base == NULL)
+		{
+			return;
+		}
+		munmap(shm_base, shm_size);
+		shm_base = NULL;
+		shm_size = 0;
+		shm_header = NULL;
+	}
+#endif
+
+	bool LidarShmReader::IsOpen()
+	{
+		return (shm_header != NULL);
+	}
+
+	uint32_t LidarShmReader::GetSlotCount()
+	{
+		return (shm_header != NULL) ? shm_header->slot_count : 0;
+	}
+
+	uint64_t LidarShmReader::Latest()
+	{
+		if (shm_header == NULL)
+		{
+			return 0;
+		}
+		return shm_header->published.load(std::memory_order_acquire);
+	}
+
+	//wait for a scan newer than index
+	bool LidarShmReader::Wait(uint64_t index, uint32_t timeout_ms)
+	{
+		if (shm_header == NULL)
+		{
+			return false;
+		}
+
+		uint64_t start = getMS();
+		while (true)
+		{
+			uint32_t notify = shm_header->notify.load(std::memory_order_acquire);
+			if (shm_header->published.load(std::memory_order_acquire) > index)
+			{
+				return true;
+			}
+
+			uint64_t passed = getMS() - start;
+			if (passed >= timeout_ms)
+			{
+				return false;
+			}
+
+		#if defined(__linux__)
+			//seq_cst,pairs with the notify/waiters of Publish(no lost wake up) 
+			shm_header->waiters.fetch_add(1, std::memory_order_seq_cst);
+			if (shm_header->notify.load(std::memory_order_seq_cst) == notify)
+			{
+				ShmFutexWait(&shm_header->notify, notify, (uint32_t)(timeout_ms - passed));
+			}
+			shm_header->waiters.fetch_sub(1, std::memory_order_acq_rel);
+		#else
+			(void)notify;
+			delayMS(1);
+		#endif
+		}
+	}
+
+	//slot of index,NULL if it is overwritten
+	const LidarShmSlot *LidarShmReader::GetSlot(uint64_t index)
+	{
+		if (shm_header == NULL)
+		{
+			return NULL;
+		}
+
+		uint64_t published = shm_header->published.load(std::memory_order_acquire);
+		if ((index == 0) || (index > published) || (published - index >= shm_header->slot_count))
+		{
+			return NULL;
+		}
+		return (const LidarShmSlot *)(shm_base + shm_header->slot_offset +
+						shm_header->slot_size * ((index - 1) % shm_header->slot_count));
+	}
+
+	//view of the scan in the shared memory
+	bool LidarShmReader::Get(uint64_t index, LidarShmScanView &view)
+	{
+		const LidarShmSlot *slot = GetSlot(index);
+		if (slot == NULL)
+		{
+			return false;
+		}
+
+		uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+		if ((sequence & 1) || (slot->index != index))
+		{
+			return false;
+		}
+
+		view.slot = slot;
+		view.points = (const NviLidarPoint *)((const uint8_t *)slot + ShmAlign(sizeof(LidarShmSlot)));
+		view.point_count = (slot->point_count > shm_header->slot_points) ? shm_header->slot_points : slot->point_count;
+		view.index = index;
+		view.sequence = sequence;
+
+		return true;
+	}
+
+	//the data read from the view is not changed by the publisher
+	bool LidarShmReader::Valid(const LidarShmScanView &view)
+	{
+		if (view.slot == NULL)
+		{
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return (view.slot->sequence.load(std::memory_order_relaxed) == view.sequence);
+	}
+
+	//copy out,false if it is overwritten
+	bool LidarShmReader::Read(uint64_t index, LidarScan &scan)
+	{
+		LidarShmScanView view;
+
+		if (!Get(index, view))
+		{
+			return false;
+		}
+
+		scan.stamp = view.slot->stamp;
+		scan.config = view.slot->config;
+		scan.info = view.slot->info;
+		scan.latency = view.slot->latency;
+		scan.points.assign(view.points, view.points + view.point_count);
+
+		return Valid(view);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "nvilidar_def.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <atomic>
+#include <mutex>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_SHM_API __declspec(dllexport)
+#else
+	#define NVILIDAR_SHM_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_SHM_NAME			"/nvilidar_scan"	//default shared memory name
+#define NVILIDAR_SHM_SLOTS			8					//scans kept in the ring(default)
+#define NVILIDAR_SHM_MAX_POINTS		16384				//points of one slot(default),more points are cut
+#define NVILIDAR_SHM_MAGIC			0x4E56534D			//'NVSM'
+#define NVILIDAR_SHM_VERSION		1
+#define NVILIDAR_SHM_ALIGN			64
+#define NVILIDAR_SHM_MODE			0660				//owner and group,the readers need write for the futex word
+
+namespace nvilidar
+{
+	//ring header,at the start of the shared memory
+	struct LidarShmHeader
+	{
+		std::atomic<uint32_t>	magic;			//set after the ring is ready
+		uint32_t				version;
+		uint32_t				slot_count;
+		uint32_t				slot_points;	//max points of one slot
+		uint64_t				slot_size;		//bytes of one slot
+		uint64_t				slot_offset;	//first slot from the start
+		uint32_t				point_size;		//sizeof(NviLidarPoint)
+		uint32_t				writer_pid;
+		std::atomic<uint64_t>	published;		//index of the last scan,from 1
+		std::atomic<uint32_t>	notify;			//futex word,changed for every scan
+		std::atomic<uint32_t>	waiters;		//readers in wait
+	};
+
+	//one scan,the points follow it
+	struct LidarShmSlot
+	{
+		std::atomic<uint64_t>	sequence;		//seqlock,odd when it is written
+		uint64_t				index;			//scan index
+		uint64_t				stamp;
+		NviLidarConfig			config;
+		NviLidarScanInfo		info;
+		NviLidarScanLatency		latency;
+		uint32_t				point_count;
+		uint32_t				point_cut;		//points not saved(more than slot_points)
+	};
+
+	//scan in the shared memory,valid until the slot is written again(check with LidarShmReader::Valid)
+	typedef struct
+	{
+		const LidarShmSlot		*slot;
+		const NviLidarPoint		*points;
+		uint32_t				point_count;
+		uint64_t				index;
+		uint64_t				sequence;		//slot sequence when it was taken
+	}LidarShmScanView;
+
+	//write every scan to a POSIX shared memory ring(linux)
+	class NVILIDAR_SHM_API LidarShmPublisher
+	{
+		public:
+			LidarShmPublisher();
+			~LidarShmPublisher();
+
+			bool Create(std::string name, uint32_t slots, uint32_t max_points,	//remove the old one of a dead writer,false if the writer is alive
+						uint32_t mode = NVILIDAR_SHM_MODE);
+			void Close();						//unmap and remove
+			bool IsOpen();
+			void Publish(const LidarScan &scan);	//called for every scan,no block for the readers
+
+		private:
+			std::mutex			shm_mutex;
+			std::string			shm_name;
+			uint8_t				*shm_base;
+			size_t				shm_size;
+			LidarShmHeader		*shm_header;
+			std::atomic<bool>	shm_ready;
+	};
+
+	//read the scans of a publisher in another process,no copy
+	class NVILIDAR_SHM_API LidarShmReader
+	{
+		public:
+			LidarShmReader();
+			~LidarShmReader();
+
+			bool Open(std::string name = NVILIDAR_SHM_NAME);	//false if the publisher is not started
+			void Close();
+			bool IsOpen();
+
+			uint64_t Latest();									//index of the last scan,0:none
+			bool Wait(uint64_t index, uint32_t timeout_ms);		//wait for a scan after index
+			bool Get(uint64_t index, LidarShmScanView &view);	//false if it is overwritten or in writing
+			bool Valid(const LidarShmScanView &view);			//the slot is not written since Get,check after use
+			bool Read(uint64_t index, LidarScan &scan);			//copy out
+
+			uint32_t GetSlotCount();
+
+		private:
+			const LidarShmSlot *GetSlot(uint64_t index);
+
+			uint8_t			*shm_base;
+			size_t			shm_size;
+			LidarShmHeader	*shm_header;
+	};
+}
@@ -0,0 +1,158 @@
+#include "nvilidar_trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <mutex>
+#include "mytimer.h"
+
+namespace nvilidar
+{
+	//one event
+	struct TraceEvent
+	{
+		const char	*name;			//string literal
+		uint64_t	ts;				//us
+		uint32_t	dur;			//us
+		uint8_t		phase;			//'X' or 'i'
+	};
+
+	//event buffer of one thread,only the owner thread write it
+	struct TraceBuffer
+	{
+		TraceEvent				events[NVILIDAR_TRACE_BUFFER_SIZE];
+		std::atomic<uint64_t>	head;
+		uint32_t				tid;
+		char					thread_name[32];
+	};
+
+	std::atomic<bool> LidarTrace::trace_enabled(false);
+
+	static std::mutex					trace_mutex;			//buffer list
+	static std::vector<TraceBuffer *>	trace_buffers;			//kept after the thread exit
+	static thread_local TraceBuffer		*trace_local = NULL;
+	static thread_local const char		*trace_local_name = NULL;
+
+	//buffer of current thread,create at first event
+	static TraceBuffer *TraceGetBuffer()
+	{
+		if (trace_local == NULL)
+		{
+			TraceBuffer *buffer = new TraceBuffer;
+
+			buffer->head.store(0, std::memory_order_relaxed);
+			memset(buffer->thread_name, 0x00, sizeof(buffer->thread_name));
+			if (trace_local_name != NULL)
+			{
+				strncpy(buffer->thread_name, trace_local_name, sizeof(buffer->thread_name) - 1);
+			}
+
+			std::lock_guard<std::mutex> lock(trace_mutex);
+			buffer->tid = (uint32_t)trace_buffers.size() + 1;
+			trace_buffers.push_back(buffer);
+			trace_local = buffer;
+		}
+		return trace_local;
+	}
+
+	//add event
+	static void TracePush(const char *name, uint64_t ts, uint32_t dur, uint8_t phase)
+	{
+		TraceBuffer *buffer = TraceGetBuffer();
+		uint64_t head = buffer->head.load(std::memory_order_relaxed);
+		TraceEvent &event = buffer->events[head & (NVILIDAR_TRACE_BUFFER_SIZE - 1)];
+
+		event.name = name;
+		event.ts = ts;
+		event.dur = dur;
+		event.phase = phase;
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	void LidarTrace::Start()
+	{
+		trace_enabled.store(true, std::memory_order_relaxed);
+	}
+
+	void LidarTrace::Stop()
+	{
+		trace_enabled.store(false, std::memory_order_relaxed);
+	}
+
+	void LidarTrace::Clear()
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		for (size_t i = 0; i < trace_buffers.size(); i++)
+		{
+			trace_buffers[i]->head.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	//chrome trace json
+	bool LidarTrace::Dump(std::string path)
+	{
+		FILE *fp = fopen(path.c_str(), "wb");
+		if (fp == NULL)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		bool first = true;
+
+		fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		for (size_t i = 0; i < trace_buffers.size(); i++)
+		{
+			TraceBuffer *buffer = trace_buffers[i];
+			uint64_t head = buffer->head.load(std::memory_order_acquire);
+			uint64_t start = (head > NVILIDAR_TRACE_BUFFER_SIZE) ? (head - NVILIDAR_TRACE_BUFFER_SIZE) : 0;
+
+			if (buffer->thread_name[0] != '\0')
+			{
+				fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+					first ? "" : ",\n", buffer->tid, buffer->thread_name);
+				first = false;
+			}
+			for (uint64_t j = start; j < head; j++)
+			{
+				const TraceEvent &event = buffer->events[j & (NVILIDAR_TRACE_BUFFER_SIZE - 1)];
+				if (event.phase == 'X')
+				{
+					fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"nvilidar\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%u}",
+						first ? "" : ",\n", event.name, (unsigned long long)event.ts, event.dur, buffer->tid);
+				}
+				else
+				{
+					fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"nvilidar\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+						first ? "" : ",\n", event.name, (unsigned long long)event.ts, buffer->tid);
+				}
+				first = false;
+			}
+		}
+		fprintf(fp, "\n]}\n");
+		fclose(fp);
+
+		return true;
+	}
+
+	void LidarTrace::Complete(const char *name, uint64_t begin_us, uint64_t end_us)
+	{
+		TracePush(name, begin_us, (uint32_t)(end_us - begin_us), 'X');
+	}
+
+	void LidarTrace::Instant(const char *name)
+	{
+		if (IsEnabled())
+		{
+			TracePush(name, getUS(), 0, 'i');
+		}
+	}
+
+	void LidarTrace::SetThreadName(const char *name)
+	{
+		trace_local_name = name;
+		if (trace_local != NULL)
+		{
+			strncpy(trace_local->thread_name, name, sizeof(trace_local->thread_name) - 1);
+		}
+	}
+}
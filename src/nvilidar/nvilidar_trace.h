@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <atomic>
+#include "mytimer.h"
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_TRACE_API __declspec(dllexport)
+#else
+	#define NVILIDAR_TRACE_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_TRACE_BUFFER_SIZE		65536		//events kept for every thread(power of 2),the old is overwritten
+
+//trace event,build with -DNVILIDAR_TRACE_ENABLE(cmake -DNVILIDAR_ENABLE_TRACE=ON),else it is compiled away
+#if defined(NVILIDAR_TRACE_ENABLE)
+	#define NVILIDAR_TRACE_CONCAT_(a, b)		a##b
+	#define NVILIDAR_TRACE_CONCAT(a, b)			NVILIDAR_TRACE_CONCAT_(a, b)
+	#define NVILIDAR_TRACE_SCOPE(name)			nvilidar::LidarTraceScope NVILIDAR_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+	#define NVILIDAR_TRACE_INSTANT(name)		nvilidar::LidarTrace::Instant(name)
+	#define NVILIDAR_TRACE_THREAD_NAME(name)	nvilidar::LidarTrace::SetThreadName(name)
+#else
+	#define NVILIDAR_TRACE_SCOPE(name)			((void)0)
+	#define NVILIDAR_TRACE_INSTANT(name)		((void)0)
+	#define NVILIDAR_TRACE_THREAD_NAME(name)	((void)0)
+#endif
+
+namespace nvilidar
+{
+	//trace control,events are written to a buffer of the thread without lock
+	class NVILIDAR_TRACE_API LidarTrace
+	{
+		public:
+			static void Start();						//record events
+			static void Stop();							//stop record
+			static void Clear();						//remove all events(call after stop)
+			static bool Dump(std::string path);		//write chrome trace json(chrome://tracing or perfetto)
+
+			static bool IsEnabled()
+			{
+				return trace_enabled.load(std::memory_order_relaxed);
+			}
+			static void Complete(const char *name, uint64_t begin_us, uint64_t end_us);	//scope event
+			static void Instant(const char *name);		//instant event
+			static void SetThreadName(const char *name);	//name of current thread in the trace
+
+		private:
+			static std::atomic<bool>	trace_enabled;
+	};
+
+	//scope event,from create to destroy.only a flag check when trace is stopped
+	class LidarTraceScope
+	{
+		public:
+			explicit LidarTraceScope(const char *name)
+			{
+				scope_name = name;
+				scope_begin = LidarTrace::IsEnabled() ? getUS() : 0;
+			}
+			~LidarTraceScope()
+			{
+				if (scope_begin != 0)
+				{
+					LidarTrace::Complete(scope_name, scope_begin, getUS());
+				}
+			}
+
+		private:
+			const char	*scope_name;
+			uint64_t	scope_begin;		//0:not record
+	};
+}
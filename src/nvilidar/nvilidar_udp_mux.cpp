@@ -0,0 +1,294 @@
+#include "nvilidar_udp_mux.h"
+#include "nvilidar_trace.h"
+#include <string.h>
+#if defined(_WIN32)
+	#include <winsock2.h>
+	#include <Ws2tcpip.h>
+#else
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+#endif
+
+namespace nvilidar
+{
+	LidarUdpMux::LidarUdpMux()
+	{
+		mux_socket = -1;
+		mux_hub = NULL;
+		mux_hub_id = -1;
+		memset(&mux_stats, 0, sizeof(mux_stats));
+	}
+
+	LidarUdpMux::~LidarUdpMux()
+	{
+		Close();
+	}
+
+	uint64_t LidarUdpMux::Key(uint32_t addr, uint16_t port)
+	{
+		return ((uint64_t)addr << 16) | port;
+	}
+
+	//bind INADDR_ANY:port,non-blocking,read in the hub thread
+	bool LidarUdpMux::Open(uint16_t port, LidarHub *hub)
+	{
+		Close();
+
+		if (hub == NULL)
+		{
+			return false;
+		}
+
+	#if defined(_WIN32)
+		WSADATA wsa_data;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+		{
+			return false;
+		}
+		SOCKET fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (fd == INVALID_SOCKET)
+		{
+			WSACleanup();
+			return false;
+		}
+	#else
+		int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+		if (fd < 0)
+		{
+			return false;
+		}
+	#endif
+
+		int opt_state = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt_state, sizeof(opt_state));
+		int rcvbuf = NVILIDAR_UDP_MUX_RCVBUF;
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, sizeof(rcvbuf));		//may be cut by the system limit
+
+		struct sockaddr_in local;
+		memset(&local, 0, sizeof(local));
+		local.sin_family = AF_INET;
+		local.sin_port = htons(port);
+		local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+	#if defined(_WIN32)
+		u_long nonblock = 1;
+		if ((SOCKET_ERROR == bind(fd, (sockaddr*)&local, sizeof(local))) || (ioctlsocket(fd, FIONBIO, &nonblock) != 0))
+		{
+			closesocket(fd);
+			WSACleanup();
+			return false;
+		}
+	#else
+		if ((bind(fd, (sockaddr*)&local, sizeof(local)) != 0) || (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0))
+		{
+			close(fd);
+			return false;
+		}
+	#endif
+
+		recv_buf.resize((size_t)NVILIDAR_UDP_MUX_BATCH * NVILIDAR_UDP_MUX_DATAGRAM);
+		mux_socket = (intptr_t)fd;
+
+		LidarHubSource source;
+		source.fd = [this]() {
+		#if defined(__linux__)
+			return (int)mux_socket;
+		#else
+			return -1;
+		#endif
+		};
+		source.read = [this]() { Read(); };
+		mux_hub_id = hub->Add(source);
+		if (mux_hub_id < 0)
+		{
+			Close();
+			return false;
+		}
+		mux_hub = hub;
+
+		return true;
+	}
+
+	void LidarUdpMux::Close()
+	{
+		if (mux_hub != NULL)
+		{
+			mux_hub->Remove(mux_hub_id);		//no Read after it
+			mux_hub = NULL;
+			mux_hub_id = -1;
+		}
+
+		if (mux_socket >= 0)
+		{
+		#if defined(_WIN32)
+			closesocket((SOCKET)mux_socket);
+			WSACleanup();
+		#else
+			close((int)mux_socket);
+		#endif
+			mux_socket = -1;
+		}
+	}
+
+	bool LidarUdpMux::IsOpen()
+	{
+		return (mux_socket >= 0);
+	}
+
+	LidarHub *LidarUdpMux::GetHub()
+	{
+		return mux_hub;
+	}
+
+	bool LidarUdpMux::Add(std::string ip, uint16_t port, std::function<void(const uint8_t*, size_t)> feed)
+	{
+		if (!feed)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(mux_mutex);
+		uint64_t key = Key(inet_addr(ip.c_str()), htons(port));
+		if (mux_sources.find(key) != mux_sources.end())
+		{
+			return false;
+		}
+		mux_sources[key] = feed;
+		mux_stats.sources = (uint32_t)mux_sources.size();
+
+		return true;
+	}
+
+	void LidarUdpMux::Remove(std::string ip, uint16_t port)
+	{
+		std::lock_guard<std::mutex> lock(mux_mutex);
+		mux_sources.erase(Key(inet_addr(ip.c_str()), htons(port)));
+		mux_stats.sources = (uint32_t)mux_sources.size();
+	}
+
+	//no lock,the socket is not changed while it is open
+	int LidarUdpMux::Send(std::string ip, uint16_t port, const uint8_t *data, size_t len)
+	{
+		if (mux_socket < 0)
+		{
+			return -1;
+		}
+
+		struct sockaddr_in remote;
+		memset(&remote, 0, sizeof(remote));
+		remote.sin_family = AF_INET;
+		remote.sin_port = htons(port);
+		remote.sin_addr.s_addr = inet_addr(ip.c_str());
+
+	#if defined(_WIN32)
+		return sendto((SOCKET)mux_socket, (const char *)data, (int)len, 0, (sockaddr*)&remote, sizeof(remote));
+	#else
+		return (int)sendto((int)mux_socket, (const char *)data, len, 0, (sockaddr*)&remote, sizeof(remote));
+	#endif
+	}
+
+	LidarUdpMuxStats LidarUdpMux::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(mux_mutex);
+		return mux_stats;
+	}
+
+	//read until the socket is empty,NVILIDAR_UDP_MUX_BATCH datagrams in one recvmmsg
+	void LidarUdpMux::Read()
+	{
+		NVILIDAR_TRACE_SCOPE("LidarUdpMux::Read");
+		if (mux_socket < 0)
+		{
+			return;
+		}
+
+		struct sockaddr_in from[NVILIDAR_UDP_MUX_BATCH];
+		int lens[NVILIDAR_UDP_MUX_BATCH];
+		bool truncated[NVILIDAR_UDP_MUX_BATCH];
+	#if defined(__linux__)
+		struct mmsghdr msgs[NVILIDAR_UDP_MUX_BATCH];
+		struct iovec iovs[NVILIDAR_UDP_MUX_BATCH];
+		memset(msgs, 0, sizeof(msgs));
+		for (int i = 0; i < NVILIDAR_UDP_MUX_BATCH; i++)
+		{
+			iovs[i].iov_base = recv_buf.data() + (size_t)i * NVILIDAR_UDP_MUX_DATAGRAM;
+			iovs[i].iov_len = NVILIDAR_UDP_MUX_DATAGRAM;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &from[i];
+		}
+	#endif
+
+		while (true)
+		{
+			int count = 0;
+		#if defined(__linux__)
+			for (int i = 0; i < NVILIDAR_UDP_MUX_BATCH; i++)
+			{
+				msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+				msgs[i].msg_hdr.msg_flags = 0;
+			}
+			count = recvmmsg((int)mux_socket, msgs, NVILIDAR_UDP_MUX_BATCH, MSG_DONTWAIT, NULL);
+			for (int i = 0; i < count; i++)
+			{
+				lens[i] = (int)msgs[i].msg_len;
+				truncated[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+			}
+		#else
+			for (; count < NVILIDAR_UDP_MUX_BATCH; count++)
+			{
+				char *buf = (char *)recv_buf.data() + (size_t)count * NVILIDAR_UDP_MUX_DATAGRAM;
+			#if defined(_WIN32)
+				int from_len = sizeof(from[count]);
+				int ret = recvfrom((SOCKET)mux_socket, buf, NVILIDAR_UDP_MUX_DATAGRAM, 0, (sockaddr*)&from[count], &from_len);
+			#else
+				socklen_t from_len = sizeof(from[count]);
+				int ret = (int)recvfrom((int)mux_socket, buf, NVILIDAR_UDP_MUX_DATAGRAM, 0, (sockaddr*)&from[count], &from_len);
+			#endif
+				if (ret < 0)
+				{
+					break;			//would block,or a datagram is too long(WSAEMSGSIZE)
+				}
+				lens[count] = ret;
+				truncated[count] = false;
+			}
+		#endif
+			if (count <= 0)
+			{
+				break;
+			}
+
+			std::lock_guard<std::mutex> lock(mux_mutex);
+			for (int i = 0; i < count; i++)
+			{
+				if (truncated[i])
+				{
+					mux_stats.truncated++;
+					continue;
+				}
+
+				std::unordered_map<uint64_t, std::function<void(const uint8_t*, size_t)> >::iterator it =
+					mux_sources.find(Key(from[i].sin_addr.s_addr, from[i].sin_port));
+				if (it == mux_sources.end())
+				{
+					mux_stats.unknown++;
+					continue;
+				}
+				mux_stats.datagrams++;
+				mux_stats.bytes += lens[i];
+				if (lens[i] > 0)
+				{
+					it->second(recv_buf.data() + (size_t)i * NVILIDAR_UDP_MUX_DATAGRAM, (size_t)lens[i]);
+				}
+			}
+
+			if (count < NVILIDAR_UDP_MUX_BATCH)
+			{
+				break;
+			}
+		}
+	}
+}
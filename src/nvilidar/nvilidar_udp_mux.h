@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include "nvilidar_hub.h"
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_UDP_MUX_API __declspec(dllexport)
+#else
+	#define NVILIDAR_UDP_MUX_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_UDP_MUX_BATCH			16					//datagrams of one read
+#define NVILIDAR_UDP_MUX_DATAGRAM		2048				//max bytes of one datagram
+#define NVILIDAR_UDP_MUX_RCVBUF			(4 * 1024 * 1024)	//socket receive buffer,for many lidars
+
+namespace nvilidar
+{
+	//statistics of the shared socket
+	typedef struct
+	{
+		uint32_t	sources;		//lidars added
+		uint64_t	datagrams;		//to a lidar
+		uint64_t	bytes;
+		uint64_t	unknown;		//from an address not added,dropped
+		uint64_t	truncated;		//more than NVILIDAR_UDP_MUX_DATAGRAM,dropped
+	}LidarUdpMuxStats;
+
+	//one udp socket for many lidars,the datagrams go to the lidar of the source ip:port
+	//the socket is read by the hub thread
+	class NVILIDAR_UDP_MUX_API LidarUdpMux
+	{
+		public:
+			LidarUdpMux();
+			~LidarUdpMux();
+
+			bool Open(uint16_t port, LidarHub *hub);	//bind the local port once
+			void Close();
+			bool IsOpen();
+			LidarHub *GetHub();		//hub of the socket,NULL:not open
+
+			bool Add(std::string ip, uint16_t port, std::function<void(const uint8_t*, size_t)> feed);	//datagrams from ip:port,false:already added
+			void Remove(std::string ip, uint16_t port);		//no feed of the lidar after return
+			int Send(std::string ip, uint16_t port, const uint8_t *data, size_t len);	//bytes sent,-1:fail
+			LidarUdpMuxStats GetStats();
+
+		private:
+			void Read();			//all the datagrams in the socket
+			static uint64_t Key(uint32_t addr, uint16_t port);		//network byte order
+
+			std::mutex			mux_mutex;				//sources,held in the feed
+			intptr_t			mux_socket;				//-1:closed
+			LidarHub			*mux_hub;
+			int					mux_hub_id;
+			std::unordered_map<uint64_t, std::function<void(const uint8_t*, size_t)> >	mux_sources;
+			LidarUdpMuxStats	mux_stats;
+			std::vector<uint8_t>	recv_buf;			//NVILIDAR_UDP_MUX_BATCH datagrams
+	};
+}
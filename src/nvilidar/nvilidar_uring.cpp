@@ -0,0 +1,424 @@
+#include "nvilidar_uring.h"
+#include <string.h>
+#if defined(__linux__)
+	#include <errno.h>
+	#include <signal.h>
+	#include <unistd.h>
+	#include <poll.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <linux/io_uring.h>
+#endif
+
+#define NVILIDAR_URING_BGID			1			//buffer group
+
+namespace nvilidar
+{
+	LidarUring::LidarUring()
+	{
+		ring_fd = -1;
+		sq_ring = NULL;
+		sq_ring_size = 0;
+		cq_ring = NULL;
+		cq_ring_size = 0;
+		sqes = NULL;
+		sqes_size = 0;
+		sq_pending = 0;
+		buf_ring = NULL;
+		buf_ring_size = 0;
+		buf_tail = 0;
+	}
+
+	LidarUring::~LidarUring()
+	{
+		Close();
+	}
+
+	bool LidarUring::IsOpen()
+	{
+		return (ring_fd >= 0);
+	}
+
+#if defined(__linux__)
+	static inline uint32_t LoadAcquire(uint32_t *p)
+	{
+		return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+	}
+
+	static inline void StoreRelease(uint32_t *p, uint32_t value)
+	{
+		__atomic_store_n(p, value, __ATOMIC_RELEASE);
+	}
+
+	//ring,sqes and the provided buffer ring
+	bool LidarUring::Open(uint32_t entries)
+	{
+		struct io_uring_params params;
+
+		Close();
+
+		memset(&params, 0, sizeof(params));
+		ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+		if (ring_fd < 0)
+		{
+			return false;		//no kernel support or not allowed(seccomp)
+		}
+		if (!(params.features & IORING_FEAT_EXT_ARG))
+		{
+			Close();			//no wait with timeout before 5.11
+			return false;
+		}
+
+		//rings
+		sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			sq_ring_size = (cq_ring_size > sq_ring_size) ? cq_ring_size : sq_ring_size;
+			cq_ring_size = sq_ring_size;
+		}
+		void *sq = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+		if (sq == MAP_FAILED)
+		{
+			sq_ring_size = 0;
+			Close();
+			return false;
+		}
+		sq_ring = (uint8_t *)sq;
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			cq_ring = sq_ring;
+		}
+		else
+		{
+			void *cq = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+			if (cq == MAP_FAILED)
+			{
+				cq_ring_size = 0;
+				Close();
+				return false;
+			}
+			cq_ring = (uint8_t *)cq;
+		}
+		sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+		void *sqe = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+		if (sqe == MAP_FAILED)
+		{
+			sqes_size = 0;
+			Close();
+			return false;
+		}
+		sqes = (struct io_uring_sqe *)sqe;
+
+		sq_head = (uint32_t *)(sq_ring + params.sq_off.head);
+		sq_tail = (uint32_t *)(sq_ring + params.sq_off.tail);
+		sq_mask = *(uint32_t *)(sq_ring + params.sq_off.ring_mask);
+		sq_array = (uint32_t *)(sq_ring + params.sq_off.array);
+		cq_head = (uint32_t *)(cq_ring + params.cq_off.head);
+		cq_tail = (uint32_t *)(cq_ring + params.cq_off.tail);
+		cq_mask = *(uint32_t *)(cq_ring + params.cq_off.ring_mask);
+		cqes = (struct io_uring_cqe *)(cq_ring + params.cq_off.cqes);
+
+		//provided buffers,the kernel picks one for every read
+		buffers.resize((size_t)NVILIDAR_URING_BUFFERS * NVILIDAR_URING_BUFFER_SIZE);
+		buf_ring_size = NVILIDAR_URING_BUFFERS * sizeof(struct io_uring_buf);
+		void *ring = mmap(NULL, buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ring == MAP_FAILED)
+		{
+			buf_ring_size = 0;
+			Close();
+			return false;
+		}
+		buf_ring = (uint8_t *)ring;
+
+		struct io_uring_buf_reg reg;
+		memset(&reg, 0, sizeof(reg));
+		reg.ring_addr = (uint64_t)(uintptr_t)buf_ring;
+		reg.ring_entries = NVILIDAR_URING_BUFFERS;
+		reg.bgid = NVILIDAR_URING_BGID;
+		if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+		{
+			Close();			//before 5.19
+			return false;
+		}
+
+		buf_tail = 0;
+		for (int32_t i = 0; i < NVILIDAR_URING_BUFFERS; i++)
+		{
+			LidarUringEvent event;
+			event.buffer = i;
+			Release(event);
+		}
+
+		return true;
+	}
+
+	void LidarUring::Close()
+	{
+		if (ring_fd >= 0)
+		{
+			close(ring_fd);			//requests in flight are cancelled
+			ring_fd = -1;
+		}
+		if (buf_ring != NULL)
+		{
+			munmap(buf_ring, buf_ring_size);
+			buf_ring = NULL;
+		}
+		if (sqes != NULL)
+		{
+			munmap(sqes, sqes_size);
+			sqes = NULL;
+		}
+		if ((cq_ring != NULL) && (cq_ring != sq_ring))
+		{
+			munmap(cq_ring, cq_ring_size);
+		}
+		cq_ring = NULL;
+		if (sq_ring != NULL)
+		{
+			munmap(sq_ring, sq_ring_size);
+			sq_ring = NULL;
+		}
+		sq_pending = 0;
+		buffers.clear();
+	}
+
+	struct io_uring_sqe *LidarUring::GetSqe()
+	{
+		if (ring_fd < 0)
+		{
+			return NULL;
+		}
+
+		uint32_t tail = *sq_tail;
+		if (tail - LoadAcquire(sq_head) > sq_mask)
+		{
+			return NULL;		//full,submitted in the next Wait
+		}
+
+		struct io_uring_sqe *sqe = &sqes[tail & sq_mask];
+		memset(sqe, 0, sizeof(*sqe));
+
+		return sqe;
+	}
+
+	//the sqe of GetSqe is filled,queue it
+	void LidarUring::PushSqe()
+	{
+		uint32_t tail = *sq_tail;
+		sq_array[tail & sq_mask] = tail & sq_mask;
+		StoreRelease(sq_tail, tail + 1);
+		sq_pending++;
+	}
+
+	//read one buffer,or a multishot recv that keeps posting buffers until it is cancelled
+	bool LidarUring::Read(int fd, uint64_t user_data, bool multishot)
+	{
+		struct io_uring_sqe *sqe = GetSqe();
+		if (sqe == NULL)
+		{
+			return false;
+		}
+
+		sqe->opcode = multishot ? IORING_OP_RECV : IORING_OP_READ;
+		sqe->fd = fd;
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->buf_group = NVILIDAR_URING_BGID;
+		if (multishot)
+		{
+			sqe->ioprio = IORING_RECV_MULTISHOT;
+		}
+		else
+		{
+			sqe->off = (uint64_t)-1;		//current position
+			sqe->len = NVILIDAR_URING_BUFFER_SIZE;
+		}
+		sqe->user_data = user_data;
+		PushSqe();
+
+		return true;
+	}
+
+	//for the fds that return 0 bytes at once(tty with VMIN=0),read by the caller
+	bool LidarUring::Poll(int fd, uint64_t user_data, bool multishot)
+	{
+		struct io_uring_sqe *sqe = GetSqe();
+		if (sqe == NULL)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_POLL_ADD;
+		sqe->fd = fd;
+		sqe->poll32_events = POLLIN;
+		sqe->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+		sqe->user_data = user_data;
+		PushSqe();
+
+		return true;
+	}
+
+	bool LidarUring::Cancel(uint64_t user_data, uint64_t cancel_user_data)
+	{
+		struct io_uring_sqe *sqe = GetSqe();
+		if (sqe == NULL)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_ASYNC_CANCEL;
+		sqe->fd = -1;
+		sqe->addr = user_data;
+		sqe->user_data = cancel_user_data;
+		PushSqe();
+
+		return true;
+	}
+
+	//submit the queued requests and wait,one syscall
+	bool LidarUring::Wait(uint32_t timeout_ms)
+	{
+		if (ring_fd < 0)
+		{
+			return false;
+		}
+
+		bool ready = (*cq_head != LoadAcquire(cq_tail));
+		if (ready && (sq_pending == 0))
+		{
+			return true;
+		}
+
+		uint32_t flags = IORING_ENTER_GETEVENTS;
+		uint32_t min_complete = ready ? 0 : 1;
+		struct io_uring_getevents_arg arg;
+		struct __kernel_timespec ts;
+		void *argp = NULL;
+		size_t argsz = 0;
+
+		if (timeout_ms == 0)
+		{
+			min_complete = 0;		//submit only
+		}
+		else if (min_complete > 0)
+		{
+			ts.tv_sec = timeout_ms / 1000;
+			ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+			memset(&arg, 0, sizeof(arg));
+			arg.sigmask_sz = _NSIG / 8;
+			arg.ts = (uint64_t)(uintptr_t)&ts;
+			argp = &arg;
+			argsz = sizeof(arg);
+			flags |= IORING_ENTER_EXT_ARG;
+		}
+
+		int ret = (int)syscall(__NR_io_uring_enter, ring_fd, sq_pending, min_complete, flags, argp, argsz);
+		if (ret >= 0)
+		{
+			sq_pending -= ((uint32_t)ret < sq_pending) ? (uint32_t)ret : sq_pending;
+		}
+		else if ((errno != ETIME) && (errno != EINTR) && (errno != EBUSY))
+		{
+			return false;
+		}
+
+		return (*cq_head != LoadAcquire(cq_tail));
+	}
+
+	bool LidarUring::Next(LidarUringEvent &event)
+	{
+		if (ring_fd < 0)
+		{
+			return false;
+		}
+
+		uint32_t head = *cq_head;
+		if (head == LoadAcquire(cq_tail))
+		{
+			return false;
+		}
+
+		struct io_uring_cqe *cqe = &cqes[head & cq_mask];
+		event.user_data = cqe->user_data;
+		event.res = cqe->res;
+		event.more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+		event.data = NULL;
+		event.buffer = -1;
+		if (cqe->flags & IORING_CQE_F_BUFFER)
+		{
+			event.buffer = (int32_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+			if (event.buffer < NVILIDAR_URING_BUFFERS)
+			{
+				event.data = buffers.data() + (size_t)event.buffer * NVILIDAR_URING_BUFFER_SIZE;
+			}
+			else
+			{
+				event.buffer = -1;
+			}
+		}
+		StoreRelease(cq_head, head + 1);
+
+		return true;
+	}
+
+	//post the buffer again,no syscall
+	void LidarUring::Release(const LidarUringEvent &event)
+	{
+		if ((buf_ring == NULL) || (event.buffer < 0))
+		{
+			return;
+		}
+
+		//not io_uring_buf_ring::bufs,the flex array of the header is at offset 8 in c++
+		//the tail is the resv field of the first buffer
+		struct io_uring_buf *ring = (struct io_uring_buf *)buf_ring;
+		struct io_uring_buf *buf = &ring[buf_tail & (NVILIDAR_URING_BUFFERS - 1)];
+		buf->addr = (uint64_t)(uintptr_t)(buffers.data() + (size_t)event.buffer * NVILIDAR_URING_BUFFER_SIZE);
+		buf->len = NVILIDAR_URING_BUFFER_SIZE;
+		buf->bid = (uint16_t)event.buffer;
+		buf_tail++;
+		__atomic_store_n(&ring[0].resv, buf_tail, __ATOMIC_RELEASE);
+	}
+#else
+	//io_uring is linux only
+	bool LidarUring::Open(uint32_t entries)
+	{
+		(void)entries;
+		return false;
+	}
+
+	void LidarUring::Close()
+	{
+	}
+
+	bool LidarUring::Read(int fd, uint64_t user_data, bool multishot)
+	{
+		return false;
+	}
+
+	bool LidarUring::Poll(int fd, uint64_t user_data, bool multishot)
+	{
+		return false;
+	}
+
+	bool LidarUring::Cancel(uint64_t user_data, uint64_t cancel_user_data)
+	{
+		return false;
+	}
+
+	bool LidarUring::Wait(uint32_t timeout_ms)
+	{
+		return false;
+	}
+
+	bool LidarUring::Next(LidarUringEvent &event)
+	{
+		return false;
+	}
+
+	void LidarUring::Release(const LidarUringEvent &event)
+	{
+	}
+#endif
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+//---visual studio include lib file
+#ifdef WIN32
+	#define NVILIDAR_URING_API __declspec(dllexport)
+#else
+	#define NVILIDAR_URING_API
+#endif // ifdef WIN32
+
+#define NVILIDAR_URING_ENTRIES			64			//submission queue size
+#define NVILIDAR_URING_BUFFERS			64			//receive buffers posted to the kernel(power of 2)
+#define NVILIDAR_URING_BUFFER_SIZE		4096		//bytes of one receive buffer
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace nvilidar
+{
+	//one completion,data is valid until Release
+	typedef struct
+	{
+		uint64_t		user_data;
+		int32_t			res;			//bytes or -errno
+		bool			more;			//multishot request is still armed
+		const uint8_t	*data;			//NULL:no buffer
+		int32_t			buffer;			//buffer id,-1:no buffer
+	}LidarUringEvent;
+
+	//io_uring with a provided buffer ring(linux 5.19+,raw syscalls,no liburing)
+	//used by one thread only
+	class NVILIDAR_URING_API LidarUring
+	{
+		public:
+			LidarUring();
+			~LidarUring();
+
+			bool Open(uint32_t entries = NVILIDAR_URING_ENTRIES);	//false if io_uring is not supported
+			void Close();
+			bool IsOpen();
+
+			bool Read(int fd, uint64_t user_data, bool multishot);	//read into a provided buffer,multishot:socket only
+			bool Poll(int fd, uint64_t user_data, bool multishot);	//readable event,no data
+			bool Cancel(uint64_t user_data, uint64_t cancel_user_data);
+			bool Wait(uint32_t timeout_ms);			//submit and wait for a completion,no syscall if one is ready
+			bool Next(LidarUringEvent &event);		//take a completion,no syscall
+			void Release(const LidarUringEvent &event);	//give the buffer back to the kernel
+
+		private:
+			struct io_uring_sqe *GetSqe();
+			void PushSqe();
+
+			int			ring_fd;
+			uint8_t		*sq_ring;
+			size_t		sq_ring_size;
+			uint8_t		*cq_ring;
+			size_t		cq_ring_size;
+			struct io_uring_sqe	*sqes;
+			size_t		sqes_size;
+			uint32_t	*sq_head;
+			uint32_t	*sq_tail;
+			uint32_t	sq_mask;
+			uint32_t	*sq_array;
+			uint32_t	sq_pending;				//queued,not submitted
+			uint32_t	*cq_head;
+			uint32_t	*cq_tail;
+			uint32_t	cq_mask;
+			struct io_uring_cqe	*cqes;
+
+			uint8_t		*buf_ring;				//struct io_uring_buf_ring
+			size_t		buf_ring_size;
+			uint16_t	buf_tail;
+			std::vector<uint8_t>	buffers;
+	};
+}